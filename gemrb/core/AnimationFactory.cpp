@@ -22,6 +22,7 @@
 
 #include "Interface.h"
 #include "Sprite2D.h"
+#include "System/DataStream.h"
 
 namespace GemRB {
 
@@ -30,6 +31,7 @@ AnimationFactory::AnimationFactory(const char* ResRef)
 {
 	FLTable = NULL;
 	FrameData = NULL;
+	FrameSource = NULL;
 }
 
 AnimationFactory::~AnimationFactory(void)
@@ -39,6 +41,7 @@ AnimationFactory::~AnimationFactory(void)
 
 	if (FrameData)
 		free( FrameData);
+	delete FrameSource;
 }
 
 void AnimationFactory::AddFrame(Holder<Sprite2D> frame)
@@ -46,12 +49,17 @@ void AnimationFactory::AddFrame(Holder<Sprite2D> frame)
 	frames.push_back( frame );
 }
 
+void AnimationFactory::PackFrames() const
+{
+	core->GetVideoDriver()->PackSprites(frames);
+}
+
 void AnimationFactory::AddCycle(CycleEntry cycle)
 {
 	cycles.push_back( cycle );
 }
 
-void AnimationFactory::LoadFLT(unsigned short* buffer, int count)
+void AnimationFactory::LoadFLT(const unsigned short* buffer, int count)
 {
 	if (FLTable) {
 		free( FLTable );
@@ -66,6 +74,12 @@ void AnimationFactory::SetFrameData(unsigned char* FrameData)
 	this->FrameData = FrameData;
 }
 
+void AnimationFactory::SetFrameSource(DataStream* source)
+{
+	delete FrameSource;
+	FrameSource = source;
+}
+
 
 Animation* AnimationFactory::GetCycle(unsigned char cycle)
 {
@@ -82,6 +96,27 @@ Animation* AnimationFactory::GetCycle(unsigned char cycle)
 	return anim;
 }
 
+size_t AnimationFactory::GetMemorySize() const
+{
+	size_t size = 0;
+	for (const Holder<Sprite2D>& frame : frames) {
+		if (frame) {
+			size += frame->Frame.w * frame->Frame.h * (frame->Bpp / 8);
+		}
+	}
+	return size;
+}
+
+bool AnimationFactory::InUse() const
+{
+	for (const Holder<Sprite2D>& frame : frames) {
+		if (frame && frame->GetRefCount() > 1) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /* returns the required frame of the named cycle, cycle defaults to 0 */
 Holder<Sprite2D> AnimationFactory::GetFrame(unsigned short index, unsigned char cycle) const
 {
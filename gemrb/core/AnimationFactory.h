@@ -30,20 +30,27 @@
 
 namespace GemRB {
 
+class DataStream;
+
 class GEM_EXPORT AnimationFactory : public FactoryObject {
 private:
 	std::vector<Holder<Sprite2D>> frames;
 	std::vector<CycleEntry> cycles;
 	unsigned short* FLTable;	// Frame Lookup Table
 	unsigned char* FrameData;
+	DataStream* FrameSource;
 
 public:
 	AnimationFactory(const char* ResRef);
 	~AnimationFactory(void) override;
 	void AddFrame(Holder<Sprite2D> frame);
+	/** Lets the video driver keep the frames together, call once all are added */
+	void PackFrames() const;
 	void AddCycle(CycleEntry cycle);
-	void LoadFLT(unsigned short* buffer, int count);
+	void LoadFLT(const unsigned short* buffer, int count);
 	void SetFrameData(unsigned char* FrameData);
+	/** The frames point into memory mapped from source, which we take over */
+	void SetFrameSource(DataStream* source);
 	Animation* GetCycle(unsigned char cycle);
 	/** No descriptions */
 	Holder<Sprite2D> GetFrame(unsigned short index, unsigned char cycle=0) const;
@@ -53,6 +60,9 @@ public:
 	int GetCycleSize(size_t idx) const;
 	Holder<Sprite2D> GetPaperdollImage(const ieDword *Colors, Holder<Sprite2D> &Picture2,
 		unsigned int type) const;
+	size_t GetMemorySize() const override;
+	/** The frames may point into FrameData, so they must not outlive us */
+	bool InUse() const override;
 
 };
 
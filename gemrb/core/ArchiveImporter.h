@@ -25,6 +25,9 @@
 
 #include "Plugin.h"
 
+#include <string>
+#include <vector>
+
 namespace GemRB {
 
 class GEM_EXPORT ArchiveImporter : public Plugin {
@@ -34,7 +37,8 @@ public:
 	virtual int CreateArchive(DataStream *stream) = 0;
 	//decompressing a .sav file similar to CBF
 	virtual int DecompressSaveGame(DataStream *compressed) = 0;
-	virtual int AddToSaveGame(DataStream *str, DataStream *uncompressed) = 0;
+	//compresses the listed files into the archive, keeping their order
+	virtual int AddToSaveGame(DataStream *str, const std::vector<std::string>& files, int level) = 0;
 };
 
 }
@@ -126,6 +126,8 @@ public:
 	virtual void QueueBuffer(int stream, unsigned short bits,
 				int channels, short* memory, int size, int samplerate) = 0;
 	virtual void UpdateMapAmbient(MapReverb&) {};
+	/** Hint that a sound will be played soon, drivers may decode it ahead */
+	virtual void Preload(const char* /*ResRef*/) {};
 
 	unsigned int CreateChannel(const char *name);
 	void SetChannelVolume(const char *name, int volume);
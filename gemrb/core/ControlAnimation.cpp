@@ -53,8 +53,6 @@ ControlAnimation::~ControlAnimation(void)
 {
 	//removing from timer first
 	core->timer.RemoveAnimation( this );
-
-	bam = NULL;
 }
 
 bool ControlAnimation::SameResource(const ieResRef ResRef, int Cycle)
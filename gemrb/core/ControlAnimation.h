@@ -25,6 +25,8 @@
 #include "exports.h"
 #include "globals.h"
 
+#include "Holder.h"
+
 #include <vector>
 
 namespace GemRB {
@@ -34,7 +36,7 @@ class Control;
 
 class GEM_EXPORT ControlAnimation {
 private:
-	AnimationFactory* bam;
+	Holder<AnimationFactory> bam;
 	Control* control;
 	unsigned int cycle;
 	unsigned int frame;
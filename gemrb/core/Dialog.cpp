@@ -21,6 +21,7 @@
 #include "Dialog.h"
 
 #include "GameScript/GameScript.h"
+#include "GameScript/GSUtils.h"
 #include "RNG.h"
 
 namespace GemRB {
@@ -46,7 +47,7 @@ Dialog::~Dialog(void)
 	if (Order) free(Order);
 }
 
-DialogState* Dialog::GetState(unsigned int index)
+DialogState* Dialog::GetState(unsigned int index) const
 {
 	if (index >= TopLevelCount) {
 		return NULL;
@@ -61,17 +62,17 @@ void Dialog::FreeDialogState(DialogState* ds)
 		for (size_t j = 0; j < trans->actions.size(); ++j)
 			trans->actions[j]->Release();
 		if (trans->condition)
-			delete trans->condition;
+			trans->condition->Release();
 		delete( trans );
 	}
 	free( ds->transitions );
 	if (ds->condition) {
-		delete ds->condition;
+		ds->condition->Release();
 	}
 	delete( ds );
 }
 
-int Dialog::FindFirstState(Scriptable* target)
+int Dialog::FindFirstState(Scriptable* target) const
 {
 	for (unsigned int i = 0; i < TopLevelCount; i++) {
 		const Condition *cond = GetState(Order[i])->condition;
@@ -82,7 +83,7 @@ int Dialog::FindFirstState(Scriptable* target)
 	return -1;
 }
 
-int Dialog::FindRandomState(Scriptable* target)
+int Dialog::FindRandomState(Scriptable* target) const
 {
 	unsigned int max = TopLevelCount;
 	if (!max) return -1;
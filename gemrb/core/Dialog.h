@@ -24,6 +24,8 @@
 #include "exports.h"
 #include "globals.h"
 
+#include "Holder.h"
+
 #include <vector>
 
 namespace GemRB {
@@ -64,7 +66,9 @@ struct DialogState {
 	unsigned int weight;
 };
 
-class GEM_EXPORT Dialog {
+// parsed dialogs are shared by every conversation using them, so they must
+// not be modified once loaded; queue copies of the transition actions
+class GEM_EXPORT Dialog : public Held<Dialog> {
 public:
 	Dialog(void);
 	~Dialog(void);
@@ -72,14 +76,10 @@ private:
 	void FreeDialogState(DialogState* ds);
 public:
 	void AddState(DialogState* ds);
-	DialogState* GetState(unsigned int index);
-	int FindFirstState(Scriptable* target);
-	int FindRandomState(Scriptable* target);
-
-	void Release()
-	{
-		delete this;
-	}
+	DialogState* GetState(unsigned int index) const;
+	int FindFirstState(Scriptable* target) const;
+	int FindRandomState(Scriptable* target) const;
+
 public:
 	ieResRef ResRef;
 	ieDword Flags; //freeze flags (bg2)
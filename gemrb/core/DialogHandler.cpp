@@ -21,7 +21,6 @@
 
 #include "strrefs.h"
 
-#include "DialogMgr.h"
 #include "DisplayMessage.h"
 #include "Game.h"
 #include "GameData.h"
@@ -48,7 +47,6 @@ static const int noSections[4] = {0,0,0,0};
 
 DialogHandler::DialogHandler(void)
 {
-	dlg = NULL;
 	ds = NULL;
 	targetID = 0;
 	originalTargetID = 0;
@@ -63,7 +61,6 @@ DialogHandler::DialogHandler(void)
 
 DialogHandler::~DialogHandler(void)
 {
-	delete dlg;
 }
 
 void DialogHandler::UpdateJournalForTransition(DialogTransition* tr)
@@ -106,24 +103,19 @@ void DialogHandler::UpdateJournalForTransition(DialogTransition* tr)
 //Try to start dialogue between two actors (one of them could be inanimate)
 bool DialogHandler::InitDialog(Scriptable* spk, Scriptable* tgt, const char* dlgref, ieDword si)
 {
-	delete dlg;
-	dlg = NULL;
+	dlg = nullptr;
 
 	if (!dlgref || dlgref[0] == '\0' || dlgref[0] == '*') {
 		return false;
 	}
 
-	PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
-	dm->Open(gamedata->GetResource(dlgref, IE_DLG_CLASS_ID));
-	dlg = dm->GetDialog();
+	dlg = gamedata->GetDialog(dlgref);
 
 	if (!dlg) {
 		Log(ERROR, "DialogHandler", "Cannot start dialog (%s): %s with %s", dlgref, spk->GetName(1), tgt->GetName(1));
 		return false;
 	}
 
-	strnlwrcpy(dlg->ResRef, dlgref, 8); //this isn't handled by GetDialog???
-
 	//target is here because it could be changed when a dialog runs onto
 	//and external link, we need to find the new target (whose dialog was
 	//linked to)
@@ -163,7 +155,7 @@ bool DialogHandler::InitDialog(Scriptable* spk, Scriptable* tgt, const char* dlg
 		}
 	}
 	if (initialState < 0) {
-		Log(DEBUG, "DialogHandler", "Could not find a proper state");
+		LogDebug("DialogHandler", "Could not find a proper state");
 		return false;
 	}
 
@@ -188,7 +180,7 @@ bool DialogHandler::InitDialog(Scriptable* spk, Scriptable* tgt, const char* dlg
 /*try to break will only try to break it, false means unconditional stop*/
 void DialogHandler::EndDialog(bool try_to_break)
 {
-	if (dlg == NULL) {
+	if (!dlg) {
 		return; // no dialog, nothing to do.
 	}
 
@@ -219,8 +211,7 @@ void DialogHandler::EndDialog(bool try_to_break)
 		tmp->SetCircleSize();
 	}
 	ds = NULL;
-	delete dlg;
-	dlg = NULL;
+	dlg = nullptr;
 
 	core->ToggleViewsEnabled(true, "NOT_DLG");
 	// FIXME: it's not so nice having this here, but things call EndDialog directly :(
@@ -317,9 +308,11 @@ bool DialogHandler::DialogChoose(unsigned int choose)
 			if (!core->HasFeature(GF_AREA_OVERRIDE) && !(tr->Flags & IE_DLG_IMMEDIATE)) {
 				target->AddAction(GenerateAction("BreakInstants()"));
 			}
+			// the dialog is shared, so queue copies the action queue can modify
 			for (unsigned int i = 0; i < tr->actions.size(); i++) {
-				if (i == tr->actions.size() - 1) tr->actions[i]->flags |= ACF_REALLOW_SCRIPTS;
-				target->AddAction(tr->actions[i]);
+				Action *action = ParamCopy(tr->actions[i]);
+				if (i == tr->actions.size() - 1) action->flags |= ACF_REALLOW_SCRIPTS;
+				target->AddAction(action);
 			}
 			target->AddAction( GenerateAction( "SetInterrupt(TRUE)" ) );
 		}
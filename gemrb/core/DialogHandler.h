@@ -53,7 +53,7 @@ private:
 	void UpdateJournalForTransition(DialogTransition *tr);
 
 	DialogState* ds;
-	Dialog* dlg;
+	Holder<Dialog> dlg;
 
 	ieDword speakerID;
 	ieDword targetID;
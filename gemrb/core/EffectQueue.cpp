@@ -516,6 +516,52 @@ void EffectQueue::ApplyAllEffects(Actor* target) const
 	}
 }
 
+// effects that only modify stats can be skipped until one of them expires or triggers
+ieDword EffectQueue::GetStableUntil() const
+{
+	ieDword until = 0xffffffff;
+	for (const Effect *fx : effects) {
+		if (fx->TimingMode == FX_DURATION_JUST_EXPIRED) {
+			continue;
+		}
+		if (fx->Opcode >= MAX_EFFECTS) {
+			return 0;
+		}
+		int flags = Opcodes[fx->Opcode].Flags;
+		if (!(flags & EFFECT_STATIC) || (flags & EFFECT_REINIT_ON_LOAD)) {
+			return 0;
+		}
+		int delay = DelayType(fx->TimingMode & 0xff);
+		if (delay == INVALID) {
+			return 0;
+		}
+		// delayed effects trigger and limited ones expire at their Duration
+		if (delay != PERMANENT && fx->Duration < until) {
+			until = fx->Duration;
+		}
+	}
+	return until;
+}
+
+ieDword EffectQueue::GetFingerprint() const
+{
+	// FNV-1a over the fields that influence reapplication
+	ieDword hash = 2166136261u;
+	auto mix = [&hash](ieDword value) {
+		hash = (hash ^ value) * 16777619u;
+	};
+	for (const Effect *fx : effects) {
+		mix((ieDword) (uintptr_t) fx);
+		mix(fx->Opcode);
+		mix(fx->TimingMode);
+		mix(fx->Duration);
+		mix(fx->Parameter1);
+		mix(fx->Parameter2);
+		mix(fx->Parameter3);
+	}
+	return hash;
+}
+
 void EffectQueue::Cleanup()
 {
 	std::list< Effect* >::iterator f;
@@ -868,7 +914,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if(fx->Power && actor->fxqueue.HasEffectWithParamPair(fx_level_immunity_ref, fx->Power, 0) ) {
 		const Actor *caster = core->GetGame()->GetActorByGlobalID(fx->CasterID);
 		if (caster != actor || (fx->SourceFlags & SF_HOSTILE)) {
-			Log(DEBUG, "EffectQueue", "Resisted by level immunity");
+			LogDebug("EffectQueue", "Resisted by level immunity");
 			return 0;
 		}
 	}
@@ -877,12 +923,12 @@ static int check_type(const Actor *actor, const Effect *fx)
 	//if source is unspecified, don't resist it
 	if( fx->Source[0]) {
 		if( actor->fxqueue.HasEffectWithResource(fx_spell_immunity_ref, fx->Source) ) {
-			Log(DEBUG, "EffectQueue", "Resisted by spell immunity (%s)", fx->Source);
+			LogDebug("EffectQueue", "Resisted by spell immunity (%s)", fx->Source);
 			return 0;
 		}
 		if( actor->fxqueue.HasEffectWithResource(fx_spell_immunity2_ref, fx->Source) ) {
 			if (strnicmp(fx->Source, "detect", 6)) { // our secret door pervasive effect
-				Log(DEBUG, "EffectQueue", "Resisted by spell immunity2 (%s)", fx->Source);
+				LogDebug("EffectQueue", "Resisted by spell immunity2 (%s)", fx->Source);
 			}
 			return 0;
 		}
@@ -891,7 +937,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	//primary type immunity (school)
 	if( fx->PrimaryType) {
 		if( actor->fxqueue.HasEffectWithParam(fx_school_immunity_ref, fx->PrimaryType)) {
-			Log(DEBUG, "EffectQueue", "Resisted by school/primary type");
+			LogDebug("EffectQueue", "Resisted by school/primary type");
 			return 0;
 		}
 	}
@@ -899,7 +945,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	//secondary type immunity (usage)
 	if( fx->SecondaryType) {
 		if( actor->fxqueue.HasEffectWithParam(fx_secondary_type_immunity_ref, fx->SecondaryType) ) {
-			Log(DEBUG, "EffectQueue", "Resisted by usage/secondary type");
+			LogDebug("EffectQueue", "Resisted by usage/secondary type");
 			return 0;
 		}
 	}
@@ -909,7 +955,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if (fx->Power) {
 		efx = actor->fxqueue.HasEffectWithParam(fx_level_immunity_dec_ref, fx->Power);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Resisted by level immunity (decrementing)");
+			LogDebug("EffectQueue", "Resisted by level immunity (decrementing)");
 			return 0;
 		}
 	}
@@ -918,7 +964,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if( fx->Source[0]) {
 		efx = actor->fxqueue.HasEffectWithResource(fx_spell_immunity_dec_ref, fx->Source);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Resisted by spell immunity (decrementing)");
+			LogDebug("EffectQueue", "Resisted by spell immunity (decrementing)");
 			return 0;
 		}
 	}
@@ -926,7 +972,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if( fx->PrimaryType) {
 		efx = actor->fxqueue.HasEffectWithParam(fx_school_immunity_dec_ref, fx->PrimaryType);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Resisted by school immunity (decrementing)");
+			LogDebug("EffectQueue", "Resisted by school immunity (decrementing)");
 			return 0;
 		}
 	}
@@ -935,7 +981,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if( fx->SecondaryType) {
 		efx = actor->fxqueue.HasEffectWithParam(fx_secondary_type_immunity_dec_ref, fx->SecondaryType);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Resisted by usage/sectype immunity (decrementing)");
+			LogDebug("EffectQueue", "Resisted by usage/sectype immunity (decrementing)");
 			return 0;
 		}
 	}
@@ -955,7 +1001,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 			//if decrease needs the spell level, use fx->Power here
 			actor->fxqueue.DecreaseParam1OfEffect(fx_spelltrap, 1);
 			//efx->Parameter1--;
-			Log(DEBUG, "EffectQueue", "Absorbed by spelltrap");
+			LogDebug("EffectQueue", "Absorbed by spelltrap");
 			return 0;
 		}
 	}
@@ -963,31 +1009,31 @@ static int check_type(const Actor *actor, const Effect *fx)
 	//bounce checks
 	if (fx->Power) {
 		if( (bounce&BNC_LEVEL) && actor->fxqueue.HasEffectWithParamPair(fx_level_bounce_ref, 0, fx->Power) ) {
-			Log(DEBUG, "EffectQueue", "Bounced by level");
+			LogDebug("EffectQueue", "Bounced by level");
 			return -1;
 		}
 	}
 
 	if((bounce&BNC_PROJECTILE) && actor->fxqueue.HasEffectWithParam(fx_projectile_bounce_ref, fx->Projectile)) {
-		Log(DEBUG, "EffectQueue", "Bounced by projectile");
+		LogDebug("EffectQueue", "Bounced by projectile");
 		return -1;
 	}
 
 	if( fx->Source[0] && (bounce&BNC_RESOURCE) && actor->fxqueue.HasEffectWithResource(fx_spell_bounce_ref, fx->Source) ) {
-		Log(DEBUG, "EffectQueue", "Bounced by resource");
+		LogDebug("EffectQueue", "Bounced by resource");
 		return -1;
 	}
 
 	if( fx->PrimaryType && (bounce&BNC_SCHOOL) ) {
 		if( actor->fxqueue.HasEffectWithParam(fx_school_bounce_ref, fx->PrimaryType)) {
-			Log(DEBUG, "EffectQueue", "Bounced by school");
+			LogDebug("EffectQueue", "Bounced by school");
 			return -1;
 		}
 	}
 
 	if( fx->SecondaryType && (bounce&BNC_SECTYPE) ) {
 		if( actor->fxqueue.HasEffectWithParam(fx_secondary_type_bounce_ref, fx->SecondaryType)) {
-			Log(DEBUG, "EffectQueue", "Bounced by usage/sectype");
+			LogDebug("EffectQueue", "Bounced by usage/sectype");
 			return -1;
 		}
 	}
@@ -998,7 +1044,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 		if (bounce & BNC_LEVEL_DEC) {
 			efx=actor->fxqueue.HasEffectWithParamPair(fx_level_bounce_dec_ref, 0, fx->Power);
 			if (efx && DecreaseEffect(efx)) {
-				Log(DEBUG, "EffectQueue", "Bounced by level (decrementing)");
+				LogDebug("EffectQueue", "Bounced by level (decrementing)");
 				return -1;
 			}
 		}
@@ -1007,7 +1053,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if( fx->Source[0] && (bounce&BNC_RESOURCE_DEC)) {
 		efx=actor->fxqueue.HasEffectWithResource(fx_spell_bounce_dec_ref, fx->Resource);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Bounced by resource (decrementing)");
+			LogDebug("EffectQueue", "Bounced by resource (decrementing)");
 			return -1;
 		}
 	}
@@ -1015,7 +1061,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if( fx->PrimaryType && (bounce&BNC_SCHOOL_DEC) ) {
 		efx=actor->fxqueue.HasEffectWithParam(fx_school_bounce_dec_ref, fx->PrimaryType);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Bounced by school (decrementing)");
+			LogDebug("EffectQueue", "Bounced by school (decrementing)");
 			return -1;
 		}
 	}
@@ -1023,7 +1069,7 @@ static int check_type(const Actor *actor, const Effect *fx)
 	if( fx->SecondaryType && (bounce&BNC_SECTYPE_DEC) ) {
 		efx=actor->fxqueue.HasEffectWithParam(fx_secondary_type_bounce_dec_ref, fx->SecondaryType);
 		if (efx && DecreaseEffect(efx)) {
-			Log(DEBUG, "EffectQueue", "Bounced by usage (decrementing)");
+			LogDebug("EffectQueue", "Bounced by usage (decrementing)");
 			return -1;
 		}
 	}
@@ -1440,7 +1486,7 @@ void EffectQueue::RemoveAllEffects(const ieResRef Removed) const
 
 		fx->Parameter1 = -fx->Parameter1;
 
-		Log(DEBUG, "EffectQueue", "Manually removing effect %d (from %s)", fx->Opcode, Removed);
+		LogDebug("EffectQueue", "Manually removing effect %d (from %s)", fx->Opcode, Removed);
 		ApplyEffect((Actor *)Owner, fx, 1, 0);
 		delete fx;
 	}
@@ -193,7 +193,8 @@ enum EffectFlags {
 	EFFECT_NO_ACTOR = 4,
 	EFFECT_REINIT_ON_LOAD = 8,
 	EFFECT_PRESET_TARGET = 16,
-	EFFECT_SPECIAL_UNDO = 32
+	EFFECT_SPECIAL_UNDO = 32,
+	EFFECT_STATIC = 64 // only modifies stats, so reapplying it gives the same result every tick
 };
 
 /** Initializes table of available spell Effects used by all the queues. */
@@ -292,6 +293,10 @@ public:
 	/* returns the number of saved effects */
 	ieDword GetSavedEffectsCount() const;
 	size_t GetEffectsCount() const { return effects.size(); }
+	/* returns the game time until which reapplying the queue yields the same stats (0 if never) */
+	ieDword GetStableUntil() const;
+	/* cheap digest of the queue contents, used to notice changes between refreshes */
+	ieDword GetFingerprint() const;
 	unsigned int GetEffectOrder(EffectRef &effect_reference, const Effect *fx) const;
 	/* this method hacks the offhand weapon color effects */
 	static void HackColorEffects(const Actor *Owner, Effect *fx);
@@ -20,50 +20,86 @@
 
 #include "Factory.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace GemRB {
 
 Factory::Factory(void)
 {
+	budget = 128 * 1024 * 1024;
 }
 
 Factory::~Factory(void)
 {
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		delete( fobjects[i] );
-	}
 }
 
 void Factory::AddFactoryObject(FactoryObject* fobject)
 {
-	fobjects.push_back( fobject );
+	Key key { fobject->ResRef, fobject->SuperClassID };
+	Entry& entry = fobjects[key];
+	if (entry.object) {
+		stats.residentBytes -= entry.bytes;
+	}
+	entry.object = fobject;
+	entry.bytes = fobject->GetMemorySize();
+	entry.lastUse = ++uses;
+	stats.residentBytes += entry.bytes;
+	grown = true;
 }
 
-int Factory::IsLoaded(const char* ResRef, SClass_ID type) const
+FactoryObject* Factory::GetFactoryObject(const char* ResRef, SClass_ID type)
 {
 	if (ResRef == nullptr) {
-		return -1;
+		return nullptr;
 	}
 
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		if (fobjects[i]->SuperClassID == type) {
-			if (strnicmp( fobjects[i]->ResRef, ResRef, 8 ) == 0) {
-				return i;
-			}
-		}
+	auto it = fobjects.find(Key { ResRef, type });
+	if (it == fobjects.end()) {
+		stats.misses++;
+		return nullptr;
 	}
-	return -1;
+	stats.hits++;
+	it->second.lastUse = ++uses;
+	return it->second.object.get();
 }
 
-FactoryObject* Factory::GetFactoryObject(int pos) const
+void Factory::Trim()
 {
-	return fobjects[pos];
+	if (!grown || stats.residentBytes <= budget) {
+		return;
+	}
+	grown = false;
+
+	// only the ones solely owned by us can go
+	std::vector<std::pair<unsigned long, Key>> candidates;
+	for (const auto& it : fobjects) {
+		const Entry& entry = it.second;
+		if (entry.object->GetRefCount() > 1 || entry.object->InUse()) {
+			continue;
+		}
+		candidates.emplace_back(entry.lastUse, it.first);
+	}
+	std::sort(candidates.begin(), candidates.end(),
+		[](const std::pair<unsigned long, Key>& a, const std::pair<unsigned long, Key>& b) {
+			return a.first < b.first;
+		});
+
+	for (const auto& candidate : candidates) {
+		if (stats.residentBytes <= budget) {
+			break;
+		}
+		auto it = fobjects.find(candidate.second);
+		stats.residentBytes -= it->second.bytes;
+		stats.evictions++;
+		fobjects.erase(it);
+	}
 }
 
 void Factory::FreeObjects(void)
 {
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		delete( fobjects[i] );
-	}
+	fobjects.clear();
+	stats.residentBytes = 0;
 }
 
 }
@@ -26,18 +26,67 @@
 
 #include "AnimationFactory.h"
 #include "FactoryObject.h"
+#include "Resource.h"
+
+#include <unordered_map>
 
 namespace GemRB {
 
+/**
+ * @class Factory
+ * Cache of loaded factory objects. Entries nobody else holds (either
+ * themselves or their sprites) are evicted least recently used first,
+ * once the approximate pixel memory goes over the budget.
+ */
+
 class GEM_EXPORT Factory {
+public:
+	struct Stats {
+		unsigned long hits = 0;
+		unsigned long misses = 0;
+		unsigned long evictions = 0;
+		size_t residentBytes = 0;
+	};
+
 private:
-	std::vector< FactoryObject*> fobjects;
+	struct Key {
+		ResRef ref;
+		SClass_ID type;
+
+		bool operator==(const Key& rhs) const {
+			return type == rhs.type && ref == rhs.ref;
+		}
+		struct Hash {
+			size_t operator()(const Key& key) const {
+				return ResRef::Hash()(key.ref) ^ key.type;
+			}
+		};
+	};
+	struct Entry {
+		Holder<FactoryObject> object;
+		size_t bytes;
+		unsigned long lastUse;
+	};
+
+	std::unordered_map<Key, Entry, Key::Hash> fobjects;
+	unsigned long uses = 0;
+	size_t budget;
+	// set when something was added since the last Trim
+	bool grown = false;
+	Stats stats;
+
 public:
 	Factory(void);
 	~Factory(void);
 	void AddFactoryObject(FactoryObject* fobject);
-	int IsLoaded(const char* ResRef, SClass_ID type) const;
-	FactoryObject* GetFactoryObject(int pos) const;
+	/** Returns the cached object or NULL */
+	FactoryObject* GetFactoryObject(const char* ResRef, SClass_ID type);
+	/** Sets the memory budget in bytes */
+	void SetBudget(size_t bytes) { budget = bytes; }
+	/** Evicts unused objects until the budget is met; the raw pointers
+	 * handed out are valid until then, so call it outside of any lookups */
+	void Trim();
+	const Stats& GetStats() const { return stats; }
 	void FreeObjects(void);
 };
 
@@ -24,14 +24,20 @@
 #include "exports.h"
 #include "globals.h"
 
+#include "Holder.h"
+
 namespace GemRB {
 
-class GEM_EXPORT FactoryObject {
+class GEM_EXPORT FactoryObject : public Held<FactoryObject> {
 public:
 	SClass_ID SuperClassID;
 	ieResRef ResRef;
 	FactoryObject(const char* ResRef, SClass_ID SuperClassID);
 	virtual ~FactoryObject(void);
+	/** Returns the approximate memory used by the pixel data */
+	virtual size_t GetMemorySize() const { return 0; }
+	/** Returns true if any of the produced objects are still referenced elsewhere */
+	virtual bool InUse() const { return false; }
 };
 
 }
@@ -0,0 +1,195 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "FrameProfiler.h"
+
+#include "Interface.h"
+#include "System/FileStream.h"
+#include "System/VFS.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+
+namespace GemRB {
+
+// indented by nesting depth in the overlay
+static const struct {
+	const char* name;
+	int depth;
+} phaseInfo[FrameProfiler::PHASE_COUNT] = {
+	{ "GameLoop", 0 },
+	{ "Scripts", 1 },
+	{ "FogUpdate", 1 },
+	{ "Effects", 1 },
+	{ "DrawWindows", 0 },
+	{ "DrawMap", 1 },
+	{ "Overlays", 2 },
+	{ "Stencils", 2 },
+	{ "Objects", 2 },
+	{ "Fog", 2 },
+	{ "Swap", 0 }
+};
+
+static const char* counterNames[FrameProfiler::COUNTER_COUNT] = {
+	"Pathfinding", "LOSRays", "ScriptEvals", "Blits", "RenderCalls", "TargetSwitches"
+};
+
+int FrameProfiler::mode = 0;
+FrameProfiler::Sample FrameProfiler::current;
+FrameProfiler::Sample FrameProfiler::samples[HISTORY];
+size_t FrameProfiler::next = 0;
+size_t FrameProfiler::filled = 0;
+FrameProfiler::Sample FrameProfiler::total;
+ieDword FrameProfiler::totalFrames = 0;
+FileStream* FrameProfiler::csvFile = nullptr;
+
+void FrameProfiler::Scope::Stop()
+{
+	if (!running) return;
+	running = false;
+	// profiling may have been turned off in the meantime
+	if (!FrameProfiler::mode) return;
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+	FrameProfiler::current.usec[phase] += ieDword(elapsed.count());
+}
+
+void FrameProfiler::SetMode(int newMode)
+{
+	if (newMode == mode) return;
+
+	if ((mode & CSV) && filled) {
+		WriteCSV();
+	}
+	if (!(newMode & CSV)) {
+		delete csvFile;
+		csvFile = nullptr;
+	}
+	mode = newMode;
+	memset(&current, 0, sizeof(current));
+	memset(&total, 0, sizeof(total));
+	next = filled = 0;
+	totalFrames = 0;
+}
+
+void FrameProfiler::EndFrame()
+{
+	if (!mode) return;
+
+	samples[next] = current;
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		total.usec[i] += current.usec[i];
+	}
+	for (int i = 0; i < COUNTER_COUNT; i++) {
+		total.counters[i] += current.counters[i];
+	}
+	totalFrames++;
+	memset(&current, 0, sizeof(current));
+	next = (next + 1) % HISTORY;
+	if (filled < HISTORY) {
+		filled++;
+	}
+
+	// flush whenever the ring buffer wrapped, so nothing is lost
+	if ((mode & CSV) && next == 0) {
+		WriteCSV();
+		filled = 0;
+	}
+}
+
+void FrameProfiler::WriteCSV()
+{
+	char line[512];
+	if (!csvFile) {
+		char path[_MAX_PATH];
+		// the game data is often read-only, the save path is meant to be writable
+		PathJoin(path, core->SavePath, "GemRB-profile.csv", nullptr);
+		csvFile = new FileStream();
+		if (!csvFile->Create(path)) {
+			Log(ERROR, "FrameProfiler", "Cannot write %s, disabling the CSV output.", path);
+			delete csvFile;
+			csvFile = nullptr;
+			mode &= ~CSV;
+			return;
+		}
+		Log(MESSAGE, "FrameProfiler", "Writing frame timings to %s", path);
+
+		size_t len = 0;
+		for (const auto& phase : phaseInfo) {
+			len += snprintf(line + len, sizeof(line) - len, "%s,", phase.name);
+		}
+		for (int i = 0; i < COUNTER_COUNT; i++) {
+			len += snprintf(line + len, sizeof(line) - len, i < COUNTER_COUNT - 1 ? "%s," : "%s\n", counterNames[i]);
+		}
+		csvFile->Write(line, len);
+	}
+
+	// oldest first
+	size_t start = (next + HISTORY - filled) % HISTORY;
+	for (size_t s = 0; s < filled; s++) {
+		const Sample& sample = samples[(start + s) % HISTORY];
+		size_t len = 0;
+		for (ieDword usec : sample.usec) {
+			len += snprintf(line + len, sizeof(line) - len, "%u,", usec);
+		}
+		for (int i = 0; i < COUNTER_COUNT; i++) {
+			len += snprintf(line + len, sizeof(line) - len, i < COUNTER_COUNT - 1 ? "%u," : "%u\n", sample.counters[i]);
+		}
+		csvFile->Write(line, len);
+	}
+}
+
+String FrameProfiler::Report(bool allFrames)
+{
+	size_t frames = allFrames ? totalFrames : filled;
+	if (!frames) return String();
+
+	double usec[PHASE_COUNT] = {};
+	double counters[COUNTER_COUNT] = {};
+	if (allFrames) {
+		std::copy(total.usec, total.usec + PHASE_COUNT, usec);
+		std::copy(total.counters, total.counters + COUNTER_COUNT, counters);
+	} else {
+		for (size_t s = 0; s < filled; s++) {
+			for (int i = 0; i < PHASE_COUNT; i++) {
+				usec[i] += samples[s].usec[i];
+			}
+			for (int i = 0; i < COUNTER_COUNT; i++) {
+				counters[i] += samples[s].counters[i];
+			}
+		}
+	}
+
+	String report;
+	wchar_t line[64];
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		swprintf(line, sizeof(line)/sizeof(line[0]), L"%*s%s %.2f ms\n", phaseInfo[i].depth * 2, "",
+				 phaseInfo[i].name, usec[i] / frames / 1000.0);
+		report += line;
+	}
+	for (int i = 0; i < COUNTER_COUNT; i++) {
+		swprintf(line, sizeof(line)/sizeof(line[0]), L"%s %.1f\n", counterNames[i], counters[i] / frames);
+		report += line;
+	}
+	return report;
+}
+
+}
@@ -0,0 +1,125 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include "exports.h"
+#include "ie_types.h"
+
+#include "System/String.h"
+
+#include <chrono>
+
+namespace GemRB {
+
+class FileStream;
+
+/**
+ * Per frame timings of the main loop phases and a few event counters,
+ * kept in a ring buffer. Phases nest, so their times include the phases
+ * run inside them. Everything is a no-op while profiling is off.
+ */
+class GEM_EXPORT FrameProfiler {
+public:
+	enum Phase {
+		PHASE_GAMELOOP,
+		PHASE_SCRIPTS,
+		PHASE_FOGUPDATE,
+		PHASE_EFFECTS,
+		PHASE_DRAWWINDOWS,
+		PHASE_DRAWMAP,
+		PHASE_OVERLAYS,
+		PHASE_STENCILS,
+		PHASE_OBJECTS,
+		PHASE_FOG,
+		PHASE_SWAP,
+		PHASE_COUNT
+	};
+
+	enum Counter {
+		COUNT_PATHFINDING,
+		COUNT_LOSRAYS,
+		COUNT_SCRIPTS,
+		COUNT_BLITS,
+		COUNT_RENDERCALLS,
+		COUNT_TARGETSWITCHES,
+		COUNTER_COUNT
+	};
+
+	// mode bits
+	static const int OVERLAY = 1;
+	static const int CSV = 2;
+
+	using Clock = std::chrono::steady_clock;
+
+	/** Times a phase from construction until Stop or destruction */
+	class Scope {
+		Phase phase;
+		bool running;
+		Clock::time_point start;
+	public:
+		explicit Scope(Phase phase)
+		: phase(phase), running(FrameProfiler::mode != 0)
+		{
+			if (running) start = Clock::now();
+		}
+		~Scope() { Stop(); }
+		void Stop();
+	};
+
+private:
+	struct Sample {
+		ieDword usec[PHASE_COUNT];
+		ieDword counters[COUNTER_COUNT];
+	};
+	static const size_t HISTORY = 120;
+
+	static int mode;
+	static Sample current;
+	static Sample samples[HISTORY];
+	static size_t next;
+	static size_t filled;
+	// sums over every frame since the mode was set
+	static Sample total;
+	static ieDword totalFrames;
+	static FileStream* csvFile;
+
+	static void WriteCSV();
+
+public:
+	/** Combination of OVERLAY and CSV, 0 turns profiling off */
+	static void SetMode(int mode);
+	static int GetMode() { return mode; }
+
+	static void Count(Counter counter, ieDword amount = 1)
+	{
+		if (mode) current.counters[counter] += amount;
+	}
+	/** Stores the current sample, called once per main loop iteration */
+	static void EndFrame();
+	/** Averages over the stored samples, or over every frame since profiling
+	 * was enabled, one line per phase and counter */
+	static String Report(bool allFrames = false);
+};
+
+}
+
+#endif
@@ -47,7 +47,7 @@ private:
 	Region mosRgn;
 	Point notePos;
 
-	AnimationFactory* mapFlags;
+	Holder<AnimationFactory> mapFlags;
 	
 public:
 	// Small map bitmap
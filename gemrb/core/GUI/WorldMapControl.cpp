@@ -24,6 +24,7 @@
 
 #include "DisplayMessage.h"
 #include "Game.h"
+#include "GameData.h"
 #include "Interface.h"
 #include "WorldMap.h"
 #include "GUI/EventMgr.h"
@@ -102,7 +103,7 @@ void WorldMapControl::DrawSelf(Region rgn, const Region& /*clip*/)
 		if (! (m->GetAreaStatus() & WMP_ENTRY_VISIBLE)) continue;
 
 		Point offset = MapToScreen(m->pos);
-		Holder<Sprite2D> icon = m->GetMapIcon(worldmap->bam);
+		Holder<Sprite2D> icon = m->GetMapIcon(worldmap->bam.get());
 		if (icon) {
 			BlitFlags flags =  core->HasFeature(GF_AUTOMAP_INI) ? BlitFlags::BLENDED : (BlitFlags::BLENDED | BlitFlags::COLOR_MOD);
 			if (m == Area && m->HighlightSelected()) {
@@ -128,7 +129,7 @@ void WorldMapControl::DrawSelf(Region rgn, const Region& /*clip*/)
 		if (ftext == nullptr || caption == nullptr)
 			continue;
 
-		Holder<Sprite2D> icon = m->GetMapIcon(worldmap->bam);
+		Holder<Sprite2D> icon = m->GetMapIcon(worldmap->bam.get());
 		if (!icon) continue;
 		const Region& icon_frame = icon->Frame;
 		Point p = m->pos - icon_frame.origin;
@@ -202,7 +203,7 @@ bool WorldMapControl::OnMouseOver(const MouseEvent& me)
 				continue; //invisible or inaccessible
 			}
 
-			Holder<Sprite2D> icon = ae->GetMapIcon(worldmap->bam);
+			Holder<Sprite2D> icon = ae->GetMapIcon(worldmap->bam.get());
 			Region rgn(ae->pos, Size());
 			if (icon) {
 				rgn.x -= icon->Frame.x;
@@ -223,6 +224,7 @@ bool WorldMapControl::OnMouseOver(const MouseEvent& me)
 			SetCursor(core->Cursors[IE_CURSOR_NORMAL]);
 			Area=ae;
 			if(oldArea!=ae) {
+				gamedata->PrefetchArea(Area->AreaResRef);
 				String* str = core->GetString(DisplayMessage::GetStringReference(STR_TRAVEL_TIME));
 				int hours = worldmap->GetDistance(Area->AreaName);
 				if (str && !str->empty() && hours >= 0) {
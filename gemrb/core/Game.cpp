@@ -26,6 +26,7 @@
 #include "strrefs.h"
 
 #include "DisplayMessage.h"
+#include "FrameProfiler.h"
 #include "GameData.h"
 #include "Interface.h"
 #include "IniSpawn.h"
@@ -913,6 +914,8 @@ int Game::LoadMap(const char* ResRef, bool loadscreen)
 	Map *newMap;
 	PluginHolder<MapMgr> mM(IE_ARE_CLASS_ID);
 	ScriptEngine *sE = core->GetGUIScriptEngine();
+	unsigned long long copied = DataStream::BytesCopied();
+	unsigned long long mapped = DataStream::BytesMapped();
 
 	int index = FindMap(ResRef);
 	if (index>=0) {
@@ -951,12 +954,16 @@ int Game::LoadMap(const char* ResRef, bool loadscreen)
 
 	PlacePersistents(newMap, ResRef);
 	newMap->InitActors();
+	newMap->PreloadSounds();
 
 	if (newMap->reverb) {
 		core->GetAudioDrv()->UpdateMapAmbient(*newMap->reverb);
 	}
 
 failedload:
+	LogDebug("Game", "Loading %s copied %llu bytes from streams and used %llu in place",
+		ResRef, DataStream::BytesCopied() - copied, DataStream::BytesMapped() - mapped);
+	gamedata->DropAreaPrefetch();
 	core->LoadProgress(100);
 	return ret;
 }
@@ -1552,6 +1559,7 @@ bool Game::EveryoneDead() const
 
 void Game::UpdateScripts()
 {
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_SCRIPTS);
 	Update();
 
 	PartyAttack = false;
@@ -2286,6 +2294,9 @@ void Game::dump() const
 	Log(DEBUG, "Game", buffer);
 }
 
+// no game wide index on purpose: past MAX_MAPS_LOADED the unused maps are
+// unloaded, so this is one or two hash lookups, while a global map would have
+// to follow every actor through area transitions, summons and unloading
 Actor *Game::GetActorByGlobalID(ieDword globalID) const
 {
 	for (auto map : Maps) {
@@ -26,6 +26,8 @@
 #include "AnimationMgr.h"
 #include "Cache.h"
 #include "CharAnimations.h"
+#include "Dialog.h"
+#include "DialogMgr.h"
 #include "Effect.h"
 #include "EffectMgr.h"
 #include "Factory.h"
@@ -35,6 +37,7 @@
 #include "Interface.h"
 #include "Item.h"
 #include "ItemMgr.h"
+#include "MapMgr.h"
 #include "PluginMgr.h"
 #include "ResourceDesc.h"
 #include "ScriptedAnimation.h"
@@ -42,8 +45,10 @@
 #include "SpellMgr.h"
 #include "StoreMgr.h"
 #include "VEFObject.h"
+#include "GameScript/GameScript.h"
 #include "Scriptable/Actor.h"
 #include "System/FileStream.h"
+#include "System/VFS.h"
 
 #include <cstdio>
 
@@ -79,10 +84,21 @@ GameData::~GameData()
 
 void GameData::ClearCaches()
 {
+	LogLookupStats();
+	const Factory::Stats& fstats = factory->GetStats();
+	if (fstats.hits || fstats.misses) {
+		LogDebug("GameData", "Factory cache: %lu hits, %lu misses, %lu evictions, %lu KB resident",
+			fstats.hits, fstats.misses, fstats.evictions, (unsigned long) fstats.residentBytes / 1024);
+	}
 	ItemCache.RemoveAll(ReleaseItem);
 	SpellCache.RemoveAll(ReleaseSpell);
 	EffectCache.RemoveAll(ReleaseEffect);
 	PaletteCache.clear ();
+	DialogCache.clear();
+	for (auto& cached : ConditionCache) {
+		cached.second->Release();
+	}
+	ConditionCache.clear();
 
 	while (!stores.empty()) {
 		Store *store = stores.begin()->second;
@@ -94,6 +110,82 @@ void GameData::ClearCaches()
 	}
 }
 
+// Parsing the triggers and actions of big dialogs takes long enough to notice
+// when a conversation starts, so parsed dialogs are kept and shared.
+Holder<Dialog> GameData::GetDialog(const ieResRef resname)
+{
+	static const size_t MaxCachedDialogs = 64;
+
+	unsigned int generation = GetFilesGeneration();
+	auto iter = DialogCache.find(resname);
+	if (iter != DialogCache.end() && iter->second.generation == generation) {
+		iter->second.lastUse = ++dialogUses;
+		return iter->second.dialog;
+	}
+
+	DataStream *stream = GetResource(resname, IE_DLG_CLASS_ID);
+	if (!stream) {
+		return Holder<Dialog>();
+	}
+	time_t modified = file_mtime(stream->originalfile);
+
+	if (iter != DialogCache.end()) {
+		// files were written or added since, but maybe not this one
+		CachedDialog &cached = iter->second;
+		if (cached.path == stream->originalfile && cached.size == stream->Size() && cached.modified == modified) {
+			delete stream;
+			cached.generation = generation;
+			cached.lastUse = ++dialogUses;
+			return cached.dialog;
+		}
+		DialogCache.erase(iter);
+	}
+
+	PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
+	CachedDialog cached;
+	cached.generation = generation;
+	cached.path = stream->originalfile;
+	cached.size = stream->Size();
+	cached.modified = modified;
+	cached.lastUse = ++dialogUses;
+	dm->Open(stream);
+	cached.dialog = dm->GetDialog();
+	if (!cached.dialog) {
+		return Holder<Dialog>();
+	}
+	strnlwrcpy(cached.dialog->ResRef, resname, 8);
+
+	if (DialogCache.size() >= MaxCachedDialogs) {
+		auto oldest = DialogCache.begin();
+		for (auto it = DialogCache.begin(); it != DialogCache.end(); ++it) {
+			if (it->second.lastUse < oldest->second.lastUse) {
+				oldest = it;
+			}
+		}
+		DialogCache.erase(oldest);
+	}
+	DialogCache[resname] = cached;
+	return cached.dialog;
+}
+
+// stores check the same few trigger strings for every item they stock
+Condition* GameData::GetCondition(const char* text)
+{
+	auto iter = ConditionCache.find(text);
+	if (iter == ConditionCache.end()) {
+		PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
+		// the importer takes a writable string, but doesn't change it
+		std::string copy = text;
+		Condition *condition = dm->GetCondition(&copy[0]);
+		if (!condition) {
+			return NULL;
+		}
+		iter = ConditionCache.emplace(text, condition).first;
+	}
+	iter->second->IncRef();
+	return iter->second;
+}
+
 Actor *GameData::GetCreature(const char* ResRef, unsigned int PartySlot)
 {
 	DataStream* ds = GetResource( ResRef, IE_CRE_CLASS_ID );
@@ -452,10 +544,9 @@ Holder<Sprite2D> GameData::GetAnySprite(const char *resRef, int cycle, int frame
 FactoryObject* GameData::GetFactoryResource(const char* resname, SClass_ID type,
 	unsigned char mode, bool silent)
 {
-	int fobjindex = factory->IsLoaded(resname,type);
-	// already cached
-	if ( fobjindex != -1)
-		return factory->GetFactoryObject( fobjindex );
+	FactoryObject *cached = factory->GetFactoryObject(resname, type);
+	if (cached)
+		return cached;
 
 	// empty resref
 	if (!resname || !strcmp(resname, "")) return nullptr;
@@ -499,6 +590,45 @@ void GameData::AddFactoryResource(FactoryObject* res)
 	factory->AddFactoryObject(res);
 }
 
+void GameData::TrimFactoryCache()
+{
+	factory->Trim();
+}
+
+void GameData::SetFactoryCacheSize(int megabytes)
+{
+	if (megabytes <= 0) return;
+	factory->SetBudget(size_t(megabytes) * 1024 * 1024);
+}
+
+void GameData::PrefetchArea(const char* area)
+{
+	if (!area || !area[0] || prefetchedArea == area) return;
+	const Game* game = core->GetGame();
+	if (!game || game->FindMap(area) >= 0) return;
+
+	PluginHolder<MapMgr> mM(IE_ARE_CLASS_ID);
+	if (mM == nullptr) return;
+	DataStream* ds = GetResource(area, IE_ARE_CLASS_ID, true);
+	if (!mM->Open(ds)) return;
+
+	// only one destination at a time, the old one was not taken
+	if (!prefetchedArea.IsEmpty()) {
+		DropPrefetched();
+	}
+	prefetchedArea = area;
+	std::vector<ResourceRequest> list;
+	mM->GetResourceList(list);
+	LogDebug("GameData", "Prefetching %d resources of %s", (int) list.size(), area);
+	Prefetch(list);
+}
+
+void GameData::DropAreaPrefetch()
+{
+	prefetchedArea = ResRef();
+	DropPrefetched();
+}
+
 Store* GameData::GetStore(const ieResRef ResRef)
 {
 	StoreMap::iterator it = stores.find(ResRef);
@@ -629,7 +759,7 @@ int GameData::GetRacialTHAC0Bonus(ieDword proficiency, const char *raceName)
 
 	char profString[5];
 	snprintf(profString, sizeof(profString), "%u", proficiency);
-	return atoi(raceTHAC0Bonus->QueryField(profString, raceName));
+	return raceTHAC0Bonus->QueryFieldSigned(profString, raceName);
 }
 
 bool GameData::HasInfravision(const char *raceName)
@@ -639,7 +769,7 @@ bool GameData::HasInfravision(const char *raceName)
 	}
 	if (!raceName) return false;
 
-	return atoi(racialInfravision->QueryField(raceName, "VALUE")) & 1;
+	return racialInfravision->QueryFieldSigned(raceName, "VALUE") & 1;
 }
 
 int GameData::GetSpellAbilityDie(const Actor *target, int which)
@@ -655,7 +785,7 @@ int GameData::GetSpellAbilityDie(const Actor *target, int which)
 
 	ieDword cls = target->GetActiveClass();
 	if (cls >= spellAbilityDie->GetRowCount()) cls = 0;
-	return atoi(spellAbilityDie->QueryField(cls, which));
+	return spellAbilityDie->QueryFieldSigned(cls, which);
 }
 
 int GameData::GetTrapSaveBonus(ieDword level, int cls)
@@ -666,7 +796,7 @@ int GameData::GetTrapSaveBonus(ieDword level, int cls)
 		trapSaveBonus.load("trapsave", true);
 	}
 
-	return atoi(trapSaveBonus->QueryField(level - 1, cls - 1));
+	return trapSaveBonus->QueryFieldSigned(level - 1, cls - 1);
 }
 
 int GameData::GetTrapLimit(Scriptable *trapper)
@@ -689,7 +819,7 @@ int GameData::GetTrapLimit(Scriptable *trapper)
 		rowName = caster->GetClassName(cls);
 	}
 
-	return atoi(trapLimit->QueryField(rowName, "LIMIT"));
+	return trapLimit->QueryFieldSigned(rowName, "LIMIT");
 }
 
 int GameData::GetSummoningLimit(ieDword sex)
@@ -710,7 +840,7 @@ int GameData::GetSummoningLimit(ieDword sex)
 		default:
 			break;
 	}
-	return atoi(summoningLimit->QueryField(row, 0));
+	return summoningLimit->QueryFieldSigned(row, 0);
 }
 
 const Color& GameData::GetColor(const char *row)
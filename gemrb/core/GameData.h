@@ -32,7 +32,9 @@
 #include "ResourceManager.h"
 #include "TableMgr.h"
 
+#include <ctime>
 #include <map>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -41,6 +43,7 @@ namespace GemRB {
 static const ieResRef SevenEyes[7]={"spin126","spin127","spin128","spin129","spin130","spin131","spin132"};
 
 class Actor;
+class Condition;
 struct Effect;
 class Factory;
 class FactoryObject;
@@ -60,6 +63,8 @@ struct Table {
 	unsigned int refcount;
 };
 
+class Dialog;
+
 class GEM_EXPORT GameData : public ResourceManager
 {
 public:
@@ -95,6 +100,10 @@ public:
 	void FreeSpell(Spell *spl, const ieResRef name, bool free=false);
 	Effect* GetEffect(const ieResRef resname);
 	void FreeEffect(Effect *eff, const ieResRef name, bool free=false);
+	/** Returns a parsed dialog, shared with every other user of it */
+	Holder<Dialog> GetDialog(const ieResRef resname);
+	/** Parses trigger text like dialogs do; the result is shared, Release it when done */
+	Condition* GetCondition(const char* text);
 
 	/** creates a vvc/bam animation object at point */
 	ScriptedAnimation* GetScriptedAnimation( const char *ResRef, bool doublehint);
@@ -113,6 +122,14 @@ public:
 		unsigned char mode = IE_NORMAL, bool silent=false);
 
 	void AddFactoryResource(FactoryObject* res);
+	/** drops unused factory objects over the budget, invalidating raw pointers to them */
+	void TrimFactoryCache();
+	void SetFactoryCacheSize(int megabytes);
+
+	/** starts reading the resources of an area that is likely to be entered soon */
+	void PrefetchArea(const char* area);
+	/** drops what was read ahead, call when the area got loaded */
+	void DropAreaPrefetch();
 
 	Store* GetStore(const ieResRef ResRef);
 	/// Saves a store to the cache and frees it.
@@ -143,7 +160,20 @@ private:
 	Cache SpellCache;
 	Cache EffectCache;
 	std::unordered_map<ResRef, PaletteHolder, ResRef::Hash> PaletteCache;
+	struct CachedDialog {
+		Holder<Dialog> dialog;
+		// checked only after files were added, so overrides get picked up
+		unsigned int generation;
+		std::string path;
+		unsigned long size;
+		time_t modified;
+		unsigned long lastUse;
+	};
+	std::unordered_map<ResRef, CachedDialog, ResRef::Hash> DialogCache;
+	unsigned long dialogUses = 0;
+	std::unordered_map<std::string, Condition*> ConditionCache;
 	Factory* factory;
+	ResRef prefetchedArea;
 	std::vector<Table> tables;
 	typedef std::map<const char*, Store*, iless> StoreMap;
 	StoreMap stores;
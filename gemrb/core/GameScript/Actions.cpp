@@ -127,21 +127,21 @@ void GameScript::NoAction(Scriptable* Sender, Action* /*parameters*/)
 
 void GameScript::SG(Scriptable* Sender, Action* parameters)
 {
-	SetVariable( Sender, parameters->string0Parameter, parameters->int0Parameter, "GLOBAL");
+	SetVariable( Sender, parameters->Variable(0, "GLOBAL"), parameters->int0Parameter);
 }
 
 void GameScript::SetGlobal(Scriptable* Sender, Action* parameters)
 {
-	SetVariable( Sender, parameters->string0Parameter, parameters->int0Parameter );
+	SetVariable( Sender, parameters->Variable(0), parameters->int0Parameter );
 }
 
 void GameScript::SetGlobalRandom(Scriptable* Sender, Action* parameters)
 {
 	int max=parameters->int1Parameter-parameters->int0Parameter+1;
 	if (max>0) {
-		SetVariable( Sender, parameters->string0Parameter, RandomNumValue%max+parameters->int0Parameter );
+		SetVariable( Sender, parameters->Variable(0), RandomNumValue%max+parameters->int0Parameter );
 	} else {
-		SetVariable( Sender, parameters->string0Parameter, 0);
+		SetVariable( Sender, parameters->Variable(0), 0);
 	}
 }
 
@@ -161,7 +161,7 @@ void GameScript::SetGlobalTimer(Scriptable* Sender, Action* parameters)
 	ieDword mytime;
 
 	mytime=core->GetGame()->GameTime; //gametime (should increase it)
-	SetVariable( Sender, parameters->string0Parameter,
+	SetVariable( Sender, parameters->Variable(0),
 		parameters->int0Parameter*AI_UPDATE_TIME + mytime);
 }
 
@@ -180,17 +180,17 @@ void GameScript::SetGlobalTimerRandom(Scriptable* Sender, Action* parameters)
 		random = RandomNumValue % random + parameters->int1Parameter;
 	}
 	mytime=core->GetGame()->GameTime; //gametime (should increase it)
-	SetVariable( Sender, parameters->string0Parameter, random*AI_UPDATE_TIME + mytime);
+	SetVariable( Sender, parameters->Variable(0), random*AI_UPDATE_TIME + mytime);
 }
 
 void GameScript::SetGlobalTimerOnce(Scriptable* Sender, Action* parameters)
 {
-	ieDword mytime = CheckVariable( Sender, parameters->string0Parameter );
+	ieDword mytime = CheckVariable(Sender, parameters->Variable(0));
 	if (mytime != 0) {
 		return;
 	}
 	mytime=core->GetGame()->GameTime; //gametime (should increase it)
-	SetVariable( Sender, parameters->string0Parameter,
+	SetVariable( Sender, parameters->Variable(0),
 		parameters->int0Parameter*AI_UPDATE_TIME + mytime);
 }
 
@@ -198,7 +198,7 @@ void GameScript::RealSetGlobalTimer(Scriptable* Sender, Action* parameters)
 {
 	ieDword mytime=core->GetGame()->RealTime;
 
-	SetVariable( Sender, parameters->string0Parameter,
+	SetVariable( Sender, parameters->Variable(0),
 		parameters->int0Parameter*AI_UPDATE_TIME + mytime);
 }
 
@@ -337,7 +337,7 @@ void GameScript::ChangeStatGlobal(Scriptable* Sender, Action* parameters)
 	if (!scr || scr->Type != ST_ACTOR) {
 		return;
 	}
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter));
 	Actor* actor = ( Actor* ) scr;
 	if (parameters->int1Parameter==1) {
 		value+=actor->GetBase(parameters->int0Parameter);
@@ -840,7 +840,7 @@ void GameScript::StartCutSceneEx(Scriptable* Sender, Action* parameters)
 void GameScript::CutSceneID(Scriptable *Sender, Action* /*parameters*/)
 {
 	// shouldn't get called
-	Log(DEBUG, "GameScript", "CutSceneID was called by %s!", Sender->GetScriptName());
+	LogDebug("GameScript", "CutSceneID was called by %s!", Sender->GetScriptName());
 }
 
 static EffectRef fx_charm_ref = { "State:Charmed", -1 };
@@ -996,7 +996,7 @@ void GameScript::CreateCreatureAtLocation(Scriptable* Sender, Action* parameters
 	if (!parameters->string0Parameter[0]) {
 		strcpy(parameters->string0Parameter,"LOCALSsavedlocation");
 	}
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
 	parameters->pointParameter.y = (ieWord) (value & 0xffff);
 	parameters->pointParameter.x = (ieWord) (value >> 16);
 	CreateCreatureCore(Sender, parameters, CC_CHECK_IMPASSABLE|CC_STRING1);
@@ -2166,7 +2166,7 @@ void GameScript::PlaySequence(Scriptable* Sender, Action* parameters)
 //same as PlaySequence, but the value comes from a variable
 void GameScript::PlaySequenceGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
 	PlaySequenceCore(Sender, parameters, value);
 }
 
@@ -2279,7 +2279,7 @@ void GameScript::NIDSpecial2(Scriptable* Sender, Action* /*parameters*/)
 		if (directions[best] != -1) {
 			direction = best;
 		}
-		Log(DEBUG, "Actions", "Travel direction determined by party: %d", direction);
+		LogDebug("Actions", "Travel direction determined by party: %d", direction);
 	}
 
 	// pst enables worldmap travel only after visiting the lower ward
@@ -2864,7 +2864,7 @@ void GameScript::UnMakeGlobal(Scriptable* Sender, Action* /*parameters*/)
 //this apparently doesn't check the gold, thus could be used from non actors
 void GameScript::GivePartyGoldGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword gold = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter);
+	ieDword gold = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter));
 	if (Sender->Type == ST_ACTOR) {
 		Actor* act = ( Actor* ) Sender;
 		ieDword mygold = act->GetStat(IE_GOLD);
@@ -2971,7 +2971,7 @@ void GameScript::AddExperiencePartyCR(Scriptable* /*Sender*/, Action* parameters
 
 void GameScript::AddExperiencePartyGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword xp = CheckVariable( Sender, parameters->string0Parameter, parameters->string1Parameter );
+	ieDword xp = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter));
 	core->GetGame()->ShareXP(xp, SX_DIVIDE);
 	core->PlaySound(DS_GOTXP, SFX_CHAN_ACTIONS);
 }
@@ -3194,7 +3194,7 @@ void GameScript::SetToken(Scriptable* /*Sender*/, Action* parameters)
 //Assigns a numeric variable to the token
 void GameScript::SetTokenGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
 	//using SetAtCopy because we need a copy of the value
 	core->GetTokenDictionary()->SetAtCopy( parameters->string1Parameter, value );
 }
@@ -3311,40 +3311,38 @@ void GameScript::AnkhegHide(Scriptable* Sender, Action* /*parameters*/)
 
 void GameScript::GlobalSetGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
-	SetVariable( Sender, parameters->string1Parameter, value );
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
+	SetVariable( Sender, parameters->Variable(1), value );
 }
 
 /* adding the second variable to the first, they must be GLOBAL */
 void GameScript::AddGlobals(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter, "GLOBAL");
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter, "GLOBAL");
-	SetVariable( Sender, parameters->string0Parameter, value1 + value2, "GLOBAL");
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "GLOBAL"));
+	SetVariable( Sender, parameters->Variable(0, "GLOBAL"), value1 + value2);
 }
 
 /* adding the second variable to the first, they could be area or locals */
 void GameScript::GlobalAddGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 + value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 + value2 );
 }
 
 /* adding the number to the global, they could be area or locals */
 void GameScript::IncrementGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
+	SetVariable( Sender, parameters->Variable(0),
 		value + parameters->int0Parameter );
 }
 
 /* adding the number to the global ONLY if the first global is zero */
 void GameScript::IncrementGlobalOnce(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
 	if (value != 0) {
 		return;
 	}
@@ -3352,180 +3350,162 @@ void GameScript::IncrementGlobalOnce(Scriptable* Sender, Action* parameters)
 	//just a best guess at how the two parameters are changed, and could
 	//well be more complex; the original usage of this function is currently
 	//not well understood (relates to hardcoded alignment changes)
-	SetVariable( Sender, parameters->string0Parameter, 1 );
+	SetVariable( Sender, parameters->Variable(0), 1 );
 
-	value = CheckVariable( Sender, parameters->string1Parameter );
-	SetVariable( Sender, parameters->string1Parameter,
+	value = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(1),
 		value + parameters->int0Parameter );
 }
 
 void GameScript::GlobalSubGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 - value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 - value2 );
 }
 
 void GameScript::GlobalAndGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 && value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 && value2 );
 }
 
 void GameScript::GlobalOrGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 || value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 || value2 );
 }
 
 void GameScript::GlobalBOrGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 | value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 | value2 );
 }
 
 void GameScript::GlobalBAndGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 & value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 & value2 );
 }
 
 void GameScript::GlobalXorGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 ^ value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
+	SetVariable( Sender, parameters->Variable(0), value1 ^ value2 );
 }
 
 void GameScript::GlobalBOr(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	SetVariable( Sender, parameters->Variable(0),
 		value1 | parameters->int0Parameter );
 }
 
 void GameScript::GlobalBAnd(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	SetVariable( Sender, parameters->Variable(0),
 		value1 & parameters->int0Parameter );
 }
 
 void GameScript::GlobalXor(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	SetVariable( Sender, parameters->Variable(0),
 		value1 ^ parameters->int0Parameter );
 }
 
 void GameScript::GlobalMax(Scriptable* Sender, Action* parameters)
 {
-	long value1 = CheckVariable( Sender, parameters->string0Parameter );
+	long value1 = CheckVariable(Sender, parameters->Variable(0));
 	if (value1 > parameters->int0Parameter) {
-		SetVariable( Sender, parameters->string0Parameter, value1 );
+		SetVariable( Sender, parameters->Variable(0), value1 );
 	}
 }
 
 void GameScript::GlobalMin(Scriptable* Sender, Action* parameters)
 {
-	long value1 = CheckVariable( Sender, parameters->string0Parameter );
+	long value1 = CheckVariable(Sender, parameters->Variable(0));
 	if (value1 < parameters->int0Parameter) {
-		SetVariable( Sender, parameters->string0Parameter, value1 );
+		SetVariable( Sender, parameters->Variable(0), value1 );
 	}
 }
 
 void GameScript::BitClear(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	SetVariable( Sender, parameters->Variable(0),
 		value1 & ~parameters->int0Parameter );
 }
 
 void GameScript::GlobalShL(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
 	ieDword value2 = parameters->int0Parameter;
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 <<= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable( Sender, parameters->Variable(0), value1 );
 }
 
 void GameScript::GlobalShR(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
 	ieDword value2 = parameters->int0Parameter;
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 >>= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable( Sender, parameters->Variable(0), value1 );
 }
 
 void GameScript::GlobalMaxGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
 	if (value1 < value2) {
-		SetVariable( Sender, parameters->string0Parameter, value2 );
+		SetVariable( Sender, parameters->Variable(0), value2 );
 	}
 }
 
 void GameScript::GlobalMinGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
 	if (value1 > value2) {
-		SetVariable( Sender, parameters->string0Parameter, value2 );
+		SetVariable( Sender, parameters->Variable(0), value2 );
 	}
 }
 
 void GameScript::GlobalShLGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 <<= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable( Sender, parameters->Variable(0), value1 );
 }
 void GameScript::GlobalShRGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 >>= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable( Sender, parameters->Variable(0), value1 );
 }
 
 void GameScript::ClearAllActions(Scriptable* Sender, Action* /*parameters*/)
@@ -3659,17 +3639,17 @@ void GameScript::SetTextColor(Scriptable* /*Sender*/, Action* parameters)
 
 void GameScript::BitGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Variable(0));
 	HandleBitMod( value, parameters->int0Parameter, parameters->int1Parameter);
-	SetVariable(Sender, parameters->string0Parameter, value);
+	SetVariable(Sender, parameters->Variable(0), value);
 }
 
 void GameScript::GlobalBitGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1));
 	HandleBitMod( value1, value2, parameters->int1Parameter);
-	SetVariable(Sender, parameters->string0Parameter, value1);
+	SetVariable(Sender, parameters->Variable(0), value1);
 }
 
 void GameScript::SetVisualRange(Scriptable* Sender, Action* parameters)
@@ -4166,7 +4146,7 @@ void GameScript::CreateItemNumGlobal(Scriptable *Sender, Action* parameters)
 		default:
 			return;
 	}
-	int value = CheckVariable( Sender, parameters->string0Parameter );
+	int value = CheckVariable(Sender, parameters->Variable(0));
 	CREItem *item = new CREItem();
 	if (!CreateItemCore(item, parameters->string1Parameter, value, 0, 0)) {
 		delete item;
@@ -6233,7 +6213,7 @@ void GameScript::GetStat(Scriptable* Sender, Action* parameters)
 		Actor* actor = ( Actor* ) tar;
 		value = actor->GetStat( parameters->int0Parameter );
 	}
-	SetVariable( Sender, parameters->string0Parameter, value );
+	SetVariable( Sender, parameters->Variable(0), value );
 }
 
 void GameScript::BreakInstants(Scriptable* Sender, Action* /*parameters*/)
@@ -1452,7 +1452,7 @@ void AttackCore(Scriptable *Sender, Scriptable *target, int flags)
 	// mislead and projected images can't attack
 	int puppet = actor->GetStat(IE_PUPPETMASTERTYPE);
 	if (puppet && puppet < 3) {
-		Log(DEBUG, "AttackCore", "Tried attacking with an illusionary copy: %s!", actor->GetName(1));
+		LogDebug("AttackCore", "Tried attacking with an illusionary copy: %s!", actor->GetName(1));
 		return;
 	}
 
@@ -2171,46 +2171,74 @@ Trigger *GenerateTriggerCore(const char *src, const char *str, int trIndex, int
 	return newTrigger;
 }
 
-void SetVariable(Scriptable* Sender, const char* VarName, ieDword value, const char* Context)
+// decodes the scope prefix and interns the name, so scripts only do it once per variable
+void ResolveVariable(VariableRef& var, const char* VarName, const char* Context)
 {
-	char newVarName[8+33];
-	
+	char scope[7];
 	const char *poi = VarName;
 	if (Context == nullptr) {
-		poi = &VarName[6];
+		strlcpy(scope, VarName, 7);
+		poi = VarName + strlen(scope);
 		//some HoW triggers use a : to separate the scope from the variable name
 		if (*poi==':') {
 			poi++;
 		}
-		strlcpy(newVarName, VarName, 7);
 	} else {
-		strlcpy(newVarName, Context, 7);
-	}
-	ScriptDebugLog(ID_VARIABLES, "Setting variable(\"%s%s\", %d)", Context, VarName, value);
-	
-	if (strnicmp( newVarName, "MYAREA", 6) == 0) {
-		Sender->GetCurrentArea()->locals->SetAt( poi, value, NoCreate );
-		return;
+		strlcpy(scope, Context, 7);
 	}
-	if (strnicmp( newVarName, "LOCALS", 6) == 0) {
-		Sender->locals->SetAt( poi, value, NoCreate );
-		return;
+
+	if (stricmp(scope, "MYAREA") == 0) {
+		var.scope = VariableRef::MYAREA;
+	} else if (stricmp(scope, "LOCALS") == 0) {
+		var.scope = VariableRef::LOCALS;
+	} else if (HasKaputz && stricmp(scope, "KAPUTZ") == 0) {
+		var.scope = VariableRef::KAPUTZ;
+	} else if (stricmp(scope, "GLOBAL") == 0) {
+		var.scope = VariableRef::GLOBAL;
+	} else {
+		var.scope = VariableRef::AREA;
+		memcpy(var.area, scope, sizeof(var.area));
 	}
+	var.symbol = Variables::Intern(poi);
+}
+
+void SetVariable(Scriptable* Sender, const char* VarName, ieDword value, const char* Context)
+{
+	VariableRef var;
+	ResolveVariable(var, VarName, Context);
+	SetVariable(Sender, var, value);
+}
+
+void SetVariable(Scriptable* Sender, const VariableRef& var, ieDword value)
+{
+	ScriptDebugLog(ID_VARIABLES, "Setting variable(\"%s\", %d)", Variables::SymbolName(var.symbol), value);
+
 	Game *game = core->GetGame();
-	if (HasKaputz && !strnicmp(newVarName, "KAPUTZ", 6)) {
-		game->kaputz->SetAt( poi, value, NoCreate );
-		return;
-	}
-	if (strnicmp(newVarName, "GLOBAL", 6) ) {
-		Map *map=game->GetMap(game->FindMap(newVarName));
-		if (map) {
-			map->locals->SetAt( poi, value, NoCreate);
-		} else if (core->InDebugMode(ID_VARIABLES)) {
-			Log(WARNING, "GameScript", "Invalid variable %s %s in setvariable",
-				Context, VarName);
+	switch (var.scope) {
+		case VariableRef::MYAREA:
+			Sender->GetCurrentArea()->locals->SetAt(var.symbol, value, NoCreate);
+			break;
+		case VariableRef::LOCALS:
+			Sender->locals->SetAt(var.symbol, value, NoCreate);
+			break;
+		case VariableRef::KAPUTZ:
+			game->kaputz->SetAt(var.symbol, value, NoCreate);
+			break;
+		case VariableRef::GLOBAL:
+			game->locals->SetAt(var.symbol, value, NoCreate);
+			break;
+		case VariableRef::AREA: {
+			Map *map = game->GetMap(game->FindMap(var.area));
+			if (map) {
+				map->locals->SetAt(var.symbol, value, NoCreate);
+			} else if (core->InDebugMode(ID_VARIABLES)) {
+				Log(WARNING, "GameScript", "Invalid variable %s %s in setvariable",
+					var.area, Variables::SymbolName(var.symbol));
+			}
+			break;
 		}
-	} else {
-		game->locals->SetAt(poi, value, NoCreate);
+		default:
+			assert(false && "unresolved variable");
 	}
 }
 
@@ -2221,54 +2249,46 @@ void SetPointVariable(Scriptable *Sender, const char *VarName, const Point &p, c
 
 ieDword CheckVariable(const Scriptable *Sender, const char *VarName, const char *Context, bool *valid)
 {
-	char newVarName[8];
-	const char *poi = VarName;
-	ieDword value = 0;
+	VariableRef var;
+	ResolveVariable(var, VarName, Context);
+	return CheckVariable(Sender, var, valid);
+}
 
-	if (Context == nullptr) {
-		strlcpy(newVarName, VarName, 7);
-		poi = &VarName[6];
-		//some HoW triggers use a : to separate the scope from the variable name
-		if (*poi==':') {
-			poi++;
-		}
-	} else {
-		strlcpy(newVarName, Context, 7);
-	}
-	
-	if (stricmp(newVarName, "MYAREA") == 0) {
-		Sender->GetCurrentArea()->locals->Lookup(poi, value);
-		ScriptDebugLog(ID_VARIABLES, "CheckVariable %s%s: %d", Context, VarName, value);
-		return value;
-	}
-	
-	if (stricmp( newVarName, "LOCALS" ) == 0) {
-		if (!Sender->locals->Lookup(poi, value)) {
-			*valid = false;
-		}
-		ScriptDebugLog(ID_VARIABLES, "CheckVariable %s%s: %d", Context, VarName, value);
-		return value;
-	}
-	
+ieDword CheckVariable(const Scriptable *Sender, const VariableRef& var, bool *valid)
+{
+	ieDword value = 0;
 	const Game *game = core->GetGame();
-	if (HasKaputz && !stricmp(newVarName,"KAPUTZ")) {
-		game->kaputz->Lookup(poi, value);
-		ScriptDebugLog(ID_VARIABLES, "CheckVariable %s%s: %d", Context, VarName, value);
-		return value;
-	}
-	
-	if (stricmp(newVarName,"GLOBAL") ) {
-		Map *map=game->GetMap(game->FindMap(newVarName));
-		if (map) {
-			map->locals->Lookup(poi, value);
-		} else {
-			*valid = false;
-			ScriptDebugLog(ID_VARIABLES, "Invalid variable %s %s in checkvariable", Context, VarName);
+	switch (var.scope) {
+		case VariableRef::MYAREA:
+			Sender->GetCurrentArea()->locals->Lookup(var.symbol, value);
+			break;
+		case VariableRef::LOCALS:
+			if (!Sender->locals->Lookup(var.symbol, value) && valid) {
+				*valid = false;
+			}
+			break;
+		case VariableRef::KAPUTZ:
+			game->kaputz->Lookup(var.symbol, value);
+			break;
+		case VariableRef::GLOBAL:
+			game->locals->Lookup(var.symbol, value);
+			break;
+		case VariableRef::AREA: {
+			const Map *map = game->GetMap(game->FindMap(var.area));
+			if (map) {
+				map->locals->Lookup(var.symbol, value);
+			} else {
+				if (valid) {
+					*valid = false;
+				}
+				ScriptDebugLog(ID_VARIABLES, "Invalid variable %s %s in checkvariable", var.area, Variables::SymbolName(var.symbol));
+			}
+			break;
 		}
-	} else {
-		game->locals->Lookup(poi, value);
+		default:
+			assert(false && "unresolved variable");
 	}
-	ScriptDebugLog(ID_VARIABLES, "CheckVariable %s%s: %d", Context, VarName, value);
+	ScriptDebugLog(ID_VARIABLES, "CheckVariable %s: %d", Variables::SymbolName(var.symbol), value);
 	return value;
 }
 
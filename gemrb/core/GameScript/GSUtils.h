@@ -116,7 +116,9 @@ GEM_EXPORT SrcVector *LoadSrc(const ieResRef resname);
 bool IsInObjectRect(const Point &pos, const Region &rect);
 Action *ParamCopy(Action *parameters);
 Action *ParamCopyNoOverride(Action *parameters);
+GEM_EXPORT void ResolveVariable(VariableRef& var, const char* VarName, const char* Context = nullptr);
 GEM_EXPORT void SetVariable(Scriptable* Sender, const char* VarName, ieDword value, const char* Context = nullptr);
+GEM_EXPORT void SetVariable(Scriptable* Sender, const VariableRef& var, ieDword value);
 GEM_EXPORT void SetPointVariable(Scriptable* Sender, const char* VarName, const Point &point, const char* Context = nullptr);
 Point GetEntryPoint(const char *areaname, const char *entryname);
 //these are used from other plugins
@@ -127,6 +129,7 @@ GEM_EXPORT void DisplayStringCore(Scriptable* const Sender, int Strref, int flag
 bool CreateMovementEffect(Actor* actor, const char *area, const Point &position, int face);
 GEM_EXPORT void MoveBetweenAreasCore(Actor* actor, const char *area, const Point &position, int face, bool adjust);
 GEM_EXPORT ieDword CheckVariable(const Scriptable *Sender, const char *VarName, const char *Context = nullptr, bool *valid = nullptr);
+GEM_EXPORT ieDword CheckVariable(const Scriptable *Sender, const VariableRef& var, bool *valid = nullptr);
 GEM_EXPORT Point CheckPointVariable(const Scriptable *Sender, const char *VarName, const char *Context = nullptr, bool *valid = nullptr);
 GEM_EXPORT bool VariableExists(Scriptable *Sender, const char *VarName, const char *Context);
 Action* GenerateActionCore(const char *src, const char *str, unsigned short actionID);
@@ -44,6 +44,7 @@
 #include "GameScript/GSUtils.h"
 #include "GameScript/Matching.h"
 
+#include "FrameProfiler.h"
 #include "Game.h"
 #include "GUI/GameControl.h" // just for DF_POSTPONE_SCRIPTS
 #include "GameData.h"
@@ -58,6 +59,8 @@
 #else
 #  include <cstdarg>
 #endif
+#include <list>
+#include <unordered_map>
 
 namespace GemRB {
 
@@ -1180,6 +1183,102 @@ static const IDSLink idsnames[] = {
 
 static int NextTriggerObjectID = 0;
 
+// Script names as GenerateTrigger and GenerateAction match them: lowercased
+// and cut after the opening bracket, mapped to their ids table row. Built once
+// in InitializeIEScript, so compiling text doesn't scan the tables.
+typedef std::unordered_map<std::string, int> ScriptNameIndex;
+static ScriptNameIndex triggerNameIndex;
+static ScriptNameIndex actionNameIndex;
+static ScriptNameIndex overrideActionNameIndex;
+
+// len includes the bracket, or the terminator if there is none (like FindString)
+static std::string ScriptNameKey(const char *name)
+{
+	std::string key(name, strlench(name, '(') + 1);
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	return key;
+}
+
+static void BuildScriptNameIndex(const Holder<SymbolMgr> &table, ScriptNameIndex &index)
+{
+	index.clear();
+	if (!table) return;
+	for (unsigned int i = 0; i < table->GetSize(); i++) {
+		// later rows win, as they did with the backwards FindString search
+		index[ScriptNameKey(table->GetStringIndex(i))] = i;
+	}
+}
+
+static int FindScriptName(const ScriptNameIndex &index, const char *name)
+{
+	auto it = index.find(ScriptNameKey(name));
+	if (it == index.end()) return -1;
+	return it->second;
+}
+
+// LRU of parsed script snippets keyed by their source text, so strings
+// that get executed over and over (dialog, cutscenes, the GUI) skip the
+// parser. The cache owns one reference to each template it holds.
+template<class T>
+class ParseCache {
+public:
+	explicit ParseCache(size_t size) : capacity(size) {}
+
+	T *Find(const std::string &text)
+	{
+		auto it = index.find(text);
+		if (it == index.end()) {
+			misses++;
+			return NULL;
+		}
+		hits++;
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->second;
+	}
+
+	void Add(const std::string &text, T *item)
+	{
+		entries.emplace_front(text, item);
+		index[text] = entries.begin();
+		if (entries.size() > capacity) {
+			index.erase(entries.back().first);
+			entries.back().second->Release();
+			entries.pop_back();
+		}
+	}
+
+	void Clear()
+	{
+		for (auto &entry : entries) {
+			entry.second->Release();
+		}
+		entries.clear();
+		index.clear();
+	}
+
+	unsigned long hits = 0;
+	unsigned long misses = 0;
+
+private:
+	typedef std::list<std::pair<std::string, T*> > EntryList;
+	size_t capacity;
+	EntryList entries;
+	std::unordered_map<std::string, typename EntryList::iterator> index;
+};
+
+static ParseCache<Action> actionCache(256);
+static ParseCache<Trigger> triggerCache(128);
+
+// only needed for messages, so resolved on demand
+static const char *GetTriggerName(unsigned short triggerID)
+{
+	const char *name = triggersTable->GetValue(triggerID);
+	if (!name) {
+		name = triggersTable->GetValue(triggerID | 0x4000);
+	}
+	return name;
+}
+
 static const TriggerLink* FindTrigger(const char* triggername)
 {
 	if (!triggername) {
@@ -1247,7 +1346,7 @@ static const IDSLink* FindIdentifier(const char* idsname)
 
 void ScriptDebugLog(int bit, const char *message, ...)
 {
-	if (!core->InDebugMode(bit)) return;
+	if (GEM_LOG_LEVEL < DEBUG || !core->InDebugMode(bit)) return;
 
 	va_list ap;
 	va_start(ap, message);
@@ -1391,6 +1490,13 @@ void Targets::FilterObjectRect(const Object *oC)
 /** releasing global memory */
 static void CleanupIEScript()
 {
+	LogDebug("GameScript", "Parsed action cache: %lu hits, %lu misses; parsed trigger cache: %lu hits, %lu misses",
+		actionCache.hits, actionCache.misses, triggerCache.hits, triggerCache.misses);
+	actionCache.Clear();
+	triggerCache.Clear();
+	triggerNameIndex.clear();
+	actionNameIndex.clear();
+	overrideActionNameIndex.clear();
 	triggersTable.release();
 	actionsTable.release();
 	objectsTable.release();
@@ -1475,6 +1581,9 @@ void InitializeIEScript()
 	if (!triggersTable || !actionsTable || !objectsTable || !objNameTable) {
 		error("GameScript", "A critical scripting file is damaged!\n");
 	}
+	BuildScriptNameIndex(triggersTable, triggerNameIndex);
+	BuildScriptNameIndex(actionsTable, actionNameIndex);
+	BuildScriptNameIndex(overrideActionsTable, overrideActionNameIndex);
 
 	/* Loading Script Configuration Parameters */
 
@@ -1541,7 +1650,7 @@ void InitializeIEScript()
 					buffer.appendFormatted("%s is a synonym of ",
 						triggersTable->GetStringIndex( j ) );
 					printFunction(buffer, triggersTable, triggersTable->FindValue(triggersTable->GetValueIndex(j)));
-					Log(DEBUG, "GameScript", buffer);
+					LogDebug("GameScript", buffer);
 				}
 			}
 			continue; //we already found an alternative
@@ -1609,7 +1718,7 @@ void InitializeIEScript()
 					buffer.appendFormatted("%s is a synonym of ",
 						actionsTable->GetStringIndex( j ) );
 					printFunction(buffer, actionsTable, actionsTable->FindValue(actionsTable->GetValueIndex(j)));
-					Log(DEBUG, "GameScript", buffer);
+					LogDebug("GameScript", buffer);
 				}
 			}
 			continue; //we already found an alternative
@@ -1755,7 +1864,7 @@ void InitializeIEScript()
 				buffer.appendFormatted("%s is a synonym of ",
 					objectsTable->GetStringIndex( j ) );
 				printFunction(buffer, objectsTable, objectsTable->FindValue(objectsTable->GetValueIndex(j)));
-				Log(DEBUG, "GameScript", buffer);
+				LogDebug("GameScript", buffer);
 			}
 			continue;
 		}
@@ -1960,7 +2069,7 @@ static Object* DecodeObject(const char* line)
 	// HACK for iwd2 AddExperiencePartyCR
 	if (!stricmp(oB->objectName, "0.0.0.0 ")) {
 		strlcpy(oB->objectName, "", sizeof(oB->objectName));
-		Log(DEBUG, "asda", "overriding: +%s+", oB->objectName);
+		LogDebug("asda", "overriding: +%s+", oB->objectName);
 	}
 	if (*line == '"')
 		line++; //Skip " (the same as above)
@@ -2301,17 +2410,22 @@ int GameScript::EvaluateString(Scriptable* Sender, char* String)
 	if (String[0] == 0) {
 		return 0;
 	}
-	Trigger* tri = GenerateTrigger( String );
-	if (tri) {
-		int ret = tri->Evaluate(Sender);
-		tri->Release();
-		return ret;
+	// GenerateTrigger lowercases the string, so grab the key first
+	std::string key = String;
+	Trigger* tri = triggerCache.Find(key);
+	if (!tri) {
+		tri = GenerateTrigger( String );
+		if (!tri) {
+			return 0;
+		}
+		triggerCache.Add(key, tri);
 	}
-	return 0;
+	return tri->Evaluate(Sender);
 }
 
 bool Condition::Evaluate(Scriptable *Sender) const
 {
+	FrameProfiler::Count(FrameProfiler::COUNT_SCRIPTS);
 	int ORcount = 0;
 	unsigned int result = 0;
 	bool subresult = true;
@@ -2364,17 +2478,15 @@ int Trigger::Evaluate(Scriptable *Sender) const
 		return 0;
 	}
 	TriggerFunction func = triggers[triggerID];
-	const char *tmpstr=triggersTable->GetValue(triggerID);
-	if (!tmpstr) {
-		tmpstr=triggersTable->GetValue(triggerID|0x4000);
-	}
 	if (!func) {
 		triggers[triggerID] = GameScript::False;
 		Log(WARNING, "GameScript", "Unhandled trigger code: 0x%04x %s",
-			triggerID, tmpstr );
+			triggerID, GetTriggerName(triggerID));
 		return 0;
 	}
-	ScriptDebugLog(ID_TRIGGERS, "Executing trigger code: 0x%04x %s", triggerID, tmpstr);
+	if (core->InDebugMode(ID_TRIGGERS)) {
+		ScriptDebugLog(ID_TRIGGERS, "Executing trigger code: 0x%04x %s", triggerID, GetTriggerName(triggerID));
+	}
 
 	int ret = func( Sender, this );
 	if (flags & TF_NEGATE) {
@@ -2547,7 +2659,7 @@ Trigger* GenerateTrigger(char* String)
 		negate = TF_NEGATE;
 	}
 	int len = strlench(String,'(')+1; //including (
-	int i = triggersTable->FindString(String, len);
+	int i = FindScriptName(triggerNameIndex, String);
 	if (i<0) {
 		Log(ERROR, "GameScript", "Invalid scripting trigger: %s", String);
 		return NULL;
@@ -2562,7 +2674,7 @@ Trigger* GenerateTrigger(char* String)
 	return trigger;
 }
 
-Action* GenerateAction(const char* String)
+static Action* ParseAction(const char* String)
 {
 	Action* action = NULL;
 	char* actionString = strdup(String);
@@ -2576,14 +2688,14 @@ Action* GenerateAction(const char* String)
 	char *str;
 	unsigned short actionID;
 	if (overrideActionsTable) {
-		i = overrideActionsTable->FindString(actionString, len);
+		i = FindScriptName(overrideActionNameIndex, actionString);
 		if (i >= 0) {
 			str = overrideActionsTable->GetStringIndex( i )+len;
 			actionID = overrideActionsTable->GetValueIndex(i);
 		}
 	}
 	if (i<0) {
-		i = actionsTable->FindString(actionString, len);
+		i = FindScriptName(actionNameIndex, actionString);
 		if (i < 0) {
 			Log(ERROR, "GameScript", "Invalid scripting action: %s", String);
 			goto done;
@@ -2600,6 +2712,21 @@ Action* GenerateAction(const char* String)
 	return action;
 }
 
+// hands out a private copy of the cached template, as callers modify and queue it
+Action* GenerateAction(const char* String)
+{
+	Action *action = actionCache.Find(String);
+	if (!action) {
+		action = ParseAction(String);
+		if (!action) {
+			return NULL;
+		}
+		action->IncRef();
+		actionCache.Add(String, action);
+	}
+	return ParamCopy(action);
+}
+
 Action *GenerateActionDirect(const char *String, const Scriptable *object)
 {
 	Action* action = GenerateAction(String);
@@ -2655,6 +2782,15 @@ bool Object::isNull() const
 	return true;
 }
 
+const VariableRef& Trigger::Variable(int idx, const char* context) const
+{
+	VariableRef& var = variables[idx];
+	if (var.scope == VariableRef::UNRESOLVED) {
+		ResolveVariable(var, idx ? string1Parameter : string0Parameter, context);
+	}
+	return var;
+}
+
 void Trigger::dump() const
 {
 	StringBuffer buffer;
@@ -2678,6 +2814,15 @@ void Trigger::dump(StringBuffer& buffer) const
 	buffer.appendFormatted("\n");
 }
 
+const VariableRef& Action::Variable(int idx, const char* context) const
+{
+	VariableRef& var = variables[idx];
+	if (var.scope == VariableRef::UNRESOLVED) {
+		ResolveVariable(var, idx ? string1Parameter : string0Parameter, context);
+	}
+	return var;
+}
+
 void Action::dump() const
 {
 	StringBuffer buffer;
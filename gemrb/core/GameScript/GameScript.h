@@ -223,6 +223,17 @@ public:
 	bool isNull() const;
 };
 
+// A script variable with its scope decoded and its name interned,
+// so checking it doesn't need any string handling, see ResolveVariable
+struct VariableRef {
+	enum Scope : unsigned char {
+		UNRESOLVED, GLOBAL, LOCALS, MYAREA, KAPUTZ, AREA
+	};
+	Scope scope = UNRESOLVED;
+	ieDword symbol = 0;
+	char area[7] = {}; // the area script name for AREA
+};
+
 class GEM_EXPORT Trigger : protected Canary {
 public:
 	Trigger()
@@ -256,6 +267,8 @@ public:
 	char string1Parameter[65];
 	Object* objectParameter;
 
+	// string0Parameter or string1Parameter as a variable, resolved on first use
+	const VariableRef& Variable(int idx, const char* context = nullptr) const;
 	void dump() const;
 	void dump(StringBuffer&) const;
 
@@ -263,10 +276,17 @@ public:
 	{
 		delete this;
 	}
+
+private:
+	mutable VariableRef variables[2];
 };
 
 class GEM_EXPORT Condition : protected Canary {
 public:
+	Condition()
+	{
+		RefCount = 1; //one reference held by the creator
+	}
 	~Condition()
 	{
 		for (size_t c = 0; c < triggers.size(); ++c) {
@@ -276,13 +296,24 @@ public:
 			}
 		}
 	}
+	//evaluation doesn't modify the triggers, so conditions can be shared
+	void IncRef()
+	{
+		AssertCanary(__FUNCTION__);
+		RefCount++;
+	}
 	void Release()
 	{
-		delete this;
+		AssertCanary(__FUNCTION__);
+		if (!--RefCount) {
+			delete this;
+		}
 	}
 	bool Evaluate(Scriptable *Sender) const;
 
 	std::vector<Trigger*> triggers;
+private:
+	int RefCount;
 };
 
 class GEM_EXPORT Action : protected Canary {
@@ -328,11 +359,14 @@ public:
 	unsigned short flags;
 private:
 	int RefCount;
+	mutable VariableRef variables[2];
 public:
 	int GetRef() {
 		return RefCount;
 	}
 
+	// string0Parameter or string1Parameter as a variable, resolved on first use
+	const VariableRef& Variable(int idx, const char* context = nullptr) const;
 	void dump() const;
 	void dump(StringBuffer&) const;
 
@@ -172,29 +172,16 @@ static Targets *EvaluateObject(const Map *map, const Scriptable *Sender, const O
 
 	if (oC->objectFields[0]==-1) {
 		// this is an internal hack, allowing us to pass actor ids around as objects
-		Actor* aC = map->GetActorByGlobalID( (ieDword) oC->objectFields[1] );
+		ieDword globalID = (ieDword) oC->objectFields[1];
+		Actor *aC = map->GetActorByGlobalID(globalID);
 		if (aC) {
 			if (!aC->ValidTarget(ga_flags)) {
 				return NULL;
 			}
 			return ReturnScriptableAsTarget(aC);
 		}
-		Door *door = map->GetDoorByGlobalID( (ieDword) oC->objectFields[1]);
-		if (door) {
-			return ReturnScriptableAsTarget(door);
-		}
-
-		Container* cont = map->GetContainerByGlobalID((ieDword) oC->objectFields[1]);
-		if (cont) {
-			return ReturnScriptableAsTarget(cont);
-		}
-
-		InfoPoint* trap = map->GetInfoPointByGlobalID((ieDword) oC->objectFields[1]);
-		if (trap) {
-			return ReturnScriptableAsTarget(trap);
-		}
-
-		return NULL;
+		// doors, containers and infopoints
+		return ReturnScriptableAsTarget(map->GetTileMap()->GetScriptableByGlobalID(globalID));
 	}
 
 	Targets *tgts = NULL;
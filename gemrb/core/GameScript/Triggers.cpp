@@ -506,7 +506,7 @@ int GameScript::BitCheck(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid && value & parameters->int0Parameter) return 1;
 	return 0;
 }
@@ -515,7 +515,7 @@ int GameScript::BitCheckExact(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
 		ieDword tmp = (ieDword) parameters->int0Parameter ;
 		if ((value & tmp) == tmp) return 1;
@@ -529,7 +529,7 @@ int GameScript::BitGlobal_Trigger(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
 		HandleBitMod(value, parameters->int0Parameter, parameters->int1Parameter);
 		if (value!=0) return 1;
@@ -541,10 +541,10 @@ int GameScript::GlobalOrGlobal_Trigger(Scriptable *Sender, const Trigger *parame
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
 		if (value1) return 1;
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid && value2) return 1;
 	}
 	return 0;
@@ -554,9 +554,9 @@ int GameScript::GlobalAndGlobal_Trigger(Scriptable *Sender, const Trigger *param
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid && value1) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid && value2) return 1;
 	}
 	return 0;
@@ -566,9 +566,9 @@ int GameScript::GlobalBAndGlobal_Trigger(Scriptable *Sender, const Trigger *para
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid && (value1 & value2) != 0) return 1;
 	}
 	return 0;
@@ -578,9 +578,9 @@ int GameScript::GlobalBAndGlobalExact(Scriptable *Sender, const Trigger *paramet
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid && (value1 & value2) == value2) return 1;
 	}
 	return 0;
@@ -590,9 +590,9 @@ int GameScript::GlobalBitGlobal_Trigger(Scriptable *Sender, const Trigger *param
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid) {
 			HandleBitMod( value1, value2, parameters->int1Parameter);
 			if (value1!=0) return 1;
@@ -605,7 +605,7 @@ int GameScript::GlobalBitGlobal_Trigger(Scriptable *Sender, const Trigger *param
 //i just assume it sets a global in the trigger block
 int GameScript::TriggerSetGlobal(Scriptable *Sender, const Trigger *parameters)
 {
-	SetVariable( Sender, parameters->string0Parameter, parameters->int0Parameter );
+	SetVariable( Sender, parameters->Variable(0), parameters->int0Parameter );
 	return 1;
 }
 
@@ -614,7 +614,7 @@ int GameScript::Xor(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid && (value ^ parameters->int0Parameter) != 0) return 1;
 	return 0;
 }
@@ -626,7 +626,7 @@ int GameScript::NumDead(Scriptable *Sender, const Trigger *parameters)
 	ieDword value;
 
 	if (core->HasFeature(GF_HAS_KAPUTZ) ) {
-		value = CheckVariable(Sender, parameters->string0Parameter, "KAPUTZ");
+		value = CheckVariable(Sender, parameters->Variable(0, "KAPUTZ"));
 	} else {
 		ieVariable VariableName;
 		snprintf(VariableName, 32, core->GetDeathVarFormat(), parameters->string0Parameter);
@@ -640,7 +640,7 @@ int GameScript::NumDeadGT(Scriptable *Sender, const Trigger *parameters)
 	ieDword value;
 
 	if (core->HasFeature(GF_HAS_KAPUTZ) ) {
-		value = CheckVariable(Sender, parameters->string0Parameter, "KAPUTZ");
+		value = CheckVariable(Sender, parameters->Variable(0, "KAPUTZ"));
 	} else {
 		ieVariable VariableName;
 		snprintf(VariableName, 32, core->GetDeathVarFormat(), parameters->string0Parameter);
@@ -654,7 +654,7 @@ int GameScript::NumDeadLT(Scriptable *Sender, const Trigger *parameters)
 	ieDword value;
 
 	if (core->HasFeature(GF_HAS_KAPUTZ) ) {
-		value = CheckVariable(Sender, parameters->string0Parameter, "KAPUTZ");
+		value = CheckVariable(Sender, parameters->Variable(0, "KAPUTZ"));
 	} else {
 		ieVariable VariableName;
 
@@ -666,7 +666,7 @@ int GameScript::NumDeadLT(Scriptable *Sender, const Trigger *parameters)
 
 int GameScript::G_Trigger(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, "GLOBAL" );
+	ieDwordSigned value = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
 	return ( value == parameters->int0Parameter );
 }
 
@@ -674,7 +674,7 @@ int GameScript::Global(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDwordSigned value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
 		if ( value == parameters->int0Parameter ) return 1;
 	}
@@ -683,7 +683,7 @@ int GameScript::Global(Scriptable *Sender, const Trigger *parameters)
 
 int GameScript::GLT_Trigger(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter,"GLOBAL" );
+	ieDwordSigned value = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
 	return ( value < parameters->int0Parameter );
 }
 
@@ -691,14 +691,14 @@ int GameScript::GlobalLT(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDwordSigned value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid && value < parameters->int0Parameter) return 1;
 	return 0;
 }
 
 int GameScript::GGT_Trigger(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, "GLOBAL" );
+	ieDwordSigned value = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
 	return ( value > parameters->int0Parameter );
 }
 
@@ -706,7 +706,7 @@ int GameScript::GlobalGT(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDwordSigned value = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid && value > parameters->int0Parameter) return 1;
 	return 0;
 }
@@ -715,9 +715,9 @@ int GameScript::GlobalLTGlobal(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDwordSigned value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
-		ieDwordSigned value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDwordSigned value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid && value1 < value2) return 1;
 	}
 	return 0;
@@ -727,9 +727,9 @@ int GameScript::GlobalGTGlobal(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value1 = CheckVariable(Sender, parameters->string0Parameter, nullptr, &valid);
+	ieDwordSigned value1 = CheckVariable(Sender, parameters->Variable(0), &valid);
 	if (valid) {
-		ieDwordSigned value2 = CheckVariable(Sender, parameters->string1Parameter, nullptr, &valid);
+		ieDwordSigned value2 = CheckVariable(Sender, parameters->Variable(1), &valid);
 		if (valid && value1 > value2) return 1;
 	}
 	return 0;
@@ -737,43 +737,43 @@ int GameScript::GlobalGTGlobal(Scriptable *Sender, const Trigger *parameters)
 
 int GameScript::GlobalsEqual(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, "GLOBAL" );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, "GLOBAL" );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "GLOBAL"));
 	return ( value1 == value2 );
 }
 
 int GameScript::GlobalsGT(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, "GLOBAL" );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, "GLOBAL" );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "GLOBAL"));
 	return ( value1 > value2 );
 }
 
 int GameScript::GlobalsLT(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, "GLOBAL" );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, "GLOBAL" );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "GLOBAL"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "GLOBAL"));
 	return ( value1 < value2 );
 }
 
 int GameScript::LocalsEqual(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, "LOCALS" );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, "LOCALS" );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "LOCALS"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "LOCALS"));
 	return ( value1 == value2 );
 }
 
 int GameScript::LocalsGT(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, "LOCALS" );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, "LOCALS" );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "LOCALS"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "LOCALS"));
 	return ( value1 > value2 );
 }
 
 int GameScript::LocalsLT(Scriptable *Sender, const Trigger *parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, "LOCALS" );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, "LOCALS" );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, "LOCALS"));
+	ieDword value2 = CheckVariable(Sender, parameters->Variable(1, "LOCALS"));
 	return ( value1 < value2 );
 }
 
@@ -781,7 +781,7 @@ int GameScript::RealGlobalTimerExact(Scriptable *Sender, const Trigger *paramete
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter, &valid );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter), &valid);
 	if (valid && value1) {
 		ieDword value2 = core->GetGame()->RealTime;
 		if ( value1 == value2 ) return 1;
@@ -793,7 +793,7 @@ int GameScript::RealGlobalTimerExpired(Scriptable *Sender, const Trigger *parame
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter, &valid );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter), &valid);
 	if (valid && value1 && value1 < core->GetGame()->RealTime) return 1;
 	return 0;
 }
@@ -802,7 +802,7 @@ int GameScript::RealGlobalTimerNotExpired(Scriptable *Sender, const Trigger *par
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter, &valid );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter), &valid);
 	if (valid && value1 && value1 > core->GetGame()->RealTime) return 1;
 	return 0;
 }
@@ -811,7 +811,7 @@ int GameScript::GlobalTimerExact(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter, &valid );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter), &valid);
 	if (valid && value1 == core->GetGame()->GameTime) return 1;
 	return 0;
 }
@@ -820,7 +820,7 @@ int GameScript::GlobalTimerExpired(Scriptable *Sender, const Trigger *parameters
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter, &valid );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter), &valid);
 	if (valid && (core->HasFeature(GF_ZERO_TIMER_IS_VALID) || value1)) {
 		if ( value1 < core->GetGame()->GameTime ) return 1;
 	}
@@ -832,7 +832,7 @@ int GameScript::GlobalTimerNotExpired(Scriptable *Sender, const Trigger *paramet
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, parameters->string1Parameter, &valid );
+	ieDword value1 = CheckVariable(Sender, parameters->Variable(0, parameters->string1Parameter), &valid);
 	if (valid && value1 && value1 > core->GetGame()->GameTime) return 1;
 	return 0;
 }
@@ -3739,7 +3739,7 @@ int GameScript::StuffGlobalRandom( Scriptable *Sender, const Trigger *parameters
 	} else {
 		Value = RandomNumValue;
 	}
-	SetVariable( Sender, parameters->string0Parameter, Value );
+	SetVariable( Sender, parameters->Variable(0), Value );
 	if (Value) {
 		return 1;
 	}
@@ -4175,7 +4175,7 @@ int GameScript::SystemVariable_Trigger(Scriptable *Sender, const Trigger *parame
 		return 0;
 	}
 
-	SetVariable(Sender, parameters->string0Parameter, value);
+	SetVariable(Sender, parameters->Variable(0), value);
 	return 1;
 }
 
@@ -43,11 +43,19 @@ GlobalTimer::~GlobalTimer(void)
 	}
 }
 
+tick_t GlobalTimer::CurrentTime() const
+{
+	if (fixedStep) {
+		return startTime + interval;
+	}
+	return GetTicks();
+}
+
 void GlobalTimer::Freeze()
 {
 	UpdateAnimations(true);
 
-	tick_t thisTime = GetTicks();
+	tick_t thisTime = CurrentTime();
 	if (UpdateViewport(thisTime) == false) {
 		return;
 	}
@@ -147,7 +155,7 @@ bool GlobalTimer::Update()
 	Map *map;
 	Game *game;
 	GameControl* gc;
-	tick_t thisTime = GetTicks();
+	tick_t thisTime = CurrentTime();
 
 	UpdateAnimations(false);
 
@@ -42,6 +42,8 @@ class GEM_EXPORT GlobalTimer {
 private:
 	tick_t startTime = 0; //forcing an update;
 	tick_t interval;
+	// advance exactly one interval per update instead of following the wall clock
+	bool fixedStep = false;
 
 	tick_t fadeToCounter = 0, fadeToMax = 0;
 	tick_t fadeFromCounter = 0, fadeFromMax = 0;
@@ -75,9 +77,11 @@ public:
 	void AddAnimation(ControlAnimation* ctlanim, tick_t time);
 	void RemoveAnimation(ControlAnimation* ctlanim);
 	void ClearAnimations();
+	void SetFixedStep(bool fixed) { fixedStep = fixed; }
 
 private:
 	bool UpdateViewport(tick_t time);
+	tick_t CurrentTime() const;
 };
 
 }
@@ -39,7 +39,7 @@ public:
 	void acquire() { ++RefCount; }
 	void release() { assert(RefCount && "Broken Held usage.");
 		if (!--RefCount) delete static_cast<T*>(this); }
-	size_t GetRefCount() { return RefCount; }
+	size_t GetRefCount() const { return RefCount; }
 private:
 	size_t RefCount;
 };
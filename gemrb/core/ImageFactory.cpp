@@ -30,4 +30,15 @@ ImageFactory::ImageFactory(const char* ResRef, Holder<Sprite2D> bitmap_)
 
 }
 
+size_t ImageFactory::GetMemorySize() const
+{
+	if (!bitmap) return 0;
+	return bitmap->Frame.w * bitmap->Frame.h * (bitmap->Bpp / 8);
+}
+
+bool ImageFactory::InUse() const
+{
+	return bitmap && bitmap->GetRefCount() > 1;
+}
+
 }
@@ -36,6 +36,8 @@ public:
 	ImageFactory(const char* ResRef, Holder<Sprite2D> bitmap);
 
 	Holder<Sprite2D> GetSprite2D() const { return bitmap; }
+	size_t GetMemorySize() const override;
+	bool InUse() const override;
 };
 
 }
@@ -32,12 +32,12 @@
 #include "Calendar.h"
 #include "DataFileMgr.h"
 #include "DialogHandler.h"
-#include "DialogMgr.h"
 #include "DisplayMessage.h"
 #include "EffectMgr.h"
 #include "EffectQueue.h"
 #include "Factory.h"
 #include "FontManager.h"
+#include "FrameProfiler.h"
 #include "Game.h"
 #include "GameScript/GameScript.h"
 #include "ItemMgr.h"
@@ -239,6 +239,7 @@ Interface::Interface()
 	MagicBit = HasFeature(GF_MAGICBIT);
 	VersionOverride = ItemTypes = SlotTypes = 0;
 	MultipleQuickSaves = false;
+	SaveCompressionLevel = 9;
 	MaxPartySize = 6;
 	FeedbackLevel = 0;
 	CutSceneRunner = NULL;
@@ -296,6 +297,9 @@ void Interface::FreeResRefTable(ieResRef *&table, int &count)
 
 Interface::~Interface(void)
 {
+	// writes out the samples gathered since the last flush
+	FrameProfiler::SetMode(0);
+
 	WindowManager::CursorMouseUp = NULL;
 	WindowManager::CursorMouseDown = NULL;
 
@@ -887,6 +891,12 @@ char *Interface::GetMusicPlaylist(int SongType) const {
 /** this is the main loop */
 void Interface::Main()
 {
+	if (BenchmarkTicks > 0) {
+		RunBenchmark();
+		QuitGame(0);
+		return;
+	}
+
 	ieDword speed = 10;
 
 	vars->Lookup("Mouse Scroll Speed", speed);
@@ -906,6 +916,9 @@ void Interface::Main()
 	double frames = 0.0;
 
 	do {
+		// the previous sample ends with its SwapBuffers
+		FrameProfiler::EndFrame();
+
 		std::deque<Timer>::iterator it;
 		for (it = timers.begin(); it != timers.end();) {
 			if (it->IsRunning()) {
@@ -930,7 +943,11 @@ void Interface::Main()
 		// TODO: find other animations that need to be synchronized
 		// we can create a manager for them and everything can be updated at once
 		GlobalColorCycle.AdvanceTime(time);
+		FrameProfiler::Scope drawPhase(FrameProfiler::PHASE_DRAWWINDOWS);
 		winmgr->DrawWindows();
+		drawPhase.Stop();
+		// nothing holds raw factory pointers between frames
+		gamedata->TrimFactoryCache();
 		time = GetTicks();
 		if (DrawFPS) {
 			frame++;
@@ -944,10 +961,73 @@ void Interface::Main()
 			video->DrawRect( fpsRgn, ColorBlack );
 			fps->Print(fpsRgn, String(fpsstring), IE_FONT_ALIGN_MIDDLE | IE_FONT_SINGLE_LINE, {ColorWhite, ColorBlack});
 		}
+		if (FrameProfiler::GetMode() & FrameProfiler::OVERLAY) {
+			auto lock = winmgr->DrawHUD();
+			Region profileRgn(fpsRgn.x, fpsRgn.y + fpsRgn.h, 200, fps->LineHeight * (FrameProfiler::PHASE_COUNT + FrameProfiler::COUNTER_COUNT));
+			video->DrawRect(profileRgn, ColorBlack);
+			fps->Print(profileRgn, FrameProfiler::Report(), IE_FONT_ALIGN_LEFT | IE_FONT_ALIGN_TOP, {ColorWhite, ColorBlack});
+		}
 	} while (video->SwapBuffers() == GEM_OK && !(QuitFlag&QF_KILL));
 	QuitGame(0);
 }
 
+void Interface::RunBenchmark()
+{
+	Holder<SaveGame> save;
+	if (!BenchmarkSave.empty()) {
+		save = GetSaveGameIterator()->GetSaveGame(BenchmarkSave.c_str());
+		if (!save) {
+			Log(ERROR, "Benchmark", "Cannot find save game %s.", BenchmarkSave.c_str());
+			return;
+		}
+	}
+	// an empty holder starts a new game
+	SetupLoadGame(save, 0);
+	QuitFlag |= QF_ENTERGAME;
+	HandleFlags();
+	if (!game) {
+		Log(ERROR, "Benchmark", "Could not load the game.");
+		return;
+	}
+	if (!BenchmarkArea.empty() && !game->GetMap(BenchmarkArea.c_str(), true)) {
+		Log(ERROR, "Benchmark", "Cannot load area %s.", BenchmarkArea.c_str());
+		return;
+	}
+	if (!game->GetCurrentArea()) {
+		Log(ERROR, "Benchmark", "No area to run, set BenchmarkArea.");
+		return;
+	}
+
+	// restart both, so loading does not skew the numbers
+	timer.SetFixedStep(true);
+	FrameProfiler::SetMode(FrameProfiler::GetMode() | FrameProfiler::OVERLAY);
+
+	Log(MESSAGE, "Benchmark", "Running %d ticks in %s...", BenchmarkTicks, game->CurrentArea);
+	tick_t start = GetTicks();
+	int ticks = 0;
+	for (; ticks < BenchmarkTicks; ticks++) {
+		while (QuitFlag && QuitFlag != QF_KILL) {
+			HandleFlags();
+		}
+		if (!game || (QuitFlag & QF_KILL)) {
+			Log(WARNING, "Benchmark", "The game ended after %d ticks.", ticks);
+			break;
+		}
+		HandleGUIBehaviour();
+		GameLoop();
+		gamedata->TrimFactoryCache();
+		FrameProfiler::EndFrame();
+	}
+	tick_t elapsed = std::max<tick_t>(GetTicks() - start, 1);
+
+	Log(MESSAGE, "Benchmark", "%d ticks in %.3f s, %.1f ticks/s", ticks, elapsed / 1000.0, ticks * 1000.0 / elapsed);
+	char* report = MBCStringFromString(FrameProfiler::Report(true));
+	if (report) {
+		Log(MESSAGE, "Benchmark", "Average per tick:\n%s", report);
+		free(report);
+	}
+}
+
 int Interface::ReadResRefTable(const ieResRef tablename, ieResRef *&data)
 {
 	int count = 0;
@@ -1119,12 +1199,15 @@ int Interface::Init(InterfaceConfig* config)
 			var ( atoi( value ) ); \
 		value = nullptr
 
+	CONFIG_INT("BenchmarkTicks", BenchmarkTicks =);
 	CONFIG_INT("Bpp", Bpp =);
 	CONFIG_INT("CaseSensitive", CaseSensitive =);
 	CONFIG_INT("DoubleClickDelay", EventMgr::DCDelay = );
 	CONFIG_INT("DrawFPS", DrawFPS = );
 	CONFIG_INT("EnableCheatKeys", EnableCheatKeys);
 	CONFIG_INT("EndianSwitch", DataStream::SetBigEndian);
+	CONFIG_INT("FactoryCacheSize", gamedata->SetFactoryCacheSize);
+	CONFIG_INT("FrameProfile", FrameProfiler::SetMode);
 	CONFIG_INT("GCDebug", GameControl::DebugFlags = );
 	CONFIG_INT("Height", Height = );
 	CONFIG_INT("KeepCache", KeepCache = );
@@ -1133,8 +1216,11 @@ int Interface::Init(InterfaceConfig* config)
 	vars->SetAt("MaxPartySize", MaxPartySize); // for simple GUIScript access
 	CONFIG_INT("MouseFeedback", MouseFeedback = );
 	CONFIG_INT("MultipleQuickSaves", MultipleQuickSaves = );
+	CONFIG_INT("PrefetchCacheSize", ResourceManager::SetPrefetchSize);
 	CONFIG_INT("RepeatKeyDelay", Control::ActionRepeatDelay = );
+	CONFIG_INT("RNGSeed", RNG::getInstance().Seed);
 	CONFIG_INT("SaveAsOriginal", SaveAsOriginal = );
+	CONFIG_INT("SaveCompressionLevel", SaveCompressionLevel = );
 	CONFIG_INT("DebugMode", debugMode = );
 	int touchInput = -1;
 	CONFIG_INT("TouchInput", touchInput =);
@@ -1280,6 +1366,8 @@ int Interface::Init(InterfaceConfig* config)
 		value = nullptr
 
 	CONFIG_STRING("AudioDriver", AudioDriverName);
+	CONFIG_STRING("BenchmarkArea", BenchmarkArea);
+	CONFIG_STRING("BenchmarkSave", BenchmarkSave);
 	CONFIG_STRING("VideoDriver", VideoDriverName);
 	CONFIG_STRING("Encoding", Encoding);
 #undef CONFIG_STRING
@@ -1337,6 +1425,10 @@ int Interface::Init(InterfaceConfig* config)
 	// potentially disable logging before plugins are loaded (the log file is a plugin)
 	value = config->GetValueForKey("Logging");
 	if (value) ToggleLogging(atoi(value));
+	value = config->GetValueForKey("LogLevel");
+	if (value) SetLogLevel(log_level(std::min(std::max(atoi(value), int(FATAL)), int(DEBUG))));
+	value = config->GetValueForKey("LogOwnerLevels");
+	if (value) SetOwnerLogLevels(value);
 
 	Log(MESSAGE, "Core", "Starting Plugin Manager...");
 	PluginMgr *plugin = PluginMgr::Get();
@@ -2559,6 +2651,7 @@ bool Interface::IsFreezed()
 
 void Interface::GameLoop(void)
 {
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_GAMELOOP);
 	update_scripts = false;
 	GameControl *gc = GetGameControl();
 	if (gc) {
@@ -4159,9 +4252,7 @@ int Interface::GetMouseScrollSpeed() {
 
 ieStrRef Interface::GetRumour(const ieResRef dlgref)
 {
-	PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
-	dm->Open(gamedata->GetResource(dlgref, IE_DLG_CLASS_ID));
-	Dialog *dlg = dm->GetDialog();
+	Holder<Dialog> dlg = gamedata->GetDialog(dlgref);
 
 	if (!dlg) {
 		Log(ERROR, "Interface", "Cannot load dialog: %s", dlgref);
@@ -4177,7 +4268,6 @@ ieStrRef Interface::GetRumour(const ieResRef dlgref)
 	if (i>=0 ) {
 		ret = dlg->GetState( i )->StrRef;
 	}
-	delete dlg;
 	return ret;
 }
 
@@ -4357,7 +4447,7 @@ int Interface::SwapoutArea(Map *map)
 {
 	//refuse to save ambush areas, for example
 	if (map->AreaFlags & AF_NOSAVE) {
-		Log(DEBUG, "Core", "Not saving area %s",
+		LogDebug("Core", "Not saving area %s",
 			map->GetScriptName());
 		RemoveFromCache(map->GetScriptName(), IE_ARE_CLASS_ID);
 		return 0;
@@ -4507,6 +4597,7 @@ int Interface::CompressSave(const char *folder)
 
 	dir.SetFlags(DirectoryIterator::Files);
 	//.tot and .toh should be saved last, because they are updated when an .are is saved
+	std::vector<std::string> files;
 	int priority=2;
 	while(priority) {
 		do {
@@ -4514,11 +4605,7 @@ int Interface::CompressSave(const char *folder)
 			if (SavedExtension(name)==priority) {
 				char dtmp[_MAX_PATH];
 				dir.GetFullPath(dtmp);
-				FileStream fs;
-				if (!fs.Open(dtmp)) {
-					Log(ERROR, "Interface", "Failed to open \"%s\".", dtmp);
-				}
-				ai->AddToSaveGame(&str, &fs);
+				files.emplace_back(dtmp);
 			}
 		} while (++dir);
 		//reopen list for the second round
@@ -4527,6 +4614,9 @@ int Interface::CompressSave(const char *folder)
 			dir.Rewind();
 		}
 	}
+	if (ai->AddToSaveGame(&str, files, SaveCompressionLevel) != GEM_OK) {
+		return -1;
+	}
 	return 0;
 }
 
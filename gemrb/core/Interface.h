@@ -320,7 +320,8 @@ enum DebugModeBits {
 	ID_VIEWS = 32,
 	ID_WINDOWS = 64,
 	ID_FONTS = 128,
-	ID_TEXT = 256
+	ID_TEXT = 256,
+	ID_EFFECTS = 512
 };
 
 template<int SIZE>
@@ -353,6 +354,10 @@ private:
 
 	std::string VideoDriverName;
 	std::string AudioDriverName;
+	// headless benchmark: ticks to run, save to load (or a new game) and area to switch to
+	int BenchmarkTicks = 0;
+	std::string BenchmarkSave;
+	std::string BenchmarkArea;
 	ProjectileServer * projserv;
 
 	WindowManager* winmgr;
@@ -769,6 +774,8 @@ private:
 	GameControl* StartGameControl();
 	/** Executes everything (non graphical) in the main game loop */
 	void GameLoop(void);
+	/** Runs the game logic for BenchmarkTicks fixed steps as fast as possible */
+	void RunBenchmark();
 	/** the internal (without cache) part of GetListFrom2DA */
 	ieDword *GetListFrom2DAInternal(const ieResRef resref);
 
@@ -807,6 +814,7 @@ public:
 	int MaxPartySize;
 	bool KeepCache;
 	bool MultipleQuickSaves;
+	int SaveCompressionLevel;
 	bool UseCorruptedHack;
 	int FeedbackLevel;
 
@@ -1197,6 +1197,8 @@ int Inventory::GetEquippedSlot() const
 bool Inventory::SetEquippedSlot(ieWordSigned slotcode, ieWord header, bool noFX)
 {
 	EquippedHeader = header;
+	// the weapon proficiency bonuses depend on it
+	Owner->SetEffectsDirty();
 	
 	//doesn't work if magic slot is used, refresh the magic slot just in case
 	if (MagicSlotEquipped() && (slotcode!=SLOT_MAGIC-SLOT_MELEE)) {
@@ -1838,7 +1840,7 @@ int Inventory::FindStealableItem()
 	unsigned int start = core->Roll(1, slotcnt, -1);
 	int inc = start & 1 ? 1 : -1;
 
-	Log(DEBUG, "Inventory", "Start Slot: %d, increment: %d", start, inc);
+	LogDebug("Inventory", "Start Slot: %d, increment: %d", start, inc);
 	for (unsigned int i = 0; i < slotcnt; ++i) {
 		int slot = (slotcnt - 1 + start + i * inc) % slotcnt;
 		CREItem *item = Slots[slot];
@@ -26,6 +26,7 @@
 #include "AmbientMgr.h"
 #include "Audio.h"
 #include "DisplayMessage.h"
+#include "FrameProfiler.h"
 #include "Game.h"
 #include "GameData.h"
 #include "IniSpawn.h"
@@ -38,6 +39,7 @@
 #include "PluginMgr.h"
 #include "Projectile.h"
 #include "SaveGameIterator.h"
+#include "StringMgr.h"
 #include "ScriptedAnimation.h"
 #include "TileMap.h"
 #include "VEFObject.h"
@@ -57,6 +59,7 @@
 #include <cmath>
 #include <cassert>
 #include <limits>
+#include <set>
 
 namespace GemRB {
 
@@ -67,6 +70,8 @@ static ieResRef PortalResRef={"EF03TPR3"};
 static unsigned int PortalTime = 15;
 static unsigned int MAX_CIRCLESIZE = 8;
 static int MaxVisibility = 30;
+// how close to a travel region the party gets before its destination is read ahead
+static const int PREFETCH_DISTANCE = 200;
 static int VisibilityPerimeter; //calculated from MaxVisibility
 static int NormalCost = 10;
 static int AdditionalCost = 4;
@@ -483,6 +488,8 @@ void Map::AddTileMap(TileMap* tm, Image* lm, Bitmap* sr, Holder<Sprite2D> sm, Bi
 
 	//delete the original searchmap
 	delete sr;
+
+	actorGrid.Resize(GetSize());
 }
 void Map::AutoLockDoors() const
 {
@@ -663,6 +670,11 @@ void Map::DrawPortal(const InfoPoint *ip, int enable)
 
 void Map::UpdateScripts()
 {
+	// catch positions changed behind our back (importers, opcodes)
+	for (const Actor *actor : actors) {
+		actorGrid.Update(actor);
+	}
+
 	bool has_pcs = false;
 	for (auto actor : actors) {
 		if (actor->InParty) {
@@ -809,6 +821,7 @@ void Map::UpdateScripts()
 
 	//Check if we need to start some trap scripts
 	int ipCount = 0;
+	bool prefetchStarted = false;
 	while (true) {
 		//For each InfoPoint in the map
 		InfoPoint* ip = TMap->GetInfoPoint( ipCount++ );
@@ -842,6 +855,18 @@ void Map::UpdateScripts()
 				}
 			} else {
 				// ST_TRAVEL
+				// start reading the destination while the party walks up to the exit
+				if (actor->InParty && ip->Destination[0] && !prefetchStarted) {
+					Region near = ip->BBox;
+					near.x -= PREFETCH_DISTANCE;
+					near.y -= PREFETCH_DISTANCE;
+					near.w += 2 * PREFETCH_DISTANCE;
+					near.h += 2 * PREFETCH_DISTANCE;
+					if (near.PointInside(actor->Pos)) {
+						gamedata->PrefetchArea(ip->Destination);
+						prefetchStarted = true;
+					}
+				}
 				// don't move if doing something else
 				// added CurrentAction as part of blocking action fixes
 				if (actor->CannotPassEntrance(exitID)) {
@@ -908,6 +933,13 @@ void Map::ClearSearchMapFor(const Movable *actor) {
 	}
 }
 
+void Map::ActorMoved(const Movable *actor)
+{
+	if (actor->Type == ST_ACTOR) {
+		actorGrid.Update(static_cast<const Actor *>(actor));
+	}
+}
+
 Size Map::FogMapSize() const
 {
 	// Ratio of bg tile size and fog tile size
@@ -931,6 +963,70 @@ bool Map::FogTileUncovered(const Point &p, const uint8_t* mask) const
 }
 
 void Map::DrawFogOfWar(const ieByte* explored_mask, const ieByte* visible_mask, const Region& vp)
+{
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_FOG);
+	const Size fogSize = FogMapSize();
+	const Region allCells(Point(), fogSize);
+
+	Video* vid = core->GetVideoDriver();
+	if (!vid->SupportsBlendedBuffers()) {
+		fogDirty = Region();
+		DrawFogCells(explored_mask, visible_mask, vp, allCells);
+		return;
+	}
+
+	// the fog is kept in a buffer of the viewport size and only the cells
+	// that changed since the last frame are drawn again
+	if (fogBuffer == nullptr || fogBuffer->Size() != vp.size) {
+		fogBuffer = vid->CreateBuffer(Region(Point(), vp.size), Video::BufferFormat::DISPLAY_ALPHA);
+		if (fogBuffer == nullptr) {
+			DrawFogCells(explored_mask, visible_mask, vp, allCells);
+			return;
+		}
+		fogViewport = Region();
+	}
+
+	Region cells;
+	if (fogViewport != vp || fogMasks[0] != explored_mask || fogMasks[1] != visible_mask) {
+		cells = allCells;
+	} else if (!fogDirty.size.IsInvalid()) {
+		// a cell's edges depend on its neighbours
+		cells = fogDirty;
+		cells.ExpandAllSides(1);
+	}
+	fogViewport = vp;
+	fogMasks[0] = explored_mask;
+	fogMasks[1] = visible_mask;
+	fogDirty = Region();
+
+	if (!cells.size.IsInvalid()) {
+		// the cells in screen coordinates, large fog is offset by half a cell
+		constexpr int CELL_SIZE = 32;
+		const int offset = LargeFog * CELL_SIZE / 2;
+		Region rgn(cells.x * CELL_SIZE - vp.x - offset, cells.y * CELL_SIZE - vp.y - offset,
+				   cells.w * CELL_SIZE, cells.h * CELL_SIZE);
+		if (cells == allCells) {
+			// also covers the borders around the map
+			rgn = Region(Point(), vp.size);
+		}
+		rgn = rgn.Intersect(Region(Point(), vp.size));
+
+		if (!rgn.size.IsInvalid()) {
+			const Region clip = vid->GetScreenClip();
+			vid->PushDrawingBuffer(fogBuffer);
+			vid->SetScreenClip(&rgn);
+			fogBuffer->Clear(rgn);
+			DrawFogCells(explored_mask, visible_mask, vp, cells);
+			vid->PopDrawingBuffer();
+			vid->SetScreenClip(&clip);
+		}
+	}
+
+	vid->BlitVideoBuffer(fogBuffer, Point(), BlitFlags::BLENDED);
+}
+
+// draws the fog for the given cells of the fog map
+void Map::DrawFogCells(const ieByte* explored_mask, const ieByte* visible_mask, const Region& vp, const Region& cells)
 {
 	// Size of Fog-Of-War shadow tile (and bitmap)
 	constexpr int CELL_SIZE = 32;
@@ -1104,11 +1200,13 @@ void Map::DrawFogOfWar(const ieByte* explored_mask, const ieByte* visible_mask,
 		}
 	};
 
-	for (int y = start.y; y < end.y; y++) {
+	const Point first(std::max(start.x, cells.x), std::max(start.y, cells.y));
+	const Point last(std::min(end.x, cells.x + cells.w), std::min(end.y, cells.y + cells.h));
+	for (int y = first.y; y < last.y; y++) {
 		int unexploredQueue = 0;
 		int shroudedQueue = 0;
-		int x = start.x;
-		for (; x < end.x; x++) {
+		int x = first.x;
+		for (; x < last.x; x++) {
 			if (IsExplored(x, y)) {
 				if (unexploredQueue) {
 					FillFog(x - unexploredQueue, y, unexploredQueue, opaque);
@@ -1310,6 +1408,7 @@ VEFObject *Map::GetNextScriptedAnimation(const scaIterator &iter) const
 void Map::DrawMap(const Region& viewport, uint32_t dFlags)
 {
 	assert(TMap);
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_DRAWMAP);
 	debugFlags = dFlags;
 
 	Game *game = core->GetGame();
@@ -1360,6 +1459,7 @@ void Map::DrawMap(const Region& viewport, uint32_t dFlags)
 			rain = game->weather->GetPhase()-P_EMPTY;
 		}
 
+		FrameProfiler::Scope overlayPhase(FrameProfiler::PHASE_OVERLAYS);
 		TMap->DrawOverlays( viewport, rain, flags );
 	}
 
@@ -1420,6 +1520,7 @@ void Map::DrawMap(const Region& viewport, uint32_t dFlags)
 	// an area animation with height > 0 even if the actors themselves are not
 	// hidden by it.
 
+	FrameProfiler::Scope objectPhase(FrameProfiler::PHASE_OBJECTS);
 	while (actor || a || sca || spark || pro || pile) {
 		switch(SelectObject(actor,q,a,sca,spark,pro,pile)) {
 		case AOT_ACTOR:
@@ -1548,6 +1649,7 @@ void Map::DrawMap(const Region& viewport, uint32_t dFlags)
 		}
 	}
 
+	objectPhase.Stop();
 	video->SetStencilBuffer(NULL);
 	
 	bool update_scripts = (core->GetGameControl()->GetDialogueFlags() & DF_FREEZE_SCRIPTS) == 0;
@@ -1897,9 +1999,10 @@ void Map::AddAnimation(AreaAnimation* panim)
 //this might be unnecessary later
 void Map::UpdateEffects()
 {
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_EFFECTS);
 	size_t i = actors.size();
 	while (i--) {
-		actors[i]->RefreshEffects(NULL);
+		actors[i]->UpdateEffects();
 	}
 }
 
@@ -1944,7 +2047,9 @@ int Map::CountSummons(ieDword flags, ieDword sex) const
 bool Map::AnyEnemyNearPoint(const Point &p) const
 {
 	ieDword gametime = core->GetGame()->GameTime;
-	for (const Actor *actor : actors) {
+	std::vector<Actor *> candidates;
+	actorGrid.Query(Region(p.x - SPAWN_RANGE, p.y - SPAWN_RANGE, SPAWN_RANGE * 2, SPAWN_RANGE * 2), candidates);
+	for (const Actor *actor : candidates) {
 		if (!actor->Schedule(gametime, true) ) {
 			continue;
 		}
@@ -2029,6 +2134,8 @@ void Map::AddActor(Actor* actor, bool init)
 	strnlwrcpy(actor->Area, scriptName, 8);
 	if (!HasActor(actor)) {
 		actors.push_back( actor );
+		actorsByID[actor->GetGlobalID()] = actor;
+		actorGrid.Insert(actor);
 	}
 	if (init) {
 		actor->SetMap(this);
@@ -2057,6 +2164,8 @@ bool Map::AnyPCSeesEnemy() const
 void Map::DeleteActor(int i)
 {
 	Actor *actor = actors[i];
+	// the actor may be gone by the time it leaves the list
+	ieDword globalID = actor ? actor->GetGlobalID() : 0;
 	if (actor) {
 		Game *game = core->GetGame();
 		//this makes sure that a PC will be demoted to NPC
@@ -2074,6 +2183,8 @@ void Map::DeleteActor(int i)
 		}
 	}
 	//remove the actor from the area's actor list
+	actorGrid.Remove(actors[i]);
+	actorsByID.erase(globalID);
 	actors.erase( actors.begin()+i );
 }
 
@@ -2085,15 +2196,8 @@ Scriptable *Map::GetScriptableByGlobalID(ieDword objectID)
 	if (scr)
 		return scr;
 
-	scr = GetInfoPointByGlobalID(objectID);
-	if (scr)
-		return scr;
-
-	scr = GetContainerByGlobalID(objectID);
-	if (scr)
-		return scr;
-
-	scr = GetDoorByGlobalID(objectID);
+	// doors, containers and infopoints
+	scr = TMap->GetScriptableByGlobalID(objectID);
 	if (scr)
 		return scr;
 
@@ -2107,42 +2211,28 @@ Door *Map::GetDoorByGlobalID(ieDword objectID) const
 {
 	if (!objectID) return NULL;
 
-	int doorCount = 0;
-	while (true) {
-		Door* door = TMap->GetDoor( doorCount++ );
-		if (!door)
-			return NULL;
-		if (door->GetGlobalID() == objectID)
-			return door;
-	}
+	Scriptable *scr = TMap->GetScriptableByGlobalID(objectID);
+	if (!scr || scr->Type != ST_DOOR) return NULL;
+	return (Door *) scr;
 }
 
 Container *Map::GetContainerByGlobalID(ieDword objectID) const
 {
 	if (!objectID) return NULL;
 
-	int containerCount = 0;
-	while (true) {
-		Container* container = TMap->GetContainer( containerCount++ );
-		if (!container)
-			return NULL;
-		if (container->GetGlobalID() == objectID)
-			return container;
-	}
+	Scriptable *scr = TMap->GetScriptableByGlobalID(objectID);
+	if (!scr || scr->Type != ST_CONTAINER) return NULL;
+	return (Container *) scr;
 }
 
 InfoPoint *Map::GetInfoPointByGlobalID(ieDword objectID) const
 {
 	if (!objectID) return NULL;
 
-	int ipCount = 0;
-	while (true) {
-		InfoPoint* ip = TMap->GetInfoPoint( ipCount++ );
-		if (!ip)
-			return NULL;
-		if (ip->GetGlobalID() == objectID)
-			return ip;
-	}
+	Scriptable *scr = TMap->GetScriptableByGlobalID(objectID);
+	if (!scr) return NULL;
+	if (scr->Type != ST_PROXIMITY && scr->Type != ST_TRIGGER && scr->Type != ST_TRAVEL) return NULL;
+	return (InfoPoint *) scr;
 }
 
 Actor* Map::GetActorByGlobalID(ieDword objectID) const
@@ -2150,12 +2240,114 @@ Actor* Map::GetActorByGlobalID(ieDword objectID) const
 	if (!objectID) {
 		return NULL;
 	}
-	for (auto actor : actors) {
-		if (actor->GetGlobalID()==objectID) {
-			return actor;
+	auto it = actorsByID.find(objectID);
+	if (it == actorsByID.end()) {
+		return NULL;
+	}
+	return it->second;
+}
+
+void ActorGrid::Resize(const Size &mapSize)
+{
+	columns = std::max(1, (mapSize.w + CELL_SIZE - 1) / CELL_SIZE);
+	rows = std::max(1, (mapSize.h + CELL_SIZE - 1) / CELL_SIZE);
+	std::vector<Bucket> oldCells(columns * rows);
+	std::swap(cells, oldCells);
+	for (const Bucket &bucket : oldCells) {
+		for (const Slot &slot : bucket) {
+			int cell = CellIndex(slot.actor->Pos);
+			cellOf[slot.actor] = cell;
+			cells[cell].push_back(slot);
 		}
 	}
-	return NULL;
+	for (Bucket &bucket : cells) {
+		std::sort(bucket.begin(), bucket.end(), [](const Slot &a, const Slot &b) {
+			return a.order < b.order;
+		});
+	}
+}
+
+// anything off the map is kept in the nearest border cell
+int ActorGrid::CellIndex(const Point &p) const
+{
+	int column = Clamp(p.x / CELL_SIZE, 0, columns - 1);
+	int row = Clamp(p.y / CELL_SIZE, 0, rows - 1);
+	return row * columns + column;
+}
+
+ActorGrid::Bucket::iterator ActorGrid::Find(Bucket &bucket, const Actor *actor)
+{
+	return std::find_if(bucket.begin(), bucket.end(), [actor](const Slot &slot) {
+		return slot.actor == actor;
+	});
+}
+
+void ActorGrid::Insert(Actor *actor)
+{
+	if (cellOf.count(actor)) return;
+	int cell = CellIndex(actor->Pos);
+	cellOf[actor] = cell;
+	cells[cell].push_back({ actor, nextOrder++ });
+	maxSize = std::max(maxSize, int(actor->size));
+}
+
+void ActorGrid::Remove(const Actor *actor)
+{
+	auto it = cellOf.find(actor);
+	if (it == cellOf.end()) return;
+	Bucket &bucket = cells[it->second];
+	bucket.erase(Find(bucket, actor));
+	cellOf.erase(it);
+}
+
+void ActorGrid::Update(const Actor *actor)
+{
+	auto it = cellOf.find(actor);
+	if (it == cellOf.end()) return;
+	maxSize = std::max(maxSize, int(actor->size));
+	int newCell = CellIndex(actor->Pos);
+	int oldCell = it->second;
+	if (newCell == oldCell) return;
+
+	// keep the buckets in actor list order
+	Bucket &bucket = cells[oldCell];
+	auto pos = Find(bucket, actor);
+	Bucket &target = cells[newCell];
+	auto dest = std::upper_bound(target.begin(), target.end(), *pos, [](const Slot &a, const Slot &b) {
+		return a.order < b.order;
+	});
+	target.insert(dest, *pos);
+	bucket.erase(pos);
+	it->second = newCell;
+}
+
+void ActorGrid::Query(const Region &rgn, std::vector<Actor *> &out) const
+{
+	matches.clear();
+	int startCell = CellIndex(rgn.origin);
+	int endCell = CellIndex(Point(rgn.x + rgn.w, rgn.y + rgn.h));
+	int startColumn = startCell % columns;
+	int endColumn = endCell % columns;
+	for (int row = startCell / columns; row <= endCell / columns; row++) {
+		for (int column = startColumn; column <= endColumn; column++) {
+			for (const Slot &slot : cells[row * columns + column]) {
+				const Point &p = slot.actor->Pos;
+				if (p.x < rgn.x || p.y < rgn.y || p.x > rgn.x + rgn.w || p.y > rgn.y + rgn.h) continue;
+				matches.push_back(slot);
+			}
+		}
+	}
+	// a single bucket is already in order
+	if (startCell != endCell) {
+		std::sort(matches.begin(), matches.end(), [](const Slot &a, const Slot &b) {
+			return a.order < b.order;
+		});
+	}
+	out.clear();
+	out.reserve(matches.size());
+	for (const Slot &slot : matches) {
+		out.push_back(slot.actor);
+	}
 }
 
 /** flags:
@@ -2166,7 +2358,11 @@ Actor* Map::GetActorByGlobalID(ieDword objectID) const
 */
 Actor* Map::GetActor(const Point &p, int flags, const Movable *checker) const
 {
-	for (auto actor : actors) {
+	// the ground circle reaches up to (size - 1) searchmap cells around the actor
+	int reach = std::max(actorGrid.GetMaxSize() - 1, 1);
+	std::vector<Actor *> candidates;
+	actorGrid.Query(Region(p.x - reach * 16, p.y - reach * 12, reach * 32, reach * 24), candidates);
+	for (auto actor : candidates) {
 		if (!actor->IsOver( p ))
 			continue;
 		if (!actor->ValidTarget(flags, checker) ) {
@@ -2179,7 +2375,11 @@ Actor* Map::GetActor(const Point &p, int flags, const Movable *checker) const
 
 Actor* Map::GetActorInRadius(const Point &p, int flags, unsigned int radius) const
 {
-	for (auto actor : actors) {
+	// personal distance discounts the size of the actor
+	int reach = radius + actorGrid.GetMaxSize() * 10;
+	std::vector<Actor *> candidates;
+	actorGrid.Query(Region(p.x - reach, p.y - reach, reach * 2, reach * 2), candidates);
+	for (auto actor : candidates) {
 		if (PersonalDistance( p, actor ) > radius)
 			continue;
 		if (!actor->ValidTarget(flags) ) {
@@ -2193,7 +2393,11 @@ Actor* Map::GetActorInRadius(const Point &p, int flags, unsigned int radius) con
 std::vector<Actor *> Map::GetAllActorsInRadius(const Point &p, int flags, unsigned int radius, const Scriptable *see) const
 {
 	std::vector<Actor *> neighbours;
-	for (auto actor : actors) {
+	// a foot is at most 16 pixels, see Feet2Pixels
+	int reach = radius * 16 + 1;
+	std::vector<Actor *> candidates;
+	actorGrid.Query(Region(p.x - reach, p.y - reach, reach * 2, reach * 2), candidates);
+	for (auto actor : candidates) {
 		if (!WithinRange(actor, p, radius)) {
 			continue;
 		}
@@ -2316,6 +2520,7 @@ void Map::PurgeArea(bool items)
 		if (!actor->ValidTarget(GA_NO_DEAD|GA_NO_UNSCHEDULED|GA_NO_ALLY|GA_NO_ENEMY)) continue;
 		if (!actor->HomeLocation.IsZero() && !actor->HomeLocation.IsInvalid() && actor->Pos != actor->HomeLocation) {
 			actor->Pos = actor->HomeLocation;
+			actorGrid.Update(actor);
 		}
 	}
 }
@@ -2436,9 +2641,19 @@ Actor *Map::GetActorByScriptName(const char *name) const
 
 int Map::GetActorsInRect(Actor**& actorlist, const Region& rgn, int excludeFlags) const
 {
+	// include anyone whose circle could cover the origin
+	int reach = std::max(actorGrid.GetMaxSize() - 1, 1);
+	Region bounds = rgn;
+	bounds.x = std::min(rgn.x, rgn.x - reach * 16);
+	bounds.y = std::min(rgn.y, rgn.y - reach * 12);
+	bounds.w = std::max(rgn.x + rgn.w, rgn.x + reach * 16) - bounds.x;
+	bounds.h = std::max(rgn.y + rgn.h, rgn.y + reach * 12) - bounds.y;
+	std::vector<Actor *> candidates;
+	actorGrid.Query(bounds, candidates);
+
 	actorlist = ( Actor * * ) malloc( actors.size() * sizeof( Actor * ) );
 	int count = 0;
-	for (auto actor : actors) {
+	for (auto actor : candidates) {
 		if (!actor->ValidTarget(excludeFlags))
 			continue;
 		if (!rgn.PointInside(actor->Pos)
@@ -2599,10 +2814,102 @@ PathMapFlags Map::GetBlockedInLine(const Point &s, const Point &d, bool stopOnIm
 }
 
 // PathMapFlags::SIDEWALL obstructs LOS, while PathMapFlags::IMPASSABLE doesn't
-bool Map::IsVisibleLOS(const Point &s, const Point &d, const Actor *caller) const
+bool Map::IsVisibleLOS(const Point &s, const Point &d) const
 {
-	PathMapFlags ret = GetBlockedInLine(s, d, false, caller);
-	return !bool(ret & PathMapFlags::SIDEWALL);
+	// script object matching asks the same questions many times per tick
+	const Game *game = core->GetGame();
+	ieDword now = game ? ieDword(game->GameTime) : 0;
+	if (now != losCacheTime || losCache.size() > 8192) {
+		losCache.clear();
+		losCacheTime = now;
+	}
+
+	uint64_t key = (uint64_t(uint16_t(s.x)) << 48) | (uint64_t(uint16_t(s.y)) << 32) | (uint64_t(uint16_t(d.x)) << 16) | uint16_t(d.y);
+	auto cached = losCache.find(key);
+	if (cached != losCache.end()) {
+		return cached->second;
+	}
+	FrameProfiler::Count(FrameProfiler::COUNT_LOSRAYS);
+	bool visible = IsLineOfSightClear(s, d);
+	losCache.emplace(key, visible);
+	if (LogDebugEnabled("LOS")) {
+		Point from = s;
+		Point to = d;
+		LogDeferred(DEBUG, "LOS", [from, to, visible]() {
+			StringBuffer buffer;
+			buffer.appendFormatted("(%d, %d) -> (%d, %d) is %s", from.x, from.y, to.x, to.y, visible ? "clear" : "blocked");
+			return buffer.get();
+		});
+	}
+	return visible;
+}
+
+static inline int FloorDiv(int a, int b)
+{
+	return a >= 0 ? a / b : -((b - 1 - a) / b);
+}
+
+// Supercover walk over the searchmap cells the line touches, giving up at the
+// first one that blocks sight. Every cell is visited, so the ray can't slip
+// past the corner of a wall cell; when it passes exactly through a corner,
+// both side cells are tested too.
+bool Map::IsLineOfSightClear(const Point &s, const Point &d) const
+{
+	if (s == d) return true;
+
+	// off-map cells wrap around, which GetBlocked treats as impassable, not as walls
+	int x = FloorDiv(s.x, 16);
+	int y = FloorDiv(s.y, 12);
+	const int endX = FloorDiv(d.x, 16);
+	const int endY = FloorDiv(d.y, 12);
+	if (bool(GetBlocked(x, y) & PathMapFlags::SIDEWALL)) {
+		return false;
+	}
+
+	const int stepX = d.x > s.x ? 1 : -1;
+	const int stepY = d.y > s.y ? 1 : -1;
+	const long long adx = std::abs(d.x - s.x);
+	const long long ady = std::abs(d.y - s.y);
+	// distance from the start to the next cell border on each axis
+	long long nextX = stepX > 0 ? (x + 1) * 16 - s.x : s.x - x * 16;
+	long long nextY = stepY > 0 ? (y + 1) * 12 - s.y : s.y - y * 12;
+
+	while (x != endX || y != endY) {
+		bool moveX;
+		bool moveY;
+		if (x == endX) {
+			moveX = false;
+			moveY = true;
+		} else if (y == endY) {
+			moveX = true;
+			moveY = false;
+		} else {
+			// compare nextX / adx with nextY / ady without dividing
+			long long crossX = nextX * ady;
+			long long crossY = nextY * adx;
+			moveX = crossX <= crossY;
+			moveY = crossY <= crossX;
+		}
+
+		if (moveX && moveY) {
+			if (bool(GetBlocked(x + stepX, y) & PathMapFlags::SIDEWALL) ||
+				bool(GetBlocked(x, y + stepY) & PathMapFlags::SIDEWALL)) {
+				return false;
+			}
+		}
+		if (moveX) {
+			x += stepX;
+			nextX += 16;
+		}
+		if (moveY) {
+			y += stepY;
+			nextY += 12;
+		}
+		if (bool(GetBlocked(x, y) & PathMapFlags::SIDEWALL)) {
+			return false;
+		}
+	}
+	return true;
 }
 
 // Used by the pathfinder, so PathMapFlags::IMPASSABLE obstructs walkability
@@ -2615,6 +2922,7 @@ bool Map::IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking, c
 
 void Map::RedrawScreenStencil(const Region& vp, const WallPolygonGroup& walls)
 {
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_STENCILS);
 	// FIXME: how do we know if a door changed state?
 	// we need to redraw the stencil when that happens
 	// see TODO in Map::SetDrawingStencilForScriptable for another example of something that could use this
@@ -2917,6 +3225,8 @@ void Map::RemoveActor(Actor* actor)
 			ClearSearchMapFor(actor);
 			actor->SetMap(NULL);
 			CopyResRef(actor->Area, "");
+			actorGrid.Remove(actor);
+			actorsByID.erase(actor->GetGlobalID());
 			actors.erase( actors.begin()+i );
 			return;
 		}
@@ -3099,7 +3409,7 @@ int Map::WhichEdge(const Point &s) const
 	unsigned int sX=s.x/16;
 	unsigned int sY=s.y/12;
 	if (!(GetBlocked(sX, sY) & PathMapFlags::TRAVEL)) {
-		Log(DEBUG, "Map", "This isn't a travel region [%d.%d]?",
+		LogDebug("Map", "This isn't a travel region [%d.%d]?",
 			sX, sY);
 		return -1;
 	}
@@ -3127,6 +3437,31 @@ void Map::SetupAmbients() const
 	ambim->setAmbients( ambients );
 }
 
+// warm the sound cache with the ambients and the creatures' battle cries,
+// so the first fight does not wait on the decoder
+void Map::PreloadSounds() const
+{
+	Audio* audio = core->GetAudioDrv();
+	for (const Ambient* ambient : ambients) {
+		for (const char* sound : ambient->sounds) {
+			audio->Preload(sound);
+		}
+	}
+
+	std::set<ieStrRef> seen;
+	for (const Actor* actor : actors) {
+		// party members use sound sets instead
+		if (actor->InParty) continue;
+		for (int vc = VB_ATTACK; vc <= VB_HURT; vc++) {
+			ieStrRef strref = actor->GetVerbalConstant(vc);
+			if (strref == ieStrRef(-1) || !seen.insert(strref).second) continue;
+
+			StringBlock sb = core->strings->GetStringBlock(strref);
+			audio->Preload(sb.Sound);
+		}
+	}
+}
+
 ieWord Map::GetAmbientCount(bool toSave) const
 {
 	if (!toSave) return static_cast<ieWord>(ambients.size());
@@ -3369,23 +3704,86 @@ int Map::GetExploredMapSize() const
 void Map::FillExplored(bool explored)
 {
 	std::fill(ExploredBitmap, ExploredBitmap + GetExploredMapSize(), explored ? 0xff : 0x00);
+	const Size fogSize = FogMapSize();
+	fogDirty = Region(Point(), fogSize);
 }
 
-void Map::ExploreTile(const Point &p)
+// index of the fog cell under p (in map coordinates) or -1 outside the fog map
+int Map::FogCellIndex(const Point &p) const
 {
 	Point fogP = ConvertPointToFog(p);
 
 	const Size fogSize = FogMapSize();
 	if (fogP.x < 0 || fogP.x >= fogSize.w || fogP.y < 0 || fogP.y >= fogSize.h) {
+		return -1;
+	}
+	return fogSize.w * fogP.y + fogP.x;
+}
+
+void Map::MarkFogDirty(int cell)
+{
+	const Size fogSize = FogMapSize();
+	Region r(Point(cell % fogSize.w, cell / fogSize.w), Size(1, 1));
+	if (fogDirty.size.IsInvalid()) {
+		fogDirty = r;
+	} else {
+		fogDirty.ExpandToRegion(r);
+	}
+}
+
+// explores the cell and makes it visible, returns false if it was visible already
+bool Map::RevealFogCell(int cell)
+{
+	div_t res = div(cell, 8);
+	ieByte bit = 1 << res.rem;
+	if (!(ExploredBitmap[res.quot] & bit)) {
+		ExploredBitmap[res.quot] |= bit;
+		MarkFogDirty(cell);
+	}
+	if (VisibleBitmap[res.quot] & bit) {
+		return false;
+	}
+	VisibleBitmap[res.quot] |= bit;
+	MarkFogDirty(cell);
+	return true;
+}
+
+void Map::ShroudFogCell(int cell)
+{
+	div_t res = div(cell, 8);
+	ieByte bit = 1 << res.rem;
+	if (VisibleBitmap[res.quot] & bit) {
+		VisibleBitmap[res.quot] &= ~bit;
+		MarkFogDirty(cell);
+	}
+}
+
+void Map::ExploreTile(const Point &p)
+{
+	int cell = FogCellIndex(p);
+	if (cell < 0) {
 		return;
 	}
-	
-	div_t res = div(fogSize.w * fogP.y + fogP.x, 8);
-	ExploredBitmap[res.quot] |= (1 << res.rem);
-	VisibleBitmap[res.quot] |= (1 << res.rem);
+
+	// no actor keeps it visible, so UpdateFog will cover it again
+	if (RevealFogCell(cell) && (visionRefs.empty() || visionRefs[cell] == 0)) {
+		transientVision.push_back(cell);
+	}
 }
 
 void Map::ExploreMapChunk(const Point &Pos, int range, int los)
+{
+	std::vector<int> cells;
+	TraceVision(Pos, range, los, cells);
+	for (int cell : cells) {
+		if (RevealFogCell(cell) && (visionRefs.empty() || visionRefs[cell] == 0)) {
+			transientVision.push_back(cell);
+		}
+	}
+}
+
+// collects the fog cells seen from Pos, each of them once
+void Map::TraceVision(const Point &Pos, int range, int los, std::vector<int>& cells) const
 {
 	Point Tile;
 
@@ -3418,31 +3816,100 @@ void Map::ExploreMapChunk(const Point &Pos, int range, int los)
 					if (!Pass) break;
 				}
 			}
-			ExploreTile(Tile);
+			int cell = FogCellIndex(Tile);
+			if (cell >= 0) {
+				cells.push_back(cell);
+			}
+		}
+	}
+
+	std::sort(cells.begin(), cells.end());
+	cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+}
+
+void Map::ReleaseVision(ActorVision& vision)
+{
+	for (int cell : vision.cells) {
+		if (--visionRefs[cell] == 0) {
+			ShroudFogCell(cell);
 		}
 	}
+	vision.cells.clear();
 }
 
+// VisibleBitmap is the union of what the exploring actors see; each actor
+// holds a reference on its cells, so only actors that moved, changed their
+// visual range or lost their line of sight have to be traced again
 void Map::UpdateFog()
 {
-	std::fill(VisibleBitmap, VisibleBitmap + GetExploredMapSize(), 0);
-	
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_FOGUPDATE);
+	const Size fogSize = FogMapSize();
+	if (visionRefs.size() != size_t(fogSize.Area())) {
+		visionRefs.assign(fogSize.Area(), 0);
+		actorVision.clear();
+		std::fill(VisibleBitmap, VisibleBitmap + GetExploredMapSize(), 0);
+		fogDirty = Region(Point(), fogSize);
+	}
+
+	for (int cell : transientVision) {
+		if (visionRefs[cell] == 0) {
+			ShroudFogCell(cell);
+		}
+	}
+	transientVision.clear();
+
+	for (auto& vision : actorVision) {
+		vision.second.present = false;
+	}
+
+	std::vector<int> cells;
 	for (size_t i = 0; i < actors.size(); i++) {
 		const Actor *actor = actors[i];
-		if (!actor->Modified[ IE_EXPLORE ] ) continue;
-		
+		int range = -1;
 		int state = actor->Modified[IE_STATE_ID];
-		if (state & STATE_CANTSEE) continue;
-		
-		int vis2 = actor->Modified[IE_VISUALRANGE];
-		if ((state&STATE_BLIND) || (vis2<2)) vis2=2; //can see only themselves
-		ExploreMapChunk (actor->Pos, vis2+actor->GetAnims()->GetCircleSize(), 1);
-		
+		if (actor->Modified[IE_EXPLORE] && !(state & STATE_CANTSEE)) {
+			int vis2 = actor->Modified[IE_VISUALRANGE];
+			if ((state&STATE_BLIND) || (vis2<2)) vis2=2; //can see only themselves
+			range = vis2 + actor->GetAnims()->GetCircleSize();
+		}
+
+		ActorVision& vision = actorVision[actor->GetGlobalID()];
+		vision.present = true;
+		if (range != vision.range || actor->Pos != vision.pos || vision.epoch != visionEpoch) {
+			// take the new references first, so cells that stay in view don't flicker
+			cells.clear();
+			if (range >= 0) {
+				TraceVision(actor->Pos, range, 1, cells);
+			}
+			for (int cell : cells) {
+				if (visionRefs[cell]++ == 0) {
+					RevealFogCell(cell);
+				}
+			}
+			ReleaseVision(vision);
+			vision.cells.swap(cells);
+			vision.pos = actor->Pos;
+			vision.range = range;
+			vision.epoch = visionEpoch;
+		}
+		if (range < 0) continue;
+
 		Spawn *sp = GetSpawnRadius(actor->Pos, SPAWN_RANGE); //30 * 12
 		if (sp) {
 			TriggerSpawn(sp);
 		}
 	}
+
+	// actors that left the map or were destroyed
+	auto it = actorVision.begin();
+	while (it != actorVision.end()) {
+		if (it->second.present) {
+			++it;
+		} else {
+			ReleaseVision(it->second);
+			it = actorVision.erase(it);
+		}
+	}
 }
 
 // Valid values are - PathMapFlags::UNMARKED, PathMapFlags::PC, PathMapFlags::NPC
@@ -3568,7 +4035,7 @@ static void MergePiles(Container *donorPile, Container *pile)
 			int slot = pile->inventory.FindItem(item->ItemResRef, 0, --count);
 			if (slot == -1) {
 				// probably an inventory bug, shouldn't happen
-				Log(DEBUG, "Map", "MoveVisibleGroundPiles found unaccessible pile item: %s", item->ItemResRef);
+				LogDebug("Map", "MoveVisibleGroundPiles found unaccessible pile item: %s", item->ItemResRef);
 				skipped--;
 				continue;
 			}
@@ -4097,7 +4564,14 @@ void Map::SetInternalSearchMap(int x, int y, PathMapFlags value)
 	if ((unsigned)x >= Width || (unsigned)y >= Height) {
 		return;
 	}
-	SrchMap[x+y*Width] = value;
+	PathMapFlags &cell = SrchMap[x+y*Width];
+	if (bool((cell ^ value) & PathMapFlags::NOTACTOR)) {
+		pathClusters.Invalidate();
+		// doors opening or closing change what can be seen
+		losCache.clear();
+		++visionEpoch;
+	}
+	cell = value;
 }
 
 void Map::SetBackground(const ieResRef &bgResRef, ieDword duration)
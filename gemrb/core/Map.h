@@ -292,6 +292,46 @@ public:
 	}
 };
 
+// Uniform grid bucketing the area's actors by navmap position, so proximity
+// queries only have to look at the few cells around them. Candidates are
+// returned in the order the actors were added to the area, which matches
+// the order of the area's actor list, so results don't depend on the grid.
+class ActorGrid {
+public:
+	static const int CELL_SIZE = 128; // in navmap pixels
+
+	void Resize(const Size &mapSize);
+	void Insert(Actor *actor);
+	void Remove(const Actor *actor);
+	// rebucket an actor after its position (or size) changed
+	void Update(const Actor *actor);
+	// fills out with all actors positioned inside the rectangle, in actor
+	// list order; callers own the vector, so queries may nest
+	void Query(const Region &rgn, std::vector<Actor *> &out) const;
+	// the largest circle size of any indexed actor, to pad queries with
+	int GetMaxSize() const { return maxSize; }
+
+private:
+	// the sort key travels with the actor, so queries don't need lookups
+	struct Slot {
+		Actor *actor;
+		unsigned long order;
+	};
+	typedef std::vector<Slot> Bucket;
+
+	int CellIndex(const Point &p) const;
+	Bucket::iterator Find(Bucket &bucket, const Actor *actor);
+
+	std::unordered_map<const Actor *, int> cellOf;
+	std::vector<Bucket> cells = std::vector<Bucket>(1);
+	int columns = 1;
+	int rows = 1;
+	int maxSize = 0;
+	unsigned long nextOrder = 0;
+	// scratch space, only used within a single query
+	mutable std::vector<Slot> matches;
+};
+
 class GEM_EXPORT AreaAnimation {
 public:
 	Animation **animation;
@@ -398,8 +438,15 @@ private:
 	PathMapFlags* SrchMap; //internal searchmap
 	unsigned short* MaterialMap;
 	unsigned int Width, Height;
+	mutable PathfinderWorkspace pathWorkspace;
+	mutable PathClusterGraph pathClusters; // rebuilt on demand after door changes
+	// IsVisibleLOS results for this tick, keyed by the packed end points
+	mutable std::unordered_map<uint64_t, bool> losCache;
+	mutable ieDword losCacheTime = 0;
 	std::list< AreaAnimation*> animations;
 	std::vector< Actor*> actors;
+	std::unordered_map<ieDword, Actor*> actorsByID;
+	ActorGrid actorGrid;
 	std::vector<WallPolygonGroup> wallGroups;
 	std::list< VEFObject*> vvcCells;
 	std::list< Projectile*> projectiles;
@@ -416,6 +463,27 @@ private:
 	VideoBufferPtr wallStencil;
 	Region stencilViewport;
 
+	// the fog cells an exploring actor uncovered on its last vision update
+	struct ActorVision {
+		Point pos;
+		int range = -1; // -1 when the actor doesn't explore
+		ieDword epoch = 0;
+		bool present = false;
+		std::vector<int> cells;
+	};
+	std::unordered_map<ieDword, ActorVision> actorVision;
+	// how many actors see each fog cell
+	std::vector<uint16_t> visionRefs;
+	// cells uncovered by scripts or effects, they are only visible until the next update
+	std::vector<int> transientVision;
+	// bumped when doors change what blocks sight, so every actor traces its vision again
+	ieDword visionEpoch = 1;
+	// the fog cells that changed since the fog buffer was drawn
+	Region fogDirty;
+	VideoBufferPtr fogBuffer;
+	Region fogViewport;
+	const ieByte* fogMasks[2] = { nullptr, nullptr };
+
 	std::unordered_map<const void*, std::pair<VideoBufferPtr, Region>> objectStencils;
 
 public:
@@ -561,6 +629,8 @@ public:
 	/* block or unblock searchmap with value */
 	void BlockSearchMap(const Point &Pos, unsigned int size, PathMapFlags value);
 	void ClearSearchMapFor(const Movable *actor);
+	/* keeps the actor lookup grid in sync, call after changing an actor's position */
+	void ActorMoved(const Movable *actor);
 	/* update VisibleBitmap by resolving vision of all explore actors */
 	void UpdateFog();
 	//PathFinder
@@ -584,7 +654,7 @@ public:
 
 	bool IsVisible(const Point &p) const;
 	bool IsExplored(const Point &p) const;
-	bool IsVisibleLOS(const Point &s, const Point &d, const Actor *caller = NULL) const;
+	bool IsVisibleLOS(const Point &s, const Point &d) const;
 	bool IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking, const Actor *caller) const;
 
 	/* returns edge direction of map boundary, only worldmap regions */
@@ -593,6 +663,7 @@ public:
 	//ambients
 	void AddAmbient(Ambient *ambient) { ambients.push_back(ambient); }
 	void SetupAmbients() const;
+	void PreloadSounds() const;
 	Ambient *GetAmbient(int i) const { return ambients[i]; }
 	ieWord GetAmbientCount(bool toSave = false) const;
 
@@ -658,9 +729,16 @@ private:
 	void DrawPortal(const InfoPoint *ip, int enable);
 	void DrawHighlightables(const Region& viewport) const;
 	void DrawFogOfWar(const ieByte* explored_mask, const ieByte* visible_mask, const Region& viewport);
+	void DrawFogCells(const ieByte* explored_mask, const ieByte* visible_mask, const Region& viewport, const Region& cells);
 	Size FogMapSize() const;
 	bool FogTileUncovered(const Point &p, const uint8_t*) const;
 	Point ConvertPointToFog(const Point &p) const;
+	int FogCellIndex(const Point &p) const;
+	void TraceVision(const Point &Pos, int range, int los, std::vector<int>& cells) const;
+	bool RevealFogCell(int cell);
+	void ShroudFogCell(int cell);
+	void MarkFogDirty(int cell);
+	void ReleaseVision(ActorVision& vision);
 	
 	void GenerateQueues();
 	void SortQueues() const;
@@ -674,7 +752,7 @@ private:
 	
 	void UpdateSpawns() const;
 	PathMapFlags GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable, const Actor *caller = NULL) const;
-
+	bool IsLineOfSightClear(const Point &s, const Point &d) const;
 };
 
 }
@@ -29,10 +29,13 @@
 
 #include "Plugin.h"
 
+#include <vector>
+
 namespace GemRB {
 
 class DataStream;
 class Map;
+struct ResourceRequest;
 
 /**
  * @class MapMgr
@@ -46,6 +49,8 @@ public:
 	virtual bool Open(DataStream* stream) = 0;
 	virtual bool ChangeMap(Map *map, bool day_or_night) = 0;
 	virtual Map* GetMap(const char* ResRef, bool day_or_night) = 0;
+	/** Lists the resources GetMap will load, so they can be read ahead */
+	virtual void GetResourceList(std::vector<ResourceRequest>& list) = 0;
 
 	virtual int GetStoredFileSize(Map *map) = 0;
 	virtual int PutArea(DataStream* stream, Map *map) = 0;
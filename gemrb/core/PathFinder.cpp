@@ -34,16 +34,20 @@
 // Moving to each node in the path thus becomes an automatic regulation problem
 // which is solved with a P regulator, see Scriptable.cpp
 
-#include "FibonacciHeap.h"
+#include "FrameProfiler.h"
 #include "GameData.h"
 #include "Map.h"
 #include "PathFinder.h"
 #include "RNG.h"
 #include "Scriptable/Actor.h"
+#include "System/StringBuffer.h"
 
 #include <array>
 #include <cmath>
+#include <functional>
 #include <limits>
+#include <queue>
+#include <string>
 
 namespace GemRB {
 
@@ -58,6 +62,204 @@ constexpr std::array<double, RAND_DEGREES_OF_FREEDOM> dxRand{{0.000, -0.383, -0.
 // Sines
 constexpr std::array<double, RAND_DEGREES_OF_FREEDOM> dyRand{{1.000, 0.924, 0.707, 0.383, 0.000, -0.383, -0.707, -0.924, -1.000, -0.924, -0.707, -0.383, 0.000, 0.383, 0.707, 0.924}};
 
+// searches between cells at most this many clusters apart don't consult the cluster graph
+constexpr int CLUSTER_SEARCH_MIN_SPAN = 2;
+
+void PathfinderWorkspace::Begin(size_t cells)
+{
+	open.clear();
+	if (nodes.size() != cells) {
+		nodes.assign(cells, Node());
+		search = 0;
+	}
+	if (++search == 0) {
+		// the stamp wrapped around, so stale nodes could pass for current ones
+		std::fill(nodes.begin(), nodes.end(), Node());
+		search = 1;
+	}
+}
+
+PathfinderWorkspace::Node& PathfinderWorkspace::Get(size_t idx)
+{
+	Node &node = nodes[idx];
+	if (node.stamp != search) {
+		node = Node();
+		node.stamp = search;
+	}
+	return node;
+}
+
+void PathfinderWorkspace::Push(const PQNode &node)
+{
+	open.push_back(node);
+	std::push_heap(open.begin(), open.end(), std::greater<PQNode>());
+}
+
+PQNode PathfinderWorkspace::Pop()
+{
+	std::pop_heap(open.begin(), open.end(), std::greater<PQNode>());
+	PQNode node = open.back();
+	open.pop_back();
+	return node;
+}
+
+// same rules as Map::GetBlocked, minus the actors
+static bool IsStaticallyWalkable(PathMapFlags cell)
+{
+	cell &= PathMapFlags::NOTACTOR;
+	if (bool(cell & PathMapFlags::DOOR_OPAQUE)) {
+		return false;
+	}
+	if (bool(cell & PathMapFlags::DOOR_IMPASSABLE)) {
+		cell &= ~PathMapFlags::PASSABLE;
+	}
+	return bool(cell & (PathMapFlags::PASSABLE | PathMapFlags::TRAVEL));
+}
+
+void PathClusterGraph::Build(const PathMapFlags *srchMap, unsigned int w, unsigned int h)
+{
+	width = w;
+	height = h;
+	regionMap.assign(width * height, -1);
+	regions.clear();
+	failedCorridors.clear();
+
+	// flood fill each cluster into its regions
+	std::vector<unsigned int> stack;
+	for (unsigned int cy = 0; cy < height; cy += CLUSTER_SIZE) {
+		unsigned int yEnd = std::min(cy + CLUSTER_SIZE, height);
+		for (unsigned int cx = 0; cx < width; cx += CLUSTER_SIZE) {
+			unsigned int xEnd = std::min(cx + CLUSTER_SIZE, width);
+			for (unsigned int y = cy; y < yEnd; y++) {
+				for (unsigned int x = cx; x < xEnd; x++) {
+					unsigned int idx = y * width + x;
+					if (regionMap[idx] != -1 || !IsStaticallyWalkable(srchMap[idx])) continue;
+
+					int id = static_cast<int>(regions.size());
+					unsigned long sumX = 0, sumY = 0, count = 0;
+					regionMap[idx] = id;
+					stack.push_back(idx);
+					while (!stack.empty()) {
+						unsigned int cur = stack.back();
+						stack.pop_back();
+						unsigned int curX = cur % width;
+						unsigned int curY = cur / width;
+						sumX += curX;
+						sumY += curY;
+						count++;
+						for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
+							unsigned int nx = curX + dxAdjacent[i];
+							unsigned int ny = curY + dyAdjacent[i];
+							// unsigned wraparound takes care of the lower bounds
+							if (nx < cx || nx >= xEnd || ny < cy || ny >= yEnd) continue;
+							unsigned int nidx = ny * width + nx;
+							if (regionMap[nidx] != -1 || !IsStaticallyWalkable(srchMap[nidx])) continue;
+							regionMap[nidx] = id;
+							stack.push_back(nidx);
+						}
+					}
+					ClusterRegion region;
+					region.center = Point(sumX / count, sumY / count);
+					regions.push_back(region);
+				}
+			}
+		}
+	}
+
+	// link the regions touching across cluster borders
+	auto link = [this](int a, int b) {
+		if (a < 0 || b < 0 || a == b) return;
+		std::vector<int> &na = regions[a].neighbours;
+		if (std::find(na.begin(), na.end(), b) != na.end()) return;
+		na.push_back(b);
+		regions[b].neighbours.push_back(a);
+	};
+	for (unsigned int y = 0; y < height; y++) {
+		for (unsigned int x = 0; x < width; x++) {
+			int id = regionMap[y * width + x];
+			if (id < 0) continue;
+			if ((x + 1) % CLUSTER_SIZE == 0 && x + 1 < width) {
+				link(id, regionMap[y * width + x + 1]);
+			}
+			if ((y + 1) % CLUSTER_SIZE == 0 && y + 1 < height) {
+				link(id, regionMap[(y + 1) * width + x]);
+			}
+		}
+	}
+	valid = true;
+}
+
+int PathClusterGraph::RegionAt(const SearchmapPoint &p) const
+{
+	if (p.x < 0 || p.y < 0 || unsigned(p.x) >= width || unsigned(p.y) >= height) {
+		return -1;
+	}
+	return regionMap[p.y * width + p.x];
+}
+
+PathClusterGraph::CorridorResult PathClusterGraph::FindCorridor(const SearchmapPoint &from, const SearchmapPoint &to, unsigned int size, std::vector<bool> &corridor) const
+{
+	int start = RegionAt(from);
+	int goal = RegionAt(to);
+	if (start < 0 || goal < 0) {
+		// standing on something the static map doesn't consider walkable,
+		// so leave it all to the detailed search
+		return CORRIDOR_UNUSED;
+	}
+	if (failedCorridors.count(std::make_tuple(start, goal, size))) {
+		return CORRIDOR_UNUSED;
+	}
+
+	// plain A* over the region centers, the graph is small
+	std::vector<double> dist(regions.size(), std::numeric_limits<double>::max());
+	std::vector<int> parent(regions.size(), -1);
+	typedef std::pair<double, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+	const Point &goalCenter = regions[goal].center;
+	auto heuristic = [&goalCenter](const Point &p) {
+		return std::hypot(double(p.x - goalCenter.x), double(p.y - goalCenter.y));
+	};
+	dist[start] = 0;
+	open.emplace(heuristic(regions[start].center), start);
+	while (!open.empty()) {
+		int cur = open.top().second;
+		open.pop();
+		if (cur == goal) break;
+		const Point &curCenter = regions[cur].center;
+		for (int next : regions[cur].neighbours) {
+			const Point &nextCenter = regions[next].center;
+			double newDist = dist[cur] + std::hypot(double(nextCenter.x - curCenter.x), double(nextCenter.y - curCenter.y));
+			if (newDist >= dist[next]) continue;
+			dist[next] = newDist;
+			parent[next] = cur;
+			open.emplace(newDist + heuristic(nextCenter), next);
+		}
+	}
+	if (start != goal && parent[goal] == -1) {
+		return CORRIDOR_UNREACHABLE;
+	}
+
+	corridor.assign(regions.size(), false);
+	for (int cur = goal; cur != -1; cur = parent[cur]) {
+		corridor[cur] = true;
+		// leave the detailed search some room to cut corners
+		for (int next : regions[cur].neighbours) {
+			corridor[next] = true;
+		}
+		if (cur == start) break;
+	}
+	return CORRIDOR_FOUND;
+}
+
+void PathClusterGraph::MarkCorridorFailed(const SearchmapPoint &from, const SearchmapPoint &to, unsigned int size)
+{
+	int start = RegionAt(from);
+	int goal = RegionAt(to);
+	if (start >= 0 && goal >= 0) {
+		failedCorridors.emplace(start, goal, size);
+	}
+}
+
 // Find the best path of limited length that brings us the farthest from d
 PathNode *Map::RunAway(const Point &s, const Point &d, unsigned int size, int maxPathLength, bool backAway, const Actor *caller) const
 {
@@ -254,7 +456,16 @@ PathNode *Map::GetLine(const Point &p, int steps, unsigned int orient) const
 // target (the goal must be in sight of the end, if PF_SIGHT is specified)
 PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
 {
-	Log(DEBUG, "FindPath", "s = (%d, %d), d = (%d, %d), caller = %s, dist = %d, size = %d", s.x, s.y, d.x, d.y, caller ? caller->GetName(0) : "nullptr", minDistance, size);
+	FrameProfiler::Count(FrameProfiler::COUNT_PATHFINDING);
+	if (LogDebugEnabled("FindPath")) {
+		// formatted on the logging thread, so copy everything it needs
+		std::string name = caller ? caller->GetName(0) : "nullptr";
+		LogDeferred(DEBUG, "FindPath", [=]() {
+			StringBuffer buffer;
+			buffer.appendFormatted("s = (%d, %d), d = (%d, %d), caller = %s, dist = %d, size = %d", s.x, s.y, d.x, d.y, name.c_str(), minDistance, size);
+			return buffer.get();
+		});
+	}
 	NavmapPoint nmptDest = d;
 	NavmapPoint nmptSource = s;
 	if (!(GetBlockedInRadius(d.x, d.y, size) & PathMapFlags::PASSABLE)) {
@@ -265,102 +476,143 @@ PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsig
 		AdjustPositionNavmap(nmptDest);
 	}
 	if (minDistance < size && !(GetBlockedInRadius(nmptDest.x, nmptDest.y, size) & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR))) {
-		Log(DEBUG, "FindPath", "%s can't fit in destination", caller ? caller->GetName(0) : "nullptr");
+		if (LogDebugEnabled("FindPath")) {
+			std::string name = caller ? caller->GetName(0) : "nullptr";
+			LogDeferred(DEBUG, "FindPath", [name]() { return name + " can't fit in destination"; });
+		}
 		return nullptr;
 	}
 	SearchmapPoint smptSource(nmptSource.x / 16, nmptSource.y / 12);
 	SearchmapPoint smptDest(nmptDest.x / 16, nmptDest.y / 12);
 	if (smptDest == smptSource) return nullptr;
 
-	// Initialize data structures
-	FibonacciHeap<PQNode> open;
-	std::vector<bool> isClosed(Width * Height, false);
-	std::vector<NavmapPoint> parents(Width * Height, Point(0, 0));
-	std::vector<unsigned short> distFromStart(Width * Height, std::numeric_limits<unsigned short>::max());
-	distFromStart[smptSource.y * Width + smptSource.x] = 0;
-	parents[smptSource.y * Width + smptSource.x] = nmptSource;
-	open.emplace(PQNode(nmptSource, 0));
+	// Long searches first ask the cluster graph, which confines the search to
+	// a corridor. It can't tell that a big actor doesn't fit somewhere (or
+	// that it does, when the graph disagrees), so anything but a found
+	// corridor means searching the whole map
+	std::vector<bool> corridor;
+	bool restricted = false;
+	int clusterSpan = std::max(std::abs(smptDest.x - smptSource.x), std::abs(smptDest.y - smptSource.y)) / int(PathClusterGraph::CLUSTER_SIZE);
+	if (clusterSpan >= CLUSTER_SEARCH_MIN_SPAN) {
+		if (!pathClusters.IsValid()) {
+			pathClusters.Build(SrchMap, Width, Height);
+		}
+		PathClusterGraph::CorridorResult result = pathClusters.FindCorridor(smptSource, smptDest, size, corridor);
+		restricted = result == PathClusterGraph::CORRIDOR_FOUND;
+	}
+
+	PathfinderWorkspace &ws = pathWorkspace;
 	bool foundPath = false;
 	unsigned int squaredMinDist = minDistance * minDistance;
+	SearchmapPoint smptGoal = smptDest;
+	NavmapPoint nmptGoal = nmptDest;
+
+	while (true) {
+		// Initialize data structures
+		ws.Begin(Width * Height);
+		smptDest = smptGoal;
+		nmptDest = nmptGoal;
+		PathfinderWorkspace::Node &sourceNode = ws.Get(smptSource.y * Width + smptSource.x);
+		sourceNode.distFromStart = 0;
+		sourceNode.parent = nmptSource;
+		ws.Push(PQNode(nmptSource, 0));
+
+		while (!ws.open.empty()) {
+			NavmapPoint nmptCurrent = ws.Pop().point;
+			SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
+			PathfinderWorkspace::Node &current = ws.Get(smptCurrent.y * Width + smptCurrent.x);
+			if (current.parent.IsZero()) {
+				continue;
+			}
 
-	while (!open.empty()) {
-		NavmapPoint nmptCurrent = open.top().point;
-		open.pop();
-		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-		if (parents[smptCurrent.y * Width + smptCurrent.x] == Point(0, 0)) {
-			continue;
-		}
-
-		if (smptCurrent == smptDest) {
-			nmptDest = nmptCurrent;
-			foundPath = true;
-			break;
-		} else if (minDistance) {
-			if (parents[smptCurrent.y * Width + smptCurrent.x] != nmptCurrent &&
-					SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist) {
-				if (!(flags & PF_SIGHT) || IsVisibleLOS(nmptCurrent, d)) {
-					smptDest = smptCurrent;
-					nmptDest = nmptCurrent;
-					foundPath = true;
-					break;
+			if (smptCurrent == smptDest) {
+				nmptDest = nmptCurrent;
+				foundPath = true;
+				break;
+			} else if (minDistance) {
+				if (current.parent != nmptCurrent &&
+						SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist) {
+					if (!(flags & PF_SIGHT) || IsVisibleLOS(nmptCurrent, d)) {
+						smptDest = smptCurrent;
+						nmptDest = nmptCurrent;
+						foundPath = true;
+						break;
+					}
 				}
 			}
-		}
-		isClosed[smptCurrent.y * Width + smptCurrent.x] = true;
-
-		for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
-			NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
-			SearchmapPoint smptChild(nmptChild.x / 16, nmptChild.y / 12);
-			// Outside map
-			if (smptChild.x < 0 ||	smptChild.y < 0 || (unsigned) smptChild.x >= Width || (unsigned) smptChild.y >= Height) continue;
-			// Already visited
-			if (isClosed[smptChild.y * Width + smptChild.x]) continue;
-			// If there's an actor, check it can be bumped away
-			Actor* childActor = GetActor(nmptChild, GA_NO_DEAD|GA_NO_UNSCHEDULED);
-			bool childIsUnbumpable = childActor && childActor != caller && (flags & PF_ACTORS_ARE_BLOCKING || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
-			if (childIsUnbumpable) continue;
-
-			PathMapFlags childBlockStatus = GetBlockedInRadius(nmptChild.x, nmptChild.y, size);
-			bool childBlocked = !(childBlockStatus & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR | PathMapFlags::TRAVEL));
-			if (childBlocked) continue;
-
-			// Weighted heuristic. Finds sub-optimal paths but should be quite a bit faster
-			const float HEURISTIC_WEIGHT = 1.5;
-			SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-			NavmapPoint nmptParent = parents[smptCurrent.y * Width + smptCurrent.x];
-			unsigned short oldDist = distFromStart[smptChild.y * Width + smptChild.x];
-			// Theta-star path if there is LOS
-			if (IsWalkableTo(nmptParent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
-				SearchmapPoint smptParent(nmptParent.x / 16, nmptParent.y / 12);
-				unsigned short newDist = distFromStart[smptParent.y * Width + smptParent.x] + Distance(smptParent, smptChild);
-				if (newDist < oldDist) {
-					parents[smptChild.y * Width + smptChild.x] = nmptParent;
-					distFromStart[smptChild.y * Width + smptChild.x] = newDist;
+			current.closed = true;
+
+			for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
+				NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
+				SearchmapPoint smptChild(nmptChild.x / 16, nmptChild.y / 12);
+				// Outside map
+				if (smptChild.x < 0 ||	smptChild.y < 0 || (unsigned) smptChild.x >= Width || (unsigned) smptChild.y >= Height) continue;
+				PathfinderWorkspace::Node &child = ws.Get(smptChild.y * Width + smptChild.x);
+				// Already visited
+				if (child.closed) continue;
+				// Outside the corridor
+				if (restricted) {
+					int region = pathClusters.RegionAt(smptChild);
+					if (region >= 0 && !corridor[region]) continue;
 				}
-			// Fall back to A-star path
-			} else if (IsWalkableTo(nmptCurrent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
-				unsigned short newDist = distFromStart[smptCurrent.y * Width + smptCurrent.x] + Distance(smptCurrent, smptChild);
-				if (newDist < oldDist) {
-					parents[smptChild.y * Width + smptChild.x] = nmptCurrent;
-					distFromStart[smptChild.y * Width + smptChild.x] = newDist;
+				// All nodes in a cell share the same navmap position, so the
+				// actor and radius checks only need to be done once per cell
+				if (!child.probed) {
+					child.probed = true;
+					// If there's an actor, check it can be bumped away
+					Actor* childActor = GetActor(nmptChild, GA_NO_DEAD|GA_NO_UNSCHEDULED);
+					bool childIsUnbumpable = childActor && childActor != caller && (flags & PF_ACTORS_ARE_BLOCKING || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
+					if (childIsUnbumpable) {
+						child.blocked = true;
+					} else {
+						PathMapFlags childBlockStatus = GetBlockedInRadius(nmptChild.x, nmptChild.y, size);
+						child.blocked = !(childBlockStatus & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR | PathMapFlags::TRAVEL));
+					}
+				}
+				if (child.blocked) continue;
+
+				// Weighted heuristic. Finds sub-optimal paths but should be quite a bit faster
+				const float HEURISTIC_WEIGHT = 1.5;
+				NavmapPoint nmptParent = current.parent;
+				unsigned short oldDist = child.distFromStart;
+				// Theta-star path if there is LOS
+				if (IsWalkableTo(nmptParent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
+					SearchmapPoint smptParent(nmptParent.x / 16, nmptParent.y / 12);
+					unsigned short newDist = ws.Get(smptParent.y * Width + smptParent.x).distFromStart + Distance(smptParent, smptChild);
+					if (newDist < oldDist) {
+						child.parent = nmptParent;
+						child.distFromStart = newDist;
+					}
+				// Fall back to A-star path
+				} else if (IsWalkableTo(nmptCurrent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
+					unsigned short newDist = current.distFromStart + Distance(smptCurrent, smptChild);
+					if (newDist < oldDist) {
+						child.parent = nmptCurrent;
+						child.distFromStart = newDist;
+					}
 				}
-			}
 
-			if (distFromStart[smptChild.y * Width + smptChild.x] < oldDist) {
-				// Calculate heuristic
-				int xDist = smptChild.x - smptDest.x;
-				int yDist = smptChild.y - smptDest.y;
-				// Tie-breaking used to smooth out the path
-				int dxCross = smptDest.x - smptSource.x;
-				int dyCross = smptDest.y - smptSource.y;
-				int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
-				double distance = std::sqrt(xDist * xDist + yDist * yDist);
-				double heuristic = HEURISTIC_WEIGHT * (distance + crossProduct);
-				double estDist = distFromStart[smptChild.y * Width + smptChild.x] + heuristic;
-				PQNode newNode(nmptChild, estDist);
-				open.emplace(newNode);
+				if (child.distFromStart < oldDist) {
+					// Calculate heuristic
+					int xDist = smptChild.x - smptDest.x;
+					int yDist = smptChild.y - smptDest.y;
+					// Tie-breaking used to smooth out the path
+					int dxCross = smptDest.x - smptSource.x;
+					int dyCross = smptDest.y - smptSource.y;
+					int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
+					double distance = std::sqrt(xDist * xDist + yDist * yDist);
+					double heuristic = HEURISTIC_WEIGHT * (distance + crossProduct);
+					double estDist = child.distFromStart + heuristic;
+					ws.Push(PQNode(nmptChild, estDist));
+				}
 			}
 		}
+
+		if (foundPath || !restricted) break;
+		// actors or the caller's size can block the corridor, so retry
+		// unrestricted and don't bother with the corridor next time
+		pathClusters.MarkCorridorFailed(smptSource, smptGoal, size);
+		restricted = false;
 	}
 
 	if (foundPath) {
@@ -368,8 +620,8 @@ PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsig
 		NavmapPoint nmptCurrent = nmptDest;
 		NavmapPoint nmptParent;
 		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-		while (!resultPath || nmptCurrent != parents[smptCurrent.y * Width + smptCurrent.x]) {
-			nmptParent = parents[smptCurrent.y * Width + smptCurrent.x];
+		while (!resultPath || nmptCurrent != ws.Get(smptCurrent.y * Width + smptCurrent.x).parent) {
+			nmptParent = ws.Get(smptCurrent.y * Width + smptCurrent.x).parent;
 			PathNode *newStep = new PathNode;
 			newStep->x = nmptCurrent.x;
 			newStep->y = nmptCurrent.y;
@@ -390,10 +642,9 @@ PathNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsig
 			smptCurrent.y = nmptCurrent.y / 12;
 		}
 		return resultPath;
-	} else if (caller) {
-		Log(DEBUG, "FindPath", "Pathing failed for %s", caller->GetName(0));
-	} else {
-		Log(DEBUG, "FindPath", "Pathing failed");
+	} else if (LogDebugEnabled("FindPath")) {
+		std::string name = caller ? caller->GetName(0) : "";
+		LogDeferred(DEBUG, "FindPath", [name]() { return name.empty() ? std::string("Pathing failed") : "Pathing failed for " + name; });
 	}
 
 	return nullptr;
@@ -22,6 +22,11 @@
 
 #include "Region.h"
 
+#include <limits>
+#include <set>
+#include <tuple>
+#include <vector>
+
 namespace GemRB {
 
 //searchmap conversion bits
@@ -82,6 +87,81 @@ public:
 
 };
 
+// Per-map scratch space for Map::FindPath, kept between searches so that
+// a query doesn't have to allocate and clear several searchmap sized arrays.
+// Cells are stamped with the search they were last touched by, so anything
+// with an old stamp reads as unvisited.
+class GEM_EXPORT PathfinderWorkspace {
+public:
+	struct Node {
+		NavmapPoint parent;
+		unsigned short distFromStart = std::numeric_limits<unsigned short>::max();
+		bool closed = false;
+		// the actor and radius checks for this cell were done and their result cached
+		bool probed = false;
+		bool blocked = false;
+		unsigned int stamp = 0;
+	};
+
+	// min-heap of open nodes, see Push and Pop
+	std::vector<PQNode> open;
+
+	void Begin(size_t cells);
+	Node& Get(size_t idx);
+	void Push(const PQNode &node);
+	PQNode Pop();
+
+private:
+	std::vector<Node> nodes;
+	unsigned int search = 0;
+};
+
+// Coarse connectivity layer over the searchmap, in the spirit of HPA*.
+// The map is cut into clusters of CLUSTER_SIZE x CLUSTER_SIZE cells and each
+// cluster into the regions of walkable cells connected inside it. Regions that
+// touch across a cluster border are linked, which gives a small graph that
+// answers reachability and yields the corridor a detailed search can stay in.
+// Only static terrain and doors are considered, never actors, and cells are
+// judged on their own, while the detailed search looks at the whole footprint
+// of the actor. So the graph only ever narrows the search down, it never has
+// the final word on reachability.
+class GEM_EXPORT PathClusterGraph {
+public:
+	static const unsigned int CLUSTER_SIZE = 16;
+
+	enum CorridorResult {
+		CORRIDOR_UNUSED, // no opinion, search the whole map
+		CORRIDOR_FOUND,
+		CORRIDOR_UNREACHABLE
+	};
+
+	void Invalidate() { valid = false; }
+	bool IsValid() const { return valid; }
+	void Build(const PathMapFlags *srchMap, unsigned int width, unsigned int height);
+
+	// region id of a searchmap cell, -1 for cells that are never walkable
+	int RegionAt(const SearchmapPoint &p) const;
+	// marks the regions between the two cells (plus a one region margin) in corridor
+	CorridorResult FindCorridor(const SearchmapPoint &from, const SearchmapPoint &to, unsigned int size, std::vector<bool> &corridor) const;
+	// remembers that a corridor search failed, so the next ones between
+	// the same regions go straight to searching the whole map
+	void MarkCorridorFailed(const SearchmapPoint &from, const SearchmapPoint &to, unsigned int size);
+
+private:
+	struct ClusterRegion {
+		Point center; // in searchmap cells
+		std::vector<int> neighbours;
+	};
+
+	bool valid = false;
+	unsigned int width = 0;
+	unsigned int height = 0;
+	std::vector<int> regionMap;
+	std::vector<ClusterRegion> regions;
+	// start region, goal region, actor size
+	std::set<std::tuple<int, int, unsigned int>> failedCorridors;
+};
+
 }
 
 #endif
@@ -77,7 +77,7 @@ inline void ShaderAdditive(const Color& src, Color& dst) {
 }
 
 template <bool MASKED, bool SRCALPHA>
-struct OneMinusSrcA : RGBBlender {
+struct OneMinusSrcA final : RGBBlender {
 	void operator()(const Color& c, Color& dst, uint8_t mask) const override {
 		ShaderBlend<SRCALPHA>(c, dst);
 		if (MASKED) {
@@ -87,7 +87,7 @@ struct OneMinusSrcA : RGBBlender {
 };
 
 template <bool MASKED>
-struct TintDst : RGBBlender {
+struct TintDst final : RGBBlender {
 	void operator()(const Color& c, Color& dst, uint8_t mask) const override {
 		ShaderTint(c, dst);
 		if (MASKED) {
@@ -97,7 +97,7 @@ struct TintDst : RGBBlender {
 };
 
 template <bool MASKED>
-struct SrcRGBA : RGBBlender {
+struct SrcRGBA final : RGBBlender {
 	void operator()(const Color& c, Color& dst, uint8_t mask) const override {
 		dst = c;
 		if (MASKED) {
@@ -117,7 +117,7 @@ enum class SHADER {
 // using a template to avoid runtime branch evaluation
 // by optimizing down to a single case
 template <SHADER SHADE, bool SRCALPHA>
-class RGBBlendingPipeline : RGBBlender {
+class RGBBlendingPipeline final : RGBBlender {
 	Color tint;
 	unsigned int shift;
 	void (*blender)(const Color& src, Color& dst);
@@ -295,6 +295,99 @@ struct PixelIterator : IPixelIterator
 	}
 };
 
+// The compile time counterpart of PixelIterator: the pixel type and both directions
+// are template parameters and nothing is virtual, so loops over it can be inlined.
+// IPixelIterator is kept for code that only knows the format at runtime.
+// Like PixelIterator, 'p' is the first pixel visited and Position() is relative to the memory layout.
+template <typename PIXEL, IPixelIterator::Direction XDIR = IPixelIterator::Forward,
+		  IPixelIterator::Direction YDIR = IPixelIterator::Forward>
+struct TypedPixelIterator
+{
+	PIXEL* pixel;
+	uint8_t* row; // the first pixel visited in the current row
+	int pitch; // in bytes
+	Size size;
+	Point pos;
+
+	TypedPixelIterator(PIXEL* p, Size s, int pitch)
+	: pixel(p), row(reinterpret_cast<uint8_t*>(p)), pitch(pitch), size(s) {
+		assert(size.w >= 0); // == 0 is the same thing as an end iterator so it is valid too
+		pos.x = (XDIR == IPixelIterator::Reverse) ? size.w - 1 : 0;
+		pos.y = (YDIR == IPixelIterator::Reverse) ? size.h - 1 : 0;
+	}
+
+	// 'end' iterators are one past the end, see SDLPixelIterator::end
+	static TypedPixelIterator end(const TypedPixelIterator& beg) {
+		TypedPixelIterator it(beg);
+		it.Advance(beg.size.w * beg.size.h - (beg.size.w * beg.Row() + beg.Column()));
+		return it;
+	}
+
+	PIXEL& operator*() const {
+		return *pixel;
+	}
+
+	PIXEL* operator->() const {
+		return pixel;
+	}
+
+	uint8_t Channel(uint32_t mask, uint8_t shift) const {
+		return ((*pixel) & mask) >> shift;
+	}
+
+	TypedPixelIterator& operator++() {
+		if (Column() + 1 < size.w) {
+			pixel += XDIR;
+			pos.x += XDIR;
+		} else {
+			NextRow(1);
+		}
+		return *this;
+	}
+
+	bool operator!=(const TypedPixelIterator& rhs) const {
+		return pixel != rhs.pixel;
+	}
+
+	void Advance(int dx) {
+		if (dx == 0 || size.IsInvalid()) return;
+
+		int x = Column() + dx;
+		int rows = x / size.w;
+		x %= size.w;
+		if (x < 0) {
+			x += size.w;
+			--rows;
+		}
+		if (rows) {
+			NextRow(rows);
+		}
+		pixel = reinterpret_cast<PIXEL*>(row) + x * XDIR;
+		pos.x = (XDIR == IPixelIterator::Forward) ? x : size.w - 1 - x;
+	}
+
+	const Point& Position() const {
+		return pos;
+	}
+
+private:
+	// position in the order we visit the pixels
+	int Column() const {
+		return (XDIR == IPixelIterator::Forward) ? pos.x : size.w - 1 - pos.x;
+	}
+
+	int Row() const {
+		return (YDIR == IPixelIterator::Forward) ? pos.y : size.h - 1 - pos.y;
+	}
+
+	void NextRow(int rows) {
+		row += pitch * rows * YDIR;
+		pos.y += rows * YDIR;
+		pixel = reinterpret_cast<PIXEL*>(row);
+		pos.x = (XDIR == IPixelIterator::Forward) ? 0 : size.w - 1;
+	}
+};
+
 struct IAlphaIterator
 {
 	virtual ~IAlphaIterator() = default;
@@ -309,7 +402,7 @@ struct IAlphaIterator
 };
 
 // an endless iterator that always returns 'alpha' when dereferenced
-struct StaticAlphaIterator : public IAlphaIterator
+struct StaticAlphaIterator final : public IAlphaIterator
 {
 	uint8_t alpha;
 
@@ -341,6 +434,32 @@ struct RGBAChannelIterator : public IAlphaIterator
 	}
 };
 
+// RGBAChannelIterator over a TypedPixelIterator, without any virtual calls
+template <typename PIXELIT>
+struct TypedChannelIterator
+{
+	PIXELIT pixelIt;
+	uint32_t mask;
+	uint8_t shift;
+
+	TypedChannelIterator(const PIXELIT& it, uint32_t mask, uint8_t shift)
+	: pixelIt(it), mask(mask), shift(shift)
+	{}
+
+	uint8_t operator*() const {
+		return pixelIt.Channel(mask, shift);
+	}
+
+	TypedChannelIterator& operator++() {
+		++pixelIt;
+		return *this;
+	}
+
+	void Advance(int amt) {
+		pixelIt.Advance(amt);
+	}
+};
+
 }
 
 #endif // PIXELS_H
@@ -95,12 +95,12 @@ static inline voidvoid my_dlsym(void *handle, const char *symbol)
 #ifdef WIN32
 static void PrintDLError()
 {
-	Log(DEBUG, "PluginLoader", "Error code: %lu", GetLastError());
+	LogDebug("PluginLoader", "Error code: %lu", GetLastError());
 }
 #else
 static void PrintDLError()
 {
-	Log(DEBUG, "PluginLoader", "Error: %s", dlerror());
+	LogDebug("PluginLoader", "Error: %s", dlerror());
 }
 #endif
 
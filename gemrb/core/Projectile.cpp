@@ -466,14 +466,14 @@ Actor *Projectile::GetTarget()
 				Target = original->GetGlobalID();
 				target = original;
 			} else {
-				Log(DEBUG, "Projectile", "GetTarget: caster not found, bailing out!");
+				LogDebug("Projectile", "GetTarget: caster not found, bailing out!");
 				return NULL;
 			}
 		}
 		effects->SetOwner(original);
 		return target;
 	} else {
-		Log(DEBUG, "Projectile", "GetTarget: Target not set or dummy, using caster!");
+		LogDebug("Projectile", "GetTarget: Target not set or dummy, using caster!");
 	}
 	target = area->GetActorByGlobalID(Caster);
 	if (target) {
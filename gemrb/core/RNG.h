@@ -40,6 +40,8 @@ class GEM_EXPORT RNG {
 	std::mt19937_64 engine;
 	public:
 	static RNG& getInstance();
+	/** Restarts the sequence of the calling thread, for reproducible runs */
+	void Seed(uint64_t seed) { engine.seed(seed); }
 	
 	/**
 	 * It is possible to generate random numbers from [-min, +/-max].
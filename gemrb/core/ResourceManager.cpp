@@ -25,10 +25,15 @@
 #include "Resource.h"
 #include "ResourceDesc.h"
 #include "ResourceSource.h"
+#include "System/MemoryStream.h"
 #include "System/StringBuffer.h"
+#include "System/VFS.h"
 
 namespace GemRB {
 
+std::atomic<unsigned int> ResourceManager::filesGeneration { 0 };
+unsigned long ResourceManager::prefetchBudget = 64 * 1024 * 1024;
+
 ResourceManager::ResourceManager()
 {
 }
@@ -36,6 +41,17 @@ ResourceManager::ResourceManager()
 
 ResourceManager::~ResourceManager()
 {
+	if (prefetchThread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(prefetchLock);
+			stopPrefetch = true;
+		}
+		prefetchCond.notify_one();
+		prefetchThread.join();
+	}
+	for (auto& entry : prefetched) {
+		delete entry.second;
+	}
 }
 
 bool ResourceManager::AddSource(const char *path, const char *description, PluginID type, int flags)
@@ -56,9 +72,197 @@ bool ResourceManager::AddSource(const char *path, const char *description, Plugi
 	} else {
 		searchPath.push_back(source);
 	}
+	FilesChanged();
 	return true;
 }
 
+void ResourceManager::FilesChanged()
+{
+	filesGeneration++;
+}
+
+static std::string MissingKey(const char *ResRef, const char *ext)
+{
+	char key[_MAX_PATH];
+	snprintf(key, sizeof(key), "%s.%s", ResRef, ext ? ext : "");
+	strlwr(key);
+	return key;
+}
+
+static std::string MissingKey(const char *ResRef, const TypeID *type)
+{
+	// the type stands for several extensions, so key by its identity
+	char key[_MAX_PATH];
+	snprintf(key, sizeof(key), "%s*%p", ResRef, (const void *) type);
+	strlwr(key);
+	return key;
+}
+
+bool ResourceManager::KnownMissing(const std::string& key) const
+{
+	std::lock_guard<std::mutex> lock(missingLock);
+	stats.lookups++;
+	if (missingGeneration != filesGeneration) {
+		missing.clear();
+		missingGeneration = filesGeneration;
+		return false;
+	}
+	if (missing.count(key)) {
+		stats.missesCached++;
+		return true;
+	}
+	return false;
+}
+
+void ResourceManager::AddMissing(const std::string& key) const
+{
+	std::lock_guard<std::mutex> lock(missingLock);
+	if (missing.size() >= 4096) {
+		missing.clear();
+	}
+	missing.insert(key);
+}
+
+void ResourceManager::CountProbes(unsigned long sourceProbes, unsigned long pathProbesBefore) const
+{
+	std::lock_guard<std::mutex> lock(missingLock);
+	stats.sourceProbes += sourceProbes;
+	stats.pathProbes += GetPathProbeCount() - pathProbesBefore;
+}
+
+void ResourceManager::LogLookupStats() const
+{
+	if (!stats.lookups) return;
+	LogDebug("ResourceManager", "%lu lookups, %lu known misses, %.1f sources and %.1f file system probes per lookup",
+		stats.lookups, stats.missesCached, double(stats.sourceProbes) / stats.lookups,
+		double(stats.pathProbes) / stats.lookups);
+}
+
+void ResourceManager::SetPrefetchSize(int megabytes)
+{
+	prefetchBudget = std::max(0, megabytes) * 1024ul * 1024ul;
+}
+
+void ResourceManager::Prefetch(const std::vector<ResourceRequest>& list)
+{
+	if (!prefetchBudget || list.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(prefetchLock);
+		prefetchQueue.insert(prefetchQueue.end(), list.begin(), list.end());
+		if (!prefetchThread.joinable()) {
+			prefetchThread = std::thread(&ResourceManager::PrefetchWorker, this);
+		}
+	}
+	prefetchCond.notify_one();
+}
+
+void ResourceManager::DropPrefetched()
+{
+	std::lock_guard<std::mutex> lock(prefetchLock);
+	if (prefetched.empty() && prefetchQueue.empty()) return;
+
+	LogDebug("ResourceManager", "Prefetching served %lu lookups, dropping %lu entries (%lu bytes) and %lu queued",
+		prefetchHits, (unsigned long) prefetched.size(), prefetchedBytes, (unsigned long) prefetchQueue.size());
+	ForgetPrefetched();
+	prefetchQueue.clear();
+	prefetchHits = 0;
+}
+
+// needs prefetchLock held
+void ResourceManager::ForgetPrefetched() const
+{
+	for (auto& entry : prefetched) {
+		delete entry.second;
+	}
+	prefetched.clear();
+	prefetchedBytes = 0;
+	// whatever the worker is reading right now is discarded too
+	prefetchGeneration++;
+	havePrefetched = false;
+}
+
+// copies the stream into memory, unless it is memory already
+static DataStream* ReadAhead(DataStream* str)
+{
+	unsigned long size = str->Size();
+	if (!size) return NULL;
+
+	const void* mapped = str->Map(0, size);
+	if (mapped) {
+		// just fault the pages in, so the real load does not wait for the disk
+		const volatile unsigned char* bytes = static_cast<const unsigned char*>(mapped);
+		for (unsigned long i = 0; i < size; i += 4096) {
+			(void) bytes[i];
+		}
+		return NULL;
+	}
+
+	void* data = malloc(size);
+	if (str->Read(data, size) != int(size)) {
+		free(data);
+		return NULL;
+	}
+	MemoryStream* copy = new MemoryStream(str->originalfile, data, size);
+	// bif members are named after the resource, not the archive
+	strlcpy(copy->filename, str->filename, sizeof(copy->filename));
+	return copy;
+}
+
+void ResourceManager::PrefetchWorker()
+{
+	std::unique_lock<std::mutex> lock(prefetchLock);
+	while (true) {
+		prefetchCond.wait(lock, [this]() { return stopPrefetch || !prefetchQueue.empty(); });
+		if (stopPrefetch) break;
+
+		ResourceRequest request = prefetchQueue.front();
+		prefetchQueue.pop_front();
+		const std::string key = MissingKey(request.name.CString(), core->TypeExt(request.type));
+		if (prefetched.count(key)) continue;
+		unsigned int generation = prefetchGeneration;
+		unsigned int filesGenerationRead = filesGeneration;
+
+		lock.unlock();
+		DataStream* str = GetResource(request.name.CString(), request.type, true);
+		DataStream* copy = str ? ReadAhead(str) : NULL;
+		delete str;
+		lock.lock();
+
+		if (!copy) continue;
+		if (prefetchFilesGeneration != filesGeneration) {
+			ForgetPrefetched();
+			prefetchFilesGeneration = filesGeneration;
+		}
+		if (generation != prefetchGeneration || filesGenerationRead != prefetchFilesGeneration || prefetched.count(key) || prefetchedBytes + copy->Size() > prefetchBudget) {
+			delete copy;
+			continue;
+		}
+		prefetched[key] = copy;
+		prefetchedBytes += copy->Size();
+		havePrefetched = true;
+	}
+}
+
+DataStream* ResourceManager::GetPrefetched(const char *ResRef, const char *ext) const
+{
+	if (!havePrefetched) return NULL;
+
+	const std::string key = MissingKey(ResRef, ext);
+	std::lock_guard<std::mutex> lock(prefetchLock);
+	if (prefetchFilesGeneration != filesGeneration) {
+		// an override or cache file changed, the copies may be stale
+		ForgetPrefetched();
+		prefetchFilesGeneration = filesGeneration;
+		return NULL;
+	}
+	auto it = prefetched.find(key);
+	if (it == prefetched.end()) return NULL;
+	// kept around, areas often have several copies of the same creature
+	prefetchHits++;
+	return it->second->Clone();
+}
+
 static void PrintPossibleFiles(StringBuffer& buffer, const char* ResRef, const TypeID *type)
 {
 	const std::vector<ResourceDesc>& types = PluginMgr::Get()->GetResourceDesc(type);
@@ -71,11 +275,17 @@ bool ResourceManager::Exists(const char *ResRef, SClass_ID type, bool silent) co
 {
 	if (!ResRef || ResRef[0] == '\0')
 		return false;
-	// TODO: check various caches
-	for (size_t i = 0; i < searchPath.size(); i++) {
-		if (searchPath[i]->HasResource( ResRef, type )) {
-			return true;
+	const std::string key = MissingKey(ResRef, core->TypeExt(type));
+	if (!KnownMissing(key)) {
+		unsigned long pathProbes = GetPathProbeCount();
+		for (size_t i = 0; i < searchPath.size(); i++) {
+			if (searchPath[i]->HasResource( ResRef, type )) {
+				CountProbes(i + 1, pathProbes);
+				return true;
+			}
 		}
+		CountProbes(searchPath.size(), pathProbes);
+		AddMissing(key);
 	}
 	if (!silent) {
 		Log(WARNING, "ResourceManager", "'%s.%s' not found...",
@@ -88,14 +298,20 @@ bool ResourceManager::Exists(const char *ResRef, const TypeID *type, bool silent
 {
 	if (ResRef[0] == '\0')
 		return false;
-	// TODO: check various caches
-	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
-	for (size_t j = 0; j < types.size(); j++) {
-		for (size_t i = 0; i < searchPath.size(); i++) {
-			if (searchPath[i]->HasResource(ResRef, types[j])) {
-				return true;
+	const std::string key = MissingKey(ResRef, type);
+	if (!KnownMissing(key)) {
+		unsigned long pathProbes = GetPathProbeCount();
+		const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
+		for (size_t j = 0; j < types.size(); j++) {
+			for (size_t i = 0; i < searchPath.size(); i++) {
+				if (searchPath[i]->HasResource(ResRef, types[j])) {
+					CountProbes(j * searchPath.size() + i + 1, pathProbes);
+					return true;
+				}
 			}
 		}
+		CountProbes(types.size() * searchPath.size(), pathProbes);
+		AddMissing(key);
 	}
 	if (!silent) {
 		StringBuffer buffer;
@@ -111,15 +327,26 @@ DataStream* ResourceManager::GetResource(const char* ResRef, SClass_ID type, boo
 {
 	if (!ResRef || ResRef[0] == '\0')
 		return NULL;
-	for (size_t i = 0; i < searchPath.size(); i++) {
-		DataStream *ds = searchPath[i]->GetResource(ResRef, type);
-		if (ds) {
-			if (!silent) {
-				Log(MESSAGE, "ResourceManager", "Found '%s.%s' in '%s'.",
-					ResRef, core->TypeExt(type), searchPath[i]->GetDescription());
+	DataStream *ds = GetPrefetched(ResRef, core->TypeExt(type));
+	if (ds) {
+		return ds;
+	}
+	const std::string key = MissingKey(ResRef, core->TypeExt(type));
+	if (!KnownMissing(key)) {
+		unsigned long pathProbes = GetPathProbeCount();
+		for (size_t i = 0; i < searchPath.size(); i++) {
+			ds = searchPath[i]->GetResource(ResRef, type);
+			if (ds) {
+				CountProbes(i + 1, pathProbes);
+				if (!silent) {
+					Log(MESSAGE, "ResourceManager", "Found '%s.%s' in '%s'.",
+						ResRef, core->TypeExt(type), searchPath[i]->GetDescription());
+				}
+				return ds;
 			}
-			return ds;
 		}
+		CountProbes(searchPath.size(), pathProbes);
+		AddMissing(key);
 	}
 	if (!silent) {
 		Log(ERROR, "ResourceManager", "Couldn't find '%s.%s'.",
@@ -135,26 +362,46 @@ Resource* ResourceManager::GetResource(const char* ResRef, const TypeID *type, b
 	if (!silent) {
 		Log(MESSAGE, "ResourceManager", "Searching for '%s'...", ResRef);
 	}
-	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
-	for (size_t j = 0; j < types.size(); j++) {
-		for (size_t i = 0; i < searchPath.size(); i++) {
-			DataStream *str = searchPath[i]->GetResource(ResRef, types[j]);
-			if (!str && useCorrupt && core->UseCorruptedHack) {
-				// don't look at other paths if requested
-				core->UseCorruptedHack = false;
-				return NULL;
-			}
-			core->UseCorruptedHack = false;
+	const std::string key = MissingKey(ResRef, type);
+	if (!KnownMissing(key)) {
+		unsigned long pathProbes = GetPathProbeCount();
+		bool found = false;
+		const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
+		for (size_t j = 0; j < types.size(); j++) {
+			DataStream *str = GetPrefetched(ResRef, types[j].GetExt());
 			if (str) {
 				Resource *res = types[j].Create(str);
 				if (res) {
-					if (!silent) {
-						Log(MESSAGE, "ResourceManager", "Found '%s.%s' in '%s'.",
-							ResRef, types[j].GetExt(), searchPath[i]->GetDescription());
-					}
 					return res;
 				}
 			}
+			for (size_t i = 0; i < searchPath.size(); i++) {
+				str = searchPath[i]->GetResource(ResRef, types[j]);
+				if (!str && useCorrupt && core->UseCorruptedHack) {
+					// don't look at other paths if requested
+					core->UseCorruptedHack = false;
+					CountProbes(j * searchPath.size() + i + 1, pathProbes);
+					return NULL;
+				}
+				core->UseCorruptedHack = false;
+				if (str) {
+					found = true;
+					Resource *res = types[j].Create(str);
+					if (res) {
+						CountProbes(j * searchPath.size() + i + 1, pathProbes);
+						if (!silent) {
+							Log(MESSAGE, "ResourceManager", "Found '%s.%s' in '%s'.",
+								ResRef, types[j].GetExt(), searchPath[i]->GetDescription());
+						}
+						return res;
+					}
+				}
+			}
+		}
+		CountProbes(types.size() * searchPath.size(), pathProbes);
+		// files that exist but failed to load are not missing
+		if (!found) {
+			AddMissing(key);
 		}
 	}
 	if (!silent) {
@@ -25,7 +25,16 @@
 #include "exports.h"
 
 #include "Holder.h"
-
+#include "Resource.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #if defined(_MSC_VER) || defined(__sgi) // No SFINAE
@@ -37,12 +46,16 @@ namespace GemRB {
 #define RM_REPLACE_SAME_SOURCE 1
 
 class DataStream;
-class Resource;
 #ifndef __sgi
 class ResourceSource;
 #endif
 class TypeID;
 
+struct ResourceRequest {
+	ResRef name;
+	SClass_ID type;
+};
+
 class GEM_EXPORT ResourceManager {
 public:
 	ResourceManager();
@@ -67,8 +80,59 @@ public:
 	/** Returns Resource object associated to given resource */
 	Resource* GetResource(const char* resname, const TypeID *type, bool silent = false, bool useCorrupt = false) const;
 
+	/** Forgets all remembered lookup misses, call when files were added to a search path */
+	static void FilesChanged();
+	/** Changes whenever files were added to a search path, so caches can tell they may be stale */
+	static unsigned int GetFilesGeneration() { return filesGeneration; }
+	void LogLookupStats() const;
+
+	/** Reads the resources into memory on a worker thread, lookups are then served from there */
+	void Prefetch(const std::vector<ResourceRequest>& list);
+	/** Forgets the prefetched resources and cancels the pending ones */
+	void DropPrefetched();
+	static void SetPrefetchSize(int megabytes);
+
 private:
 	std::vector<Holder<ResourceSource> > searchPath;
+
+	// most lookups go through several sources before hitting the bifs or failing,
+	// so remember the resources that are nowhere to be found
+	// the ambient sound thread does lookups too
+	mutable std::mutex missingLock;
+	mutable std::unordered_set<std::string> missing;
+	mutable unsigned int missingGeneration = 0;
+	static std::atomic<unsigned int> filesGeneration;
+
+	struct LookupStats {
+		unsigned long lookups = 0;
+		unsigned long missesCached = 0;
+		unsigned long sourceProbes = 0;
+		unsigned long pathProbes = 0;
+	};
+	mutable LookupStats stats;
+
+	// streams read ahead by the worker, keyed like the misses
+	mutable std::mutex prefetchLock;
+	std::condition_variable prefetchCond;
+	std::deque<ResourceRequest> prefetchQueue;
+	// lookups drop them once the files they were read from changed
+	mutable std::unordered_map<std::string, DataStream*> prefetched;
+	mutable std::atomic<bool> havePrefetched { false };
+	mutable unsigned long prefetchedBytes = 0;
+	mutable unsigned int prefetchGeneration = 0;
+	mutable unsigned int prefetchFilesGeneration = 0;
+	mutable unsigned long prefetchHits = 0;
+	bool stopPrefetch = false;
+	std::thread prefetchThread;
+	static unsigned long prefetchBudget;
+
+	void PrefetchWorker();
+	void ForgetPrefetched() const;
+	DataStream* GetPrefetched(const char *ResRef, const char *ext) const;
+
+	bool KnownMissing(const std::string& key) const;
+	void AddMissing(const std::string& key) const;
+	void CountProbes(unsigned long sourceProbes, unsigned long pathProbesBefore) const;
 };
 
 }
@@ -471,6 +471,11 @@ Actor::Actor()
 	nextComment = 100 + RAND(0, 350); // 7-30s delay
 	nextBored = 0;
 	FatigueComplaintDelay = 0;
+	effectsDirty = true;
+	refreshingEffects = false;
+	effectsStableUntil = 0;
+	effectsFingerprint = 0;
+	effectsDifficulty = 0;
 
 	inventory.SetInventoryType(INVENTORY_CREATURE);
 
@@ -665,7 +670,7 @@ void Actor::SetAnimationID(unsigned int AnimID)
 			snprintf(animHex, 10, "0x%04X", AnimID);
 			row = extspeed->FindTableValue((unsigned int) 0, animHex);
 			if (row != -1) {
-				int rate = atoi(extspeed->QueryField(row, 1));
+				int rate = extspeed->QueryFieldSigned(row, 1);
 				SetBase(IE_MOVEMENTRATE, rate);
 			}
 		} else {
@@ -849,7 +854,7 @@ static int GetIWD2KitIndex (ieDword kit, ieDword baseclass=0, bool strict=false)
 			if (kit & (*it)) return class2kits[baseclass].indices[idx];
 		}
 		if (strict) return -1;
-		Log(DEBUG, "Actor", "GetIWD2KitIndex: didn't find kit %d at expected class %d, recalculating!", kit, baseclass);
+		LogDebug("Actor", "GetIWD2KitIndex: didn't find kit %d at expected class %d, recalculating!", kit, baseclass);
 	}
 
 	// no class info passed, so infer it
@@ -2233,7 +2238,7 @@ static void InitActorTables()
 			buffer.appendFormatted("ToHit: %s ", tohit);
 			buffer.appendFormatted("XPCap: %d", xpcap[classis]);
 
-			Log(DEBUG, "Actor", buffer);
+			LogDebug("Actor", buffer);
 		}
 	} else {
 		AutoTable hptm;
@@ -2263,7 +2268,7 @@ static void InitActorTables()
 			//i.e. barbarians would overwrite fighters in bg2
 			if (levelslots[tmpindex]) {
 				buffer.appendFormatted("Already Found!");
-				Log(DEBUG, "Actor", buffer);
+				LogDebug("Actor", buffer);
 				continue;
 			}
 
@@ -2299,7 +2304,7 @@ static void InitActorTables()
 						if (tmphp) maxLevelForHpRoll[tmpindex] = tmphp;
 					}
 				}
-				Log(DEBUG, "Actor", buffer);
+				LogDebug("Actor", buffer);
 				continue;
 			}
 
@@ -2377,7 +2382,7 @@ static void InitActorTables()
 			buffer.appendFormatted("HPROLLMAXLVL: %d ", maxLevelForHpRoll[tmpindex]);
 			buffer.appendFormatted("DS: %d ", dualswap[tmpindex]);
 			buffer.appendFormatted("MULTI: %d", multi[tmpindex]);
-			Log(DEBUG, "Actor", buffer);
+			LogDebug("Actor", buffer);
 		}
 		/*this could be enabled to ensure all levelslots are filled with at least 0's;
 		*however, the access code should ensure this never happens
@@ -2919,6 +2924,8 @@ bool Actor::SetStat(unsigned int StatIndex, ieDword Value, int pcf)
 	unsigned int previous = GetSafeStat(StatIndex);
 	if (Modified[StatIndex]!=Value) {
 		Modified[StatIndex] = Value;
+		// the next refresh would overwrite this, so don't skip it
+		ModifiedStatChanged();
 	}
 	if (previous!=Value) {
 		if (pcf) {
@@ -2958,6 +2965,9 @@ bool Actor::SetBase(unsigned int StatIndex, ieDword Value)
 
 	//maximize the base stat
 	Value = ClampStat(StatIndex, Value);
+	if (BaseStats[StatIndex] != Value) {
+		effectsDirty = true;
+	}
 	BaseStats[StatIndex] = Value;
 
 	//if already initialized, then the modified stats
@@ -2975,6 +2985,9 @@ bool Actor::SetBaseNoPCF(unsigned int StatIndex, ieDword Value)
 
 	//maximize the base stat
 	Value = ClampStat(StatIndex, Value);
+	if (BaseStats[StatIndex] != Value) {
+		effectsDirty = true;
+	}
 	BaseStats[StatIndex] = Value;
 
 	//if already initialized, then the modified stats
@@ -2988,11 +3001,15 @@ bool Actor::SetBaseBit(unsigned int StatIndex, ieDword Value, bool setreset)
 	if (StatIndex >= MAX_STATS) {
 		return false;
 	}
+	ieDword previous = BaseStats[StatIndex];
 	if (setreset) {
 		BaseStats[StatIndex] |= Value;
 	} else {
 		BaseStats[StatIndex] &= ~Value;
 	}
+	if (BaseStats[StatIndex] != previous) {
+		effectsDirty = true;
+	}
 	//if already initialized, then the modified stats
 	//need to run the post change function (stat change can kill actor)
 	if (setreset) {
@@ -3095,6 +3112,7 @@ void Actor::CheckPuppet(Actor *puppet, ieDword type)
 	}
 	Modified[IE_PUPPETTYPE] = type;
 	Modified[IE_PUPPETID] = puppet->GetGlobalID();
+	ModifiedStatChanged();
 }
 
 
@@ -3112,6 +3130,10 @@ void Actor::RefreshEffects(EffectQueue *fx)
 	memset(BardSong,0,sizeof(ieResRef));
 	memset(projectileImmunity,0,ProjectileSize*sizeof(ieDword));
 
+	// anything changed from here on needs yet another refresh
+	effectsDirty = false;
+	refreshingEffects = true;
+
 	//initialize base stats
 	bool first = !(InternalFlags&IF_INITIALIZED);
 
@@ -3292,6 +3314,86 @@ void Actor::RefreshEffects(EffectQueue *fx)
 	if (Immobile()) {
 		timeStartStep = core->GetGame()->Ticks;
 	}
+
+	refreshingEffects = false;
+	effectsStableUntil = fxqueue.GetStableUntil();
+	effectsFingerprint = fxqueue.GetFingerprint();
+	effectsDifficulty = GameDifficulty;
+}
+
+bool Actor::EffectsSettled() const
+{
+	if (effectsDirty || !(InternalFlags & IF_INITIALIZED)) {
+		return false;
+	}
+	const Game *game = core->GetGame();
+	if (game->GameTime >= effectsStableUntil || fxqueue.GetFingerprint() != effectsFingerprint) {
+		return false;
+	}
+	// RefreshPCStats adds a luck bonus based on it
+	if (effectsDifficulty != GameDifficulty) {
+		return false;
+	}
+	// delayed hp adjustment, puppets and pst disguises are resolved by the full refresh
+	if (checkHP || Modified[IE_PUPPETID]) {
+		return false;
+	}
+	if (pstflags && Modified[IE_SEX] != BaseStats[IE_SEX]) {
+		return false;
+	}
+	for (const TriggerEntry& trigger : triggers) {
+		if (!(trigger.flags & TEF_PROCESSED_EFFECTS)) {
+			return false;
+		}
+	}
+	if (HasPlayerClass()) {
+		// fatigue, morale recovery and constitution regeneration all tick with game time
+		if (InParty || GetConHealAmount()) {
+			return false;
+		}
+		if (GetStat(IE_MORALERECOVERYTIME) && BaseStats[IE_MORALE] != 10 && ShouldModifyMorale()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// called every tick; effects, equipment and base stat changes mark the actor dirty,
+// otherwise only actors with time dependent effects get the full treatment
+void Actor::UpdateEffects()
+{
+	if (!EffectsSettled()) {
+		RefreshEffects(NULL);
+		return;
+	}
+
+	if (core->InDebugMode(ID_EFFECTS)) {
+		// cross-check against the full path
+		ieDword settled[MAX_STATS];
+		memcpy(settled, Modified, MAX_STATS * sizeof(ieDword));
+		RefreshEffects(NULL);
+		for (int i = 0; i < MAX_STATS; ++i) {
+			if (settled[i] != Modified[i]) {
+				Log(WARNING, "Actor", "%s: stat %d was %u instead of %u after skipping the effect refresh!",
+					GetScriptName(), i, settled[i], Modified[i]);
+			}
+		}
+		return;
+	}
+
+	// the effect independent bits of RefreshEffects
+	CharAnimations* anims = GetAnims();
+	if (anims) {
+		anims->CheckColorMod();
+	}
+	if (BaseStats[IE_STATE_ID] & STATE_PETRIFIED) {
+		SetLockedPalette(fullstone);
+	} else if (BaseStats[IE_STATE_ID] & STATE_FROZEN) {
+		SetLockedPalette(fullwhite);
+	}
+	if (Immobile()) {
+		timeStartStep = core->GetGame()->Ticks;
+	}
 }
 
 int Actor::GetProficiency(int proftype) const
@@ -3452,7 +3554,11 @@ void Actor::RefreshPCStats() {
 			if (warriorLevel) {
 				int mod = Modified[IE_NUMBEROFATTACKS] - BaseStats[IE_NUMBEROFATTACKS];
 				int bonus = gamedata->GetWeaponStyleAPRBonus(stars, warriorLevel - 1);
-				BaseStats[IE_NUMBEROFATTACKS] = defaultattacks + bonus;
+				if (BaseStats[IE_NUMBEROFATTACKS] != ieDword(defaultattacks + bonus)) {
+					// the effects were applied to the old base, so refresh once more
+					BaseStats[IE_NUMBEROFATTACKS] = defaultattacks + bonus;
+					effectsDirty = true;
+				}
 				if (GetAttackStyle() == WEAPON_RANGED) { // FIXME: should actually check if a set-apr opcode variant was used
 					Modified[IE_NUMBEROFATTACKS] += bonus; // no default
 				} else {
@@ -3514,7 +3620,10 @@ void Actor::RefreshPCStats() {
 				LayOnHandsAmount *= mod;
 			}
 		}
-		BaseStats[IE_LAYONHANDSAMOUNT] = LayOnHandsAmount;
+		if (BaseStats[IE_LAYONHANDSAMOUNT] != LayOnHandsAmount) {
+			BaseStats[IE_LAYONHANDSAMOUNT] = LayOnHandsAmount;
+			effectsDirty = true;
+		}
 		Modified[IE_LAYONHANDSAMOUNT] = LayOnHandsAmount;
 	}
 
@@ -4406,6 +4515,7 @@ void Actor::Panic(const Scriptable *attacker, int panicmode)
 	case PANIC_BERSERK:
 		action = GenerateAction( "Berserk()" );
 		BaseStats[IE_CHECKFORBERSERK]=3;
+		SetEffectsDirty();
 		//SetBaseBit(IE_STATE_ID, STATE_BERSERK, true);
 		break;
 	default:
@@ -6967,13 +7077,13 @@ bool Actor::GetCombatDetails(int &tohit, bool leftorright, WeaponInfo& wi, ITMEx
 	// but everyone is proficient with fists
 	// cheesily limited to party only (10gob hits it - practically can't hit you otherwise)
 	if (InParty && !inventory.FistsEquipped()) {
-		prof += atoi(wspecial->QueryField(stars, 0));
+		prof += wspecial->QueryFieldSigned(stars, 0);
 	}
 
-	wi.profdmgbon = atoi(wspecial->QueryField(stars, 1));
+	wi.profdmgbon = wspecial->QueryFieldSigned(stars, 1);
 	DamageBonus += wi.profdmgbon;
 	// only bg2 wspecial.2da has this column, but all have 0 as the default table value, so this lookup is fine
-	speed += atoi(wspecial->QueryField(stars, 2));
+	speed += wspecial->QueryFieldSigned(stars, 2);
 	// add non-proficiency penalty, which is missing from the table in non-iwd2
 	// stored negative
 	if (stars == 0 && !third) {
@@ -7374,9 +7484,10 @@ void Actor::PerformAttack(ieDword gameTime)
 	ieDword state = GetStat(IE_STATE_ID);
 	if (state&STATE_BERSERK) {
 		BaseStats[IE_CHECKFORBERSERK]=3;
+		SetEffectsDirty();
 	}
 
-	Log(DEBUG, "Actor", "Performattack for %s, target is: %s", ShortName, target->ShortName);
+	LogDebug("Actor", "Performattack for %s, target is: %s", ShortName, target->ShortName);
 
 	//which hand is used
 	//we do apr - attacksleft so we always use the main hand first
@@ -7603,7 +7714,7 @@ void Actor::PerformAttack(ieDword gameTime)
 	ModifyWeaponDamage(wi, target, damage, critical);
 
 	if (third && target->GetStat(IE_MC_FLAGS) & MC_INVULNERABLE) {
-		Log(DEBUG, "Actor", "Attacking invulnerable target, nulifying damage!");
+		LogDebug("Actor", "Attacking invulnerable target, nulifying damage!");
 		damage = 0;
 	}
 
@@ -7759,7 +7870,7 @@ void Actor::ModifyDamage(Scriptable *hitter, int &damage, int &resisted, int dam
 				// avoid buggy data
 				if ((unsigned)abs(resistance) > maximum_values[it->second.resist_stat]) {
 					resistance = 0;
-					Log(DEBUG, "ModifyDamage", "Ignoring bad damage resistance value (%d).", resistance);
+					LogDebug("ModifyDamage", "Ignoring bad damage resistance value (%d).", resistance);
 				}
 				resisted += (int) (damage * resistance/100.0);
 				damage -= resisted;
@@ -10164,7 +10275,7 @@ void Actor::CreateDerivedStatsBG()
 			if (tm)	{
 				ieDword cols = tm->GetColumnCount();
 				if (backstabdamagemultiplier >= cols) backstabdamagemultiplier = cols;
-				backstabdamagemultiplier = atoi(tm->QueryField(0, backstabdamagemultiplier));
+				backstabdamagemultiplier = tm->QueryFieldUnsigned(0, backstabdamagemultiplier);
 			} else {
 				backstabdamagemultiplier = (backstabdamagemultiplier+7)/4;
 			}
@@ -10247,6 +10358,7 @@ void Actor::ResetMC()
 void Actor::CreateDerivedStats()
 {
 	ResetMC();
+	SetEffectsDirty();
 
 	if (third) {
 		CreateDerivedStatsIWD2();
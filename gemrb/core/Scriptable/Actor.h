@@ -425,6 +425,12 @@ private:
 	tick_t LastFatigueCheck;
 	tick_t remainingTalkSoundTime;
 	tick_t lastTalkTimeCheckAt;
+	/* incremental stat refresh bookkeeping, see UpdateEffects */
+	bool effectsDirty;
+	bool refreshingEffects;
+	ieDword effectsStableUntil;
+	ieDword effectsFingerprint;
+	ieDword effectsDifficulty;
 	/** paint the actor itself. Called internally by Draw() */
 	void DrawActorSprite(const Point& p, BlitFlags flags,
 						 const std::vector<AnimationPart>& anims, const Color& tint) const;
@@ -450,6 +456,8 @@ private:
 	/** Re/Inits the Modified vector for PCs/NPCs */
 	void RefreshPCStats();
 	void RefreshHP();
+	/** true if a full RefreshEffects would leave the Modified vector unchanged */
+	bool EffectsSettled() const;
 	bool ShouldDrawCircle() const;
 	bool HasBodyHeat() const;
 	void SetupFistData() const;
@@ -500,6 +508,12 @@ public:
 	void CheckPuppet(Actor *puppet, ieDword type);
 	/** Re/Inits the Modified vector */
 	void RefreshEffects(EffectQueue *eqfx);
+	/** Per tick variant of RefreshEffects, skipped when nothing changed */
+	void UpdateEffects();
+	/** Forces a full refresh on the next UpdateEffects */
+	void SetEffectsDirty() { effectsDirty = true; }
+	/** Call after writing Modified directly, which only a refresh may do unnoticed */
+	void ModifiedStatChanged() { if (!refreshingEffects) effectsDirty = true; }
 	/** gets saving throws */
 	void RollSaves();
 	/** returns a saving throw */
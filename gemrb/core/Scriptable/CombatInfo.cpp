@@ -101,8 +101,9 @@ void ArmorClass::RefreshTotal()
 {
 	total = natural + deflectionBonus + armorBonus + shieldBonus + dexterityBonus + wisdomBonus + genericBonus;
 	// add a maximum_values[IE_ARMORCLASS] check here if needed
-	if (Owner) { // not true for a short while during init, but we make amends immediately
+	if (Owner && Owner->Modified[IE_ARMORCLASS] != ieDword(total)) { // not true for a short while during init, but we make amends immediately
 		Owner->Modified[IE_ARMORCLASS] = total;
+		Owner->ModifiedStatChanged();
 	}
 }
 
@@ -220,8 +221,9 @@ int ToHitStats::GetTotal() const
 void ToHitStats::RefreshTotal()
 {
 	total = base + proficiencyBonus + armorBonus + shieldBonus + abilityBonus + weaponBonus + genericBonus + fxBonus;
-	if (Owner) { // not true for a short while during init, but we make amends immediately
+	if (Owner && Owner->Modified[IE_TOHIT] != ieDword(total)) { // not true for a short while during init, but we make amends immediately
 		Owner->Modified[IE_TOHIT] = total;
+		Owner->ModifiedStatChanged();
 	}
 }
 
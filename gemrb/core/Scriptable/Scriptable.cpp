@@ -118,9 +118,11 @@ Scriptable::Scriptable(ScriptableType type)
 	LastSpellOnMe = 0xffffffff;
 	ResetCastingState(NULL);
 	InterruptCasting = false;
-	locals = new Variables();
+	// most scriptables have few or no locals, the table grows as needed
+	locals = new Variables(10, 17);
 	locals->SetType( GEM_VARIABLES_INT );
 	locals->ParseKey( 1 );
+	locals->InternKeys();
 	ClearTriggers();
 	AddTrigger(TriggerEntry(trigger_oncreation));
 
@@ -1579,6 +1581,7 @@ bool Scriptable::HandleHardcodedSurge(ieResRef surgeSpellRef, Spell *spl, Actor
 				CopyResRef(SpellResRef, newspl);
 			}
 			caster->Modified[IE_FORCESURGE] = tmp;
+			caster->ModifiedStatChanged();
 			break;
 		case '4': // change the target type to param1
 			strtok(surgeSpellRef,".");
@@ -2214,7 +2217,7 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 				NewOrientation = Orientation;
 				// Do not call ReleaseCurrentAction() since other actions
 				// than MoveToPoint can cause movement
-				Log(DEBUG, "PathFinderWIP", "Abandoning because I'm close to the goal");
+				LogDebug("PathFinderWIP", "Abandoning because I'm close to the goal");
 				pathAbandoned = true;
 				return;
 			}
@@ -2241,6 +2244,7 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 		Pos.x += dx;
 		Pos.y += dy;
 		oldPos = Pos;
+		area->ActorMoved(this);
 		if (actor && BlocksSearchMap()) {
 			area->BlockSearchMap(Pos, size, actor->IsPartyMember() ? PathMapFlags::PC : PathMapFlags::NPC);
 		}
@@ -2308,7 +2312,7 @@ void Movable::WalkTo(const Point &Des, int distance)
 	prevTicks = Ticks;
 	Destination = Des;
 	if (pathAbandoned) {
-		Log(DEBUG, "WalkTo", "%s: Path was just abandoned", GetName(0));
+		LogDebug("WalkTo", "%s: Path was just abandoned", GetName(0));
 		ClearPath(true);
 		return;
 	}
@@ -2321,7 +2325,7 @@ void Movable::WalkTo(const Point &Des, int distance)
 	if (BlocksSearchMap()) area->ClearSearchMapFor(this);
 	PathNode *newPath = area->FindPath(Pos, Des, size, distance, PF_SIGHT|PF_ACTORS_ARE_BLOCKING, actor);
 	if (!newPath && actor && actor->ValidTarget(GA_CAN_BUMP)) {
-		Log(DEBUG, "WalkTo", "%s re-pathing ignoring actors", GetName(0));
+		LogDebug("WalkTo", "%s re-pathing ignoring actors", GetName(0));
 		newPath = area->FindPath(Pos, Des, size, distance, PF_SIGHT, actor);
 	}
 
@@ -2421,6 +2425,7 @@ void Movable::MoveTo(const Point &Des)
 	Pos = Des;
 	oldPos = Des;
 	Destination = Des;
+	area->ActorMoved(this);
 	if (BlocksSearchMap()) {
 		area->BlockSearchMap( Pos, size, IsPC()?PathMapFlags::PC:PathMapFlags::NPC);
 	}
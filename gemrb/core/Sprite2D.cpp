@@ -42,6 +42,11 @@ Sprite2D::Sprite2D(const Sprite2D &obj)
 
 	pixels = obj.pixels;
 	freePixels = false;
+	if (obj.pixelOwner) {
+		pixelOwner = obj.pixelOwner;
+	} else {
+		pixelOwner = const_cast<Sprite2D*>(&obj);
+	}
 }
 
 Sprite2D::~Sprite2D()
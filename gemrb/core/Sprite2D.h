@@ -53,6 +53,9 @@ public:
 protected:
 	bool freePixels;
 	void* pixels;
+	// copies borrow the pixels, so they keep the sprite that owns them alive
+	// (and thereby marked as in use for the factory caches)
+	Holder<Sprite2D> pixelOwner;
 
 public:
 	Region Frame;
@@ -21,6 +21,8 @@
 #include "System/DataStream.h"
 
 #include "errors.h"
+
+#include <atomic>
 #include <ctype.h>
 
 namespace GemRB {
@@ -30,6 +32,10 @@ static const char* GEM_ENCRYPTION_KEY = "\x88\xa8\x8f\xba\x8a\xd3\xb9\xf5\xed\xb
 const static ieWord endiantest = 1;
 bool DataStream::IsBigEndian = ((char *)&endiantest)[1] == 1;
 
+// streams are also read from the audio threads
+static std::atomic<unsigned long long> bytesCopied(0);
+static std::atomic<unsigned long long> bytesMapped(0);
+
 DataStream::DataStream(void)
 {
 	Pos = size = 0;
@@ -73,6 +79,31 @@ void DataStream::ReadDecrypted(void* buf, unsigned long size)
 		( ( unsigned char * ) buf )[i] ^= GEM_ENCRYPTION_KEY[( Pos + i ) & 63];
 }
 
+const void* DataStream::Map(unsigned long /*offset*/, unsigned long /*len*/)
+{
+	return NULL;
+}
+
+void DataStream::CountCopied(unsigned long bytes)
+{
+	bytesCopied += bytes;
+}
+
+void DataStream::CountMapped(unsigned long bytes)
+{
+	bytesMapped += bytes;
+}
+
+unsigned long long DataStream::BytesCopied()
+{
+	return bytesCopied;
+}
+
+unsigned long long DataStream::BytesMapped()
+{
+	return bytesMapped;
+}
+
 void DataStream::Rewind()
 {
 	Seek( Encrypted ? 2 : 0, GEM_STREAM_START );
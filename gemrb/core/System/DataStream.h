@@ -48,6 +48,8 @@ protected:
 	bool Encrypted;
 
 	static bool IsBigEndian;
+	static void CountCopied(unsigned long bytes);
+	static void CountMapped(unsigned long bytes);
 public:
 	char filename[16]; //8+1+3+1 padded to dword
 	char originalfile[_MAX_PATH];
@@ -75,6 +77,15 @@ public:
 	/** Endian Switch setup */
 	static void SetBigEndian(bool be);
 	static bool BigEndian();
+	/** Returns a pointer to len bytes at offset, without copying them.
+	 *  It stays valid as long as the stream lives. Returns NULL if the
+	 *  stream has no stable backing memory (or is encrypted), in which case
+	 *  the caller has to fall back to Read.
+	 **/
+	virtual const void* Map(unsigned long offset, unsigned long len);
+	/** Bytes copied out by Read and bytes handed out by Map, for profiling */
+	static unsigned long long BytesCopied();
+	static unsigned long long BytesMapped();
 	/** Create a copy of this stream.
 	 *
 	 *  Returns NULL on failure.
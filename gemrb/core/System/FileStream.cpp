@@ -21,6 +21,7 @@
 #include "System/FileStream.h"
 
 #include "Interface.h"
+#include "ResourceManager.h"
 
 namespace GemRB {
 
@@ -121,6 +122,8 @@ bool FileStream::Create(const char *path)
 	if (!str.OpenNew(originalfile)) {
 		return false;
 	}
+	// the new file may be a resource that was looked up in vain before
+	ResourceManager::FilesChanged();
 	opened = true;
 	created = true;
 	Pos = 0;
@@ -146,6 +149,7 @@ int FileStream::Read(void* dest, unsigned int length)
 		ReadDecrypted( dest, c );
 	}
 	Pos += c;
+	CountCopied(c);
 	return c;
 }
 
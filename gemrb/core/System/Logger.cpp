@@ -56,6 +56,7 @@ void Logger::ProcessMessages(QueueType queue)
 {
 	std::lock_guard<std::mutex> l(writerLock);
 	while (queue.size()) {
+		queue.front().Format();
 		for (const auto& writer : writers) {
 			writer->WriteLogMessage(queue.front());
 		}
@@ -76,6 +77,7 @@ void Logger::LogMsg(LogMessage&& msg)
 	
 	if (msg.level == FATAL) {
 		// fatal errors must happen now!
+		msg.Format();
 		std::lock_guard<std::mutex> l(writerLock);
 		for (const auto& writer : writers) {
 			writer->WriteLogMessage(std::move(msg));
@@ -30,6 +30,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -74,9 +75,18 @@ public:
 		std::string owner;
 		std::string message;
 		log_color color = DEFAULT;
+		// if set, produces the message on the logging thread
+		std::function<std::string()> format;
 		
 		LogMessage(log_level level, std::string owner, std::string message, log_color color = DEFAULT)
 		: level(level), owner(std::move(owner)), message(std::move(message)), color(color) {}
+
+		void Format() {
+			if (format) {
+				message = format();
+				format = nullptr;
+			}
+		}
 	};
 
 	class LogWriter {
@@ -30,7 +30,10 @@
 #else
 #  include <cstdarg>
 #endif
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #ifndef STATIC_LINK
@@ -43,6 +46,15 @@ namespace GemRB {
 using LogMessage = Logger::LogMessage;
 
 static std::atomic<log_level> CWLL;
+static std::atomic<log_level> logLevel(DEBUG);
+
+// per owner overrides, set while reading the config and checked for every
+// message, so readers get an immutable snapshot without locking
+using OwnerLevels = std::vector<std::pair<std::string, log_level>>;
+static std::atomic<const OwnerLevels*> ownerLevels(nullptr);
+// replaced snapshots may still be read, so they are kept until exit
+static std::vector<std::unique_ptr<OwnerLevels>> ownerLevelSnapshots;
+static std::mutex ownerLevelsLock;
 
 std::deque<Logger::WriterPtr> writers;
 
@@ -113,10 +125,71 @@ void SetConsoleWindowLogLevel(log_level level)
 	CWLL = level;
 }
 
+void SetLogLevel(log_level level)
+{
+	logLevel = level;
+}
+
+void SetOwnerLogLevel(const char* owner, log_level level)
+{
+	std::lock_guard<std::mutex> l(ownerLevelsLock);
+	const OwnerLevels* current = ownerLevels.load(std::memory_order_acquire);
+	OwnerLevels* levels = current ? new OwnerLevels(*current) : new OwnerLevels();
+	auto it = std::find_if(levels->begin(), levels->end(), [owner](const OwnerLevels::value_type& entry) {
+		return entry.first == owner;
+	});
+	if (it != levels->end()) {
+		it->second = level;
+	} else {
+		levels->emplace_back(owner, level);
+	}
+	ownerLevelSnapshots.emplace_back(levels);
+	ownerLevels.store(levels, std::memory_order_release);
+}
+
+void SetOwnerLogLevels(const char* levels)
+{
+	std::string list = levels;
+	size_t start = 0;
+	while (start < list.length()) {
+		size_t end = list.find(',', start);
+		if (end == std::string::npos) {
+			end = list.length();
+		}
+		std::string pair = list.substr(start, end - start);
+		size_t eq = pair.find('=');
+		if (eq != std::string::npos && eq > 0) {
+			int level = atoi(pair.c_str() + eq + 1);
+			SetOwnerLogLevel(pair.substr(0, eq).c_str(), log_level(std::min(std::max(level, int(FATAL)), int(DEBUG))));
+		}
+		start = end + 1;
+	}
+}
+
+static log_level OwnerLogLevel(const char* owner)
+{
+	const OwnerLevels* levels = ownerLevels.load(std::memory_order_acquire);
+	if (levels) {
+		for (const auto& entry : *levels) {
+			if (entry.first == owner) {
+				return entry.second;
+			}
+		}
+	}
+	return logLevel;
+}
+
+bool LogEnabled(log_level level, const char* owner)
+{
+	if (level <= FATAL) return true;
+	if (level <= CWLL) return true;
+	return logger && level <= OwnerLogLevel(owner);
+}
+
 static void LogMsg(LogMessage&& msg)
 {
 	ConsoleWinLogMsg(msg);
-	if (logger) {
+	if (logger && (msg.level <= FATAL || msg.level <= OwnerLogLevel(msg.owner.c_str()))) {
 		logger->LogMsg(std::move(msg));
 	}
 }
@@ -131,15 +204,23 @@ void AddLogWriter(Logger::WriterPtr&& writer)
 
 static void vLog(log_level level, const char* owner, const char* message, log_color color, va_list ap)
 {
-    va_list ap_copy;
-    va_copy(ap_copy, ap);
-    const size_t len = vsnprintf(NULL, 0, message, ap_copy);
-    va_end(ap_copy);
+	if (!LogEnabled(level, owner)) return;
+
+	// most messages fit, so only the long ones get formatted twice
+	char buf[512];
+	va_list ap_copy;
+	va_copy(ap_copy, ap);
+	const int len = vsnprintf(buf, sizeof(buf), message, ap_copy);
+	va_end(ap_copy);
+	if (len < 0) return;
 
-	char *buf = new char[len+1];
-	vsnprintf(buf, len + 1, message, ap);
-	LogMsg(LogMessage(level, owner, buf, color));
-	delete[] buf;
+	if (size_t(len) < sizeof(buf)) {
+		LogMsg(LogMessage(level, owner, buf, color));
+	} else {
+		std::string text(len, '\0');
+		vsnprintf(&text[0], len + 1, message, ap);
+		LogMsg(LogMessage(level, owner, std::move(text), color));
+	}
 }
 
 void print(const char *message, ...)
@@ -175,9 +256,24 @@ void LogVA(log_level level, const char* owner, const char* message, va_list args
 
 void Log(log_level level, const char* owner, StringBuffer const& buffer)
 {
+	if (!LogEnabled(level, owner)) return;
 	LogMsg(LogMessage(level, owner, buffer.get().c_str(), WHITE));
 }
 
+void LogDeferred(log_level level, const char* owner, std::function<std::string()>&& format)
+{
+	if (!LogEnabled(level, owner)) return;
+
+	LogMessage msg(level, owner, "", WHITE);
+	if (level <= CWLL || !logger) {
+		// the console window is drawn from this thread
+		msg.message = format();
+	} else {
+		msg.format = std::move(format);
+	}
+	LogMsg(std::move(msg));
+}
+
 static void addGemRBLog()
 {
 	char log_path[_MAX_PATH];
@@ -35,6 +35,14 @@
 #else
 #  include <cstdarg>
 #endif
+#include <functional>
+#include <string>
+
+// LogDebug messages above this log_level are compiled out, explicit
+// Log(DEBUG, ...) calls like the object dumps are not
+#ifndef GEM_LOG_LEVEL
+#define GEM_LOG_LEVEL 5 // DEBUG
+#endif
 
 namespace GemRB {
 
@@ -43,6 +51,14 @@ class StringBuffer;
 GEM_EXPORT void ToggleLogging(bool);
 GEM_EXPORT void AddLogWriter(Logger::WriterPtr&&);
 GEM_EXPORT void SetConsoleWindowLogLevel(log_level level);
+/// Messages above level are dropped before they are formatted
+GEM_EXPORT void SetLogLevel(log_level level);
+/// Overrides the log level for messages from owner, in either direction
+GEM_EXPORT void SetOwnerLogLevel(const char* owner, log_level level);
+/// Parses "owner=level" pairs separated by commas, eg. "FindPath=3,Map=5"
+GEM_EXPORT void SetOwnerLogLevels(const char* levels);
+/// Whether anything would receive a message of this level from owner
+GEM_EXPORT bool LogEnabled(log_level level, const char* owner);
 
 #if defined(__GNUC__)
 # define PRINTF_FORMAT(x, y) \
@@ -66,6 +82,23 @@ GEM_EXPORT void LogVA(log_level level, const char* owner, const char* message, v
 
 GEM_EXPORT void Log(log_level, const char* owner, StringBuffer const&);
 
+/// Leaves the formatting to the logging thread, so format must not
+/// refer to anything on the caller's stack
+GEM_EXPORT void LogDeferred(log_level level, const char* owner, std::function<std::string()>&& format);
+
+/// Whether a debug message from owner would be seen, false when GEM_LOG_LEVEL is lower
+#define LogDebugEnabled(owner) \
+	(GEM_LOG_LEVEL >= ::GemRB::DEBUG && ::GemRB::LogEnabled(::GemRB::DEBUG, owner))
+
+/// Debug messages don't even evaluate their arguments unless someone
+/// listens, and disappear when GEM_LOG_LEVEL is lower
+#define LogDebug(owner, ...) \
+	do { \
+		if (LogDebugEnabled(owner)) { \
+			::GemRB::Log(::GemRB::DEBUG, owner, __VA_ARGS__); \
+		} \
+	} while (0)
+
 #undef PRINTF_FORMAT
 
 }
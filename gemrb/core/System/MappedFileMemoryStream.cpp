@@ -69,10 +69,28 @@ MappedFileMemoryStream::MappedFileMemoryStream(const std::string& fileName)
 		this->data = static_cast<char*>(readonly_mmap(fileHandle));
 		this->fileMapped = data != nullptr;
 	}
+
+	// the mapping keeps the file referenced, so long lived streams (eg.
+	// animation frame data) don't need to hold a file handle each
+	if (fileMapped) {
+		closeFile();
+	}
+}
+
+void MappedFileMemoryStream::closeFile() {
+	if (!fileOpened) {
+		return;
+	}
+#ifdef WIN32
+	CloseHandle(fileHandle);
+#else
+	fclose(static_cast<FILE*>(fileHandle));
+#endif
+	fileOpened = false;
 }
 
 bool MappedFileMemoryStream::isOk() const {
-	return fileOpened && fileMapped;
+	return fileMapped;
 }
 
 DataStream* MappedFileMemoryStream::Clone() {
@@ -105,14 +123,7 @@ MappedFileMemoryStream::~MappedFileMemoryStream() {
 	}
 
 	this->data = nullptr;
-
-	if (fileOpened) {
-#ifdef WIN32
-		CloseHandle(fileHandle);
-#else
-		fclose(static_cast<FILE*>(fileHandle));
-#endif
-	}
+	closeFile();
 }
 
 }
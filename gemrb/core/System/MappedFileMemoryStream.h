@@ -36,6 +36,8 @@ class GEM_EXPORT MappedFileMemoryStream : public MemoryStream {
 		DataStream* Clone() override;
 
 	private:
+		void closeFile();
+
 		void *fileHandle;
 		bool fileOpened;
 		bool fileMapped;
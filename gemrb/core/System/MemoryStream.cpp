@@ -27,7 +27,7 @@
 namespace GemRB {
 
 MemoryStream::MemoryStream(const char *name, void* data, unsigned long size)
-	: data((char*)data)
+	: data((char*)data), capacity(size)
 {
 	this->size = size;
 	ExtractFileFromPath(filename, name);
@@ -43,6 +43,7 @@ DataStream* MemoryStream::Clone()
 {
 	void *copy = malloc(size);
 	memcpy(copy, data, size);
+	CountCopied(size);
 	return new MemoryStream(originalfile, copy, size);
 }
 
@@ -59,14 +60,36 @@ int MemoryStream::Read(void* dest, unsigned int length)
 		ReadDecrypted( dest, length );
 	}
 	Pos += length;
+	CountCopied(length);
 	return length;
 }
 
+const void* MemoryStream::Map(unsigned long offset, unsigned long len)
+{
+	if (Encrypted || !data || offset + len > size) {
+		return NULL;
+	}
+	CountMapped(len);
+	return data + offset;
+}
+
 int MemoryStream::Write(const void* src, unsigned int length)
 {
-	if (Pos+length>size ) {
-		//error("MemoryStream", "We don't support appending to memory streams yet.");
-		return GEM_ERROR;
+	if (Pos+length>capacity) {
+		// appending, double the buffer so repeated writes stay linear
+		unsigned long grownCapacity = capacity ? capacity : 256;
+		while (grownCapacity < Pos+length) {
+			grownCapacity *= 2;
+		}
+		char *grown = (char *) realloc(data, grownCapacity);
+		if (!grown) {
+			return GEM_ERROR;
+		}
+		data = grown;
+		capacity = grownCapacity;
+	}
+	if (Pos+length>size) {
+		size = Pos+length;
 	}
 	memcpy(data+Pos, src, length);
 	Pos += length;
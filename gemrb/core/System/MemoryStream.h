@@ -31,6 +31,8 @@ class GEM_EXPORT MemoryStream : public DataStream
 {
 protected:
 	char *data;
+	// allocated bytes, Write grows it ahead of size
+	unsigned long capacity;
 public:
 	MemoryStream(const char *name, void* data, unsigned long size);
 	~MemoryStream() override;
@@ -39,6 +41,7 @@ public:
 	int Read(void* dest, unsigned int length) override;
 	int Write(const void* src, unsigned int length) override;
 	int Seek(int pos, int startpos) override;
+	const void* Map(unsigned long offset, unsigned long len) override;
 };
 
 }
@@ -69,6 +69,14 @@ int SlicedStream::Read(void* dest, unsigned int length)
 	return c;
 }
 
+const void* SlicedStream::Map(unsigned long offset, unsigned long len)
+{
+	if (Encrypted || offset + len > size) {
+		return NULL;
+	}
+	return str->Map(startpos + offset, len);
+}
+
 int SlicedStream::Write(const void* /*src*/, unsigned int /*length*/)
 {
 	error("SlicedStream", "Attempted to use unimplemented SlicedStream::Write method!");
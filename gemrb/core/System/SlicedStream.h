@@ -41,6 +41,7 @@ public:
 	int Read(void* dest, unsigned int length) override;
 	int Write(const void* src, unsigned int length) override;
 	int Seek(int pos, int startpos) override;
+	const void* Map(unsigned long offset, unsigned long len) override;
 };
 
 GEM_EXPORT DataStream* SliceStream(DataStream* str, unsigned long startpos, unsigned long size, bool preservepos = false);
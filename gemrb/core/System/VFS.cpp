@@ -38,6 +38,7 @@
 #  include <cstdarg>
 #endif
 
+#include <atomic>
 #include <cstring>
 #include <cerrno>
 
@@ -192,6 +193,16 @@ bool file_exists(const char* path)
 	return true;
 }
 
+time_t file_mtime(const char* path)
+{
+	struct stat buf;
+
+	if (stat(path, &buf) < 0) {
+		return 0;
+	}
+	return buf.st_mtime;
+}
+
 
 /**
  * Appends 'name' to path 'target' and returns 'target'.
@@ -216,6 +227,14 @@ char* PathAppend (char* target, const char* name)
 	return target;
 }
 
+// resources are looked up from the ambient and prefetch threads too
+static std::atomic<unsigned long> pathProbes { 0 };
+
+unsigned long GetPathProbeCount()
+{
+	return pathProbes;
+}
+
 static bool FindInDir(const char* Dir, char *Filename)
 {
 	// First test if there's a Filename with exactly same name
@@ -225,6 +244,7 @@ static bool FindInDir(const char* Dir, char *Filename)
 	strcpy(TempFilePath, Dir);
 	PathAppend( TempFilePath, Filename );
 
+	pathProbes++;
 	if (!access( TempFilePath, R_OK )) {
 		return true;
 	}
@@ -233,6 +253,7 @@ static bool FindInDir(const char* Dir, char *Filename)
 		return false;
 	}
 
+	pathProbes++;
 	DirectoryIterator dir(Dir);
 	if (!dir) {
 		return false;
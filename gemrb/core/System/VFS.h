@@ -77,6 +77,8 @@ const char SPathListSeparator[] = { PathListSeparator, '\0' };
 
 GEM_EXPORT bool dir_exists(const char* path);
 GEM_EXPORT bool file_exists(const char* path);
+/** Returns the modification time of path, 0 if it doesn't exist */
+GEM_EXPORT time_t file_mtime(const char* path);
 
 /**
  * Joins NULL-terminated list of directories and copies it to 'target'.
@@ -97,6 +99,8 @@ GEM_EXPORT bool file_exists(const char* path);
 GEM_EXPORT bool PathJoin (char* target, const char* base, ...) SENTINEL;
 GEM_EXPORT bool PathJoinExt (char* target, const char* dir, const char* file, const char* ext = NULL);
 GEM_EXPORT void FixPath (char *path, bool needslash);
+/** Returns the number of file system probes (access checks and directory scans) PathJoin did so far */
+GEM_EXPORT unsigned long GetPathProbeCount();
 
 GEM_EXPORT void ExtractFileFromPath(char *file, const char *full_path);
 
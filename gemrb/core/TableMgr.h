@@ -58,6 +58,18 @@ public:
 	 * uses column name and row name to search the field,
 	 * may return NULL */
 	virtual const char* QueryField(const char* row, const char* column) const = 0;
+	/** Returns a 2da element as a number (parsed like atoi, once at load time);
+	 * missing and '*' fields yield the number of the default value */
+	virtual int QueryFieldSigned(size_t row, size_t column) const = 0;
+	virtual int QueryFieldSigned(const char* row, const char* column) const = 0;
+	ieDword QueryFieldUnsigned(size_t row, size_t column) const
+	{
+		return (ieDword) QueryFieldSigned(row, column);
+	}
+	ieDword QueryFieldUnsigned(const char* row, const char* column) const
+	{
+		return (ieDword) QueryFieldSigned(row, column);
+	}
 	/** Returns default value of table. */
 	virtual const char* QueryDefault() const = 0;
 	virtual int GetColumnIndex(const char* colname) const = 0;
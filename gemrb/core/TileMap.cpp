@@ -92,6 +92,7 @@ Door* TileMap::AddDoor(const char *ID, const char* Name, unsigned int Flags,
 	door->SetName( ID );
 	door->SetScriptName( Name );
 	doors.push_back( door );
+	objectsByID[door->GetGlobalID()] = door;
 	return door;
 }
 
@@ -191,6 +192,7 @@ void TileMap::DrawOverlays(const Region& viewport, bool rain, BlitFlags flags)
 void TileMap::AddContainer(Container *c)
 {
 	containers.push_back(c);
+	objectsByID[c->GetGlobalID()] = c;
 }
 
 Container* TileMap::GetContainer(unsigned int idx) const
@@ -272,6 +274,7 @@ int TileMap::CleanupContainer(Container *container)
 
 	for (size_t i = 0; i < containers.size(); i++) {
 		if (containers[i]==container) {
+			objectsByID.erase(container->GetGlobalID());
 			containers.erase(containers.begin()+i);
 			delete container;
 			return 1;
@@ -309,6 +312,7 @@ InfoPoint* TileMap::AddInfoPoint(const char* Name, unsigned short Type, std::sha
 		ip->BBox = outline->BBox;
 	//ip->Active = true; //set active on creation
 	infoPoints.push_back( ip );
+	objectsByID[ip->GetGlobalID()] = ip;
 	return ip;
 }
 
@@ -395,6 +399,13 @@ InfoPoint *TileMap::AdjustNearestTravel(Point &p)
 	return best;
 }
 
+Scriptable* TileMap::GetScriptableByGlobalID(ieDword objectID) const
+{
+	auto it = objectsByID.find(objectID);
+	if (it == objectsByID.end()) return NULL;
+	return it->second;
+}
+
 Size TileMap::GetMapSize()
 {
 	return Size((XCellCount*64), (YCellCount*64));
@@ -26,6 +26,8 @@
 #include "Scriptable/Door.h"
 #include "TileOverlay.h"
 
+#include <unordered_map>
+
 namespace GemRB {
 
 //special container types
@@ -43,6 +45,8 @@ private:
 	std::vector< Container*> containers;
 	std::vector< InfoPoint*> infoPoints;
 	std::vector< TileObject*> tiles;
+	// doors, containers and infopoints by global ID
+	std::unordered_map<ieDword, Scriptable*> objectsByID;
 public:
 	TileMap(void);
 	~TileMap(void);
@@ -86,6 +90,9 @@ public:
 	TileObject* GetTile(const char* Name);
 	size_t GetTileCount() { return tiles.size(); }
 
+	/* looks up a door, container or infopoint */
+	Scriptable* GetScriptableByGlobalID(ieDword objectID) const;
+
 	void ClearOverlays();
 	void AddOverlay(TileOverlay* overlay);
 	void AddRainOverlay(TileOverlay* overlay);
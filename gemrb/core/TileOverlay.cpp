@@ -47,6 +47,21 @@ void TileOverlay::AddTile(Tile* tile)
 	tiles[count++] = tile;
 }
 
+void TileOverlay::PackTiles() const
+{
+	std::vector<Holder<Sprite2D>> frames;
+	for (int i = 0; i < count; i++) {
+		for (const Animation* anim : tiles[i]->anim) {
+			if (!anim) continue;
+			for (unsigned int f = 0; f < anim->GetFrameCount(); f++) {
+				Holder<Sprite2D> frame = anim->GetFrame(f);
+				if (frame) frames.push_back(frame);
+			}
+		}
+	}
+	core->GetVideoDriver()->PackSprites(frames);
+}
+
 void TileOverlay::Draw(const Region& viewport, std::vector< TileOverlay*> &overlays, BlitFlags flags)
 {
 	// determine which tiles are visible
@@ -40,6 +40,8 @@ public:
 	TileOverlay(int Width, int Height);
 	~TileOverlay(void);
 	void AddTile(Tile* tile);
+	/** Lets the video driver keep the tile frames together, call once all are added */
+	void PackTiles() const;
 	void Draw(const Region& viewport, std::vector< TileOverlay*> &overlays, BlitFlags flags);
 };
 
@@ -24,8 +24,37 @@
 #include "System/FileStream.h" // for LoadInitialValues
 #include "System/VFS.h"
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace GemRB {
 
+// the interned variable names, normalized like parsed keys
+struct VariableSymbols {
+	std::unordered_map<std::string, ieDword> ids;
+	// indexed by symbol, 0 is unused
+	std::vector<std::string> names = std::vector<std::string>(1);
+	std::vector<unsigned int> hashes = std::vector<unsigned int>(1);
+};
+
+static VariableSymbols& GetSymbols()
+{
+	static VariableSymbols symbols;
+	return symbols;
+}
+
+static unsigned int HashVariableName(const char* key)
+{
+	unsigned int nHash = 0;
+	for (int i = 0; i < MAX_VARIABLE_LENGTH && key[i]; i++) {
+		//the original engine ignores spaces in variable names
+		if (key[i] != ' ')
+			nHash = ( nHash << 5 ) + nHash + tolower( key[i] );
+	}
+	return nHash;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // private inlines 
 inline bool Variables::MyCopyKey(char*& dest, const char* key) const
@@ -71,44 +100,55 @@ inline unsigned int Variables::MyHashKey(const char* key) const
 {
 	assert(key != NULL);
 
-	unsigned int nHash = 0;
-	for (int i = 0; i < MAX_VARIABLE_LENGTH && key[i]; i++) {
-		//the original engine ignores spaces in variable names
-		if (key[i] != ' ')
-			nHash = ( nHash << 5 ) + nHash + tolower( key[i] );
-	}
-	return nHash;
+	return HashVariableName(key);
 }
 /////////////////////////////////////////////////////////////////////////////
 // functions
+ieDword Variables::Intern(const char* key)
+{
+	char name[MAX_VARIABLE_LENGTH];
+	int j = 0;
+	for (int i = 0; key[i] && j < MAX_VARIABLE_LENGTH - 1; i++) {
+		if (key[i] != ' ') {
+			name[j++] = (char) tolower(key[i]);
+		}
+	}
+	name[j] = 0;
+
+	VariableSymbols& symbols = GetSymbols();
+	auto it = symbols.ids.find(name);
+	if (it != symbols.ids.end()) {
+		return it->second;
+	}
+	ieDword symbol = (ieDword) symbols.names.size();
+	symbols.ids.emplace(name, symbol);
+	symbols.names.emplace_back(name);
+	symbols.hashes.push_back(HashVariableName(name));
+	return symbol;
+}
+
+const char* Variables::SymbolName(ieDword symbol)
+{
+	const VariableSymbols& symbols = GetSymbols();
+	assert(symbol && symbol < symbols.names.size());
+	return symbols.names[symbol].c_str();
+}
+
 Variables::iterator Variables::GetNextAssoc(iterator rNextPosition, const char*& rKey,
 	ieDword& rValue) const
 {
-	assert( m_pHashTable != NULL ); // never call on empty map
+	assert( m_pOrderHead != NULL ); // never call on empty map
 
 	Variables::MyAssoc *pAssocRet = rNextPosition;
 
 	if (pAssocRet == NULL) {
-		// find the first association
-		for (unsigned int nBucket = 0; nBucket < m_nHashTableSize; nBucket++)
-			if (( pAssocRet = m_pHashTable[nBucket] ) != NULL)
-				break;
-		assert( pAssocRet != NULL ); // must find something
-	}
-	Variables::MyAssoc* pAssocNext;
-	if (( pAssocNext = pAssocRet->pNext ) == NULL) {
-		// go to next bucket
-		for (unsigned int nBucket = pAssocRet->nHashValue + 1;
-			nBucket < m_nHashTableSize;
-			nBucket++)
-			if (( pAssocNext = m_pHashTable[nBucket] ) != NULL)
-				break;
+		pAssocRet = m_pOrderHead;
 	}
 
 	// fill in return data
 	rKey = pAssocRet->key;
 	rValue = pAssocRet->Value.nValue;
-	return pAssocNext;
+	return pAssocRet->pOrderNext;
 }
 
 Variables::Variables(int nBlockSize, int nHashTableSize)
@@ -120,7 +160,10 @@ Variables::Variables(int nBlockSize, int nHashTableSize)
 	m_nHashTableSize = nHashTableSize; // default size
 	m_nCount = 0;
 	m_lParseKey = false;
+	m_lInternKeys = false;
 	m_pFreeList = NULL;
+	m_pOrderHead = NULL;
+	m_pOrderTail = NULL;
 	m_pBlocks = NULL;
 	m_nBlockSize = nBlockSize;
 	m_type = GEM_VARIABLES_INT;
@@ -179,6 +222,8 @@ void Variables::RemoveAll(ReleaseFun fun)
 
 	m_nCount = 0;
 	m_pFreeList = NULL;
+	m_pOrderHead = NULL;
+	m_pOrderTail = NULL;
 	MemBlock* p = m_pBlocks;
 	while (p != NULL) {
 		MemBlock* pNext = p->pNext;
@@ -234,6 +279,16 @@ Variables::MyAssoc* Variables::NewAssoc(const char* key)
 
 void Variables::FreeAssoc(Variables::MyAssoc* pAssoc)
 {
+	if (pAssoc->pOrderPrev) {
+		pAssoc->pOrderPrev->pOrderNext = pAssoc->pOrderNext;
+	} else {
+		m_pOrderHead = pAssoc->pOrderNext;
+	}
+	if (pAssoc->pOrderNext) {
+		pAssoc->pOrderNext->pOrderPrev = pAssoc->pOrderPrev;
+	} else {
+		m_pOrderTail = pAssoc->pOrderPrev;
+	}
 	if (pAssoc->key) {
 		free(pAssoc->key);
 		pAssoc->key = NULL;
@@ -249,6 +304,47 @@ void Variables::FreeAssoc(Variables::MyAssoc* pAssoc)
 	}
 }
 
+// nHash is the full hash of the key, as returned by GetAssocAt
+Variables::MyAssoc* Variables::InsertAssoc(const char* key, unsigned int nHash)
+{
+	if (m_pHashTable == NULL) {
+		InitHashTable( m_nHashTableSize );
+	} else if ((unsigned int) m_nCount >= m_nHashTableSize * 2) {
+		// keep the buckets short, the tables start out small
+		Rehash( m_nHashTableSize * 2 + 1 );
+	}
+
+	Variables::MyAssoc* pAssoc = NewAssoc( key );
+	pAssoc->nHashValue = nHash;
+	pAssoc->nSymbol = m_lInternKeys && pAssoc->key ? Intern(pAssoc->key) : 0;
+	unsigned int nBucket = nHash % m_nHashTableSize;
+	pAssoc->pNext = m_pHashTable[nBucket];
+	m_pHashTable[nBucket] = pAssoc;
+
+	pAssoc->pOrderNext = NULL;
+	pAssoc->pOrderPrev = m_pOrderTail;
+	if (m_pOrderTail) {
+		m_pOrderTail->pOrderNext = pAssoc;
+	} else {
+		m_pOrderHead = pAssoc;
+	}
+	m_pOrderTail = pAssoc;
+	return pAssoc;
+}
+
+void Variables::Rehash(unsigned int nHashSize)
+{
+	Variables::MyAssoc** newTable = (Variables::MyAssoc **) calloc(nHashSize, sizeof(Variables::MyAssoc *));
+	for (Variables::MyAssoc* pAssoc = m_pOrderHead; pAssoc != NULL; pAssoc = pAssoc->pOrderNext) {
+		unsigned int nBucket = pAssoc->nHashValue % nHashSize;
+		pAssoc->pNext = newTable[nBucket];
+		newTable[nBucket] = pAssoc;
+	}
+	free(m_pHashTable);
+	m_pHashTable = newTable;
+	m_nHashTableSize = nHashSize;
+}
+
 Variables::MyAssoc* Variables::GetAssocAt(const char* key, unsigned int& nHash) const
 	// find association (or return NULL)
 {
@@ -256,7 +352,7 @@ Variables::MyAssoc* Variables::GetAssocAt(const char* key, unsigned int& nHash)
 		return NULL;
 	}
 
-	nHash = MyHashKey( key ) % m_nHashTableSize;
+	nHash = MyHashKey( key );
 
 	if (m_pHashTable == NULL) {
 		return NULL;
@@ -264,9 +360,12 @@ Variables::MyAssoc* Variables::GetAssocAt(const char* key, unsigned int& nHash)
 
 	// see if it exists
 	Variables::MyAssoc* pAssoc;
-	for (pAssoc = m_pHashTable[nHash];
+	for (pAssoc = m_pHashTable[nHash % m_nHashTableSize];
 		pAssoc != NULL;
 		pAssoc = pAssoc->pNext) {
+		if (pAssoc->nHashValue != nHash) {
+			continue;
+		}
 		if (m_lParseKey) {
 			if (!MyCompareKey( pAssoc->key, key) ) {
 				return pAssoc;
@@ -281,6 +380,22 @@ Variables::MyAssoc* Variables::GetAssocAt(const char* key, unsigned int& nHash)
 	return NULL;
 }
 
+Variables::MyAssoc* Variables::GetAssocAt(ieDword symbol) const
+{
+	assert(m_lInternKeys);
+	if (m_pHashTable == NULL) {
+		return NULL;
+	}
+
+	unsigned int nHash = GetSymbols().hashes[symbol];
+	for (Variables::MyAssoc* pAssoc = m_pHashTable[nHash % m_nHashTableSize]; pAssoc != NULL; pAssoc = pAssoc->pNext) {
+		if (pAssoc->nSymbol == symbol) {
+			return pAssoc;
+		}
+	}
+	return NULL;
+}
+
 int Variables::GetValueLength(const char* key) const
 {
 	unsigned int nHash;
@@ -345,6 +460,18 @@ bool Variables::Lookup(const char* key, ieDword& rValue) const
 	return true;
 }
 
+bool Variables::Lookup(ieDword symbol, ieDword& rValue) const
+{
+	assert(m_type == GEM_VARIABLES_INT);
+	const Variables::MyAssoc* pAssoc = GetAssocAt(symbol);
+	if (pAssoc == NULL) {
+		return false;
+	}
+
+	rValue = pAssoc->Value.nValue;
+	return true;
+}
+
 void Variables::SetAtCopy(const char* key, const char* value)
 {
 	size_t len = strlen(value)+1;
@@ -374,14 +501,8 @@ void Variables::SetAt(const char* key, char* value)
 
 	assert( m_type == GEM_VARIABLES_STRING );
 	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pAssoc = InsertAssoc( key, nHash );
 	} else {
 		if (pAssoc->Value.sValue) {
 			free( pAssoc->Value.sValue );
@@ -392,7 +513,6 @@ void Variables::SetAt(const char* key, char* value)
 	//set value only if we have a key
 	if (pAssoc->key) {
 		pAssoc->Value.sValue = value;
-		pAssoc->nHashValue = nHash;
 	}
 }
 
@@ -403,14 +523,8 @@ void Variables::SetAt(const char* key, void* value)
 
 	assert( m_type == GEM_VARIABLES_POINTER );
 	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pAssoc = InsertAssoc( key, nHash );
 	} else {
 		if (pAssoc->Value.sValue) {
 			free( pAssoc->Value.sValue );
@@ -421,7 +535,6 @@ void Variables::SetAt(const char* key, void* value)
 	//set value only if we have a key
 	if (pAssoc->key) {
 		pAssoc->Value.pValue = value;
-		pAssoc->nHashValue = nHash;
 	}
 
 }
@@ -439,19 +552,29 @@ void Variables::SetAt(const char* key, ieDword value, bool nocreate)
 			return;
 		}
 
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pAssoc = InsertAssoc( key, nHash );
 	}
 	//set value only if we have a key
 	if (pAssoc->key) {
 		pAssoc->Value.nValue = value;
-		pAssoc->nHashValue = nHash;
+	}
+}
+
+void Variables::SetAt(ieDword symbol, ieDword value, bool nocreate)
+{
+	assert(m_type == GEM_VARIABLES_INT);
+	Variables::MyAssoc* pAssoc = GetAssocAt(symbol);
+	if (pAssoc == NULL) {
+		if (nocreate) {
+			Log(WARNING, "Variables", "Cannot create new variable: %s", SymbolName(symbol));
+			return;
+		}
+		const char* key = SymbolName(symbol);
+		pAssoc = InsertAssoc(key, MyHashKey(key));
+	}
+	if (pAssoc->key) {
+		pAssoc->Value.nValue = value;
 	}
 }
 
@@ -463,6 +586,7 @@ void Variables::Remove(const char* key)
 	pAssoc = GetAssocAt( key, nHash );
 	if (!pAssoc) return; // not in there
 
+	nHash %= m_nHashTableSize;
 	if (pAssoc == m_pHashTable[nHash]) {
 		// head
 		m_pHashTable[nHash] = pAssoc->pNext;
@@ -534,17 +658,14 @@ void Variables::DebugDump()
 	Log (DEBUG, "Variables", "Item type: %s", poi);
 	Log (DEBUG, "Variables", "Item count: %d", m_nCount);
 	Log (DEBUG, "Variables", "HashTableSize: %d\n", m_nHashTableSize);
-	for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
-		Variables::MyAssoc* pAssoc;
-		for (pAssoc = m_pHashTable[nHash]; pAssoc != NULL; pAssoc = pAssoc->pNext) {
-			switch(m_type) {
-			case GEM_VARIABLES_STRING:
-				Log (DEBUG, "Variables", "%s = %s", pAssoc->key, pAssoc->Value.sValue);
-				break;
-			default:
-				Log (DEBUG, "Variables", "%s = %d", pAssoc->key, pAssoc->Value.nValue);
-				break;
-			}
+	for (Variables::MyAssoc* pAssoc = m_pOrderHead; pAssoc != NULL; pAssoc = pAssoc->pOrderNext) {
+		switch(m_type) {
+		case GEM_VARIABLES_STRING:
+			Log (DEBUG, "Variables", "%s = %s", pAssoc->key, pAssoc->Value.sValue);
+			break;
+		default:
+			Log (DEBUG, "Variables", "%s = %d", pAssoc->key, pAssoc->Value.nValue);
+			break;
 		}
 	}
 }
@@ -43,13 +43,19 @@ protected:
 	// Association
 	class MyAssoc {
 		MyAssoc* pNext;
+		// insertion order, so saving writes the variables back in the order they were loaded
+		MyAssoc* pOrderNext;
+		MyAssoc* pOrderPrev;
 		char* key;
 		union {
 			ieDword nValue;
 			char* sValue;
 			void* pValue;
 		} Value;
-		unsigned long nHashValue;
+		// the full hash of the key, compared before the keys themselves
+		unsigned int nHashValue;
+		// the interned key, only in tables that intern their keys
+		ieDword nSymbol;
 		friend class Variables;
 	};
 	struct MemBlock {
@@ -72,6 +78,13 @@ public:
 		m_lParseKey = ( arg > 0 );
 		return 0;
 	}
+	//script variable tables also intern their keys, so scripts can look them up by symbol
+	//you should set this only on an empty mapping with parsed keys
+	inline void InternKeys()
+	{
+		assert( m_nCount == 0 && m_lParseKey );
+		m_lInternKeys = true;
+	}
 	//sets the way we handle values
 	inline void SetType(int type)
 	{
@@ -86,12 +99,20 @@ public:
 		return m_nCount == 0;
 	}
 
+	// Interned script variable names, shared by every table that interns its keys.
+	// Symbols are never 0 and stay valid until exit; the table only holds the
+	// names scripts and saved games use, so it stays small.
+	static ieDword Intern(const char* key);
+	static const char* SymbolName(ieDword symbol);
+
 	// Lookup
 	int GetValueLength(const char* key) const;
 	bool Lookup(const char* key, char* dest, int MaxLength) const;
 	bool Lookup(const char* key, ieDword& rValue) const;
 	bool Lookup(const char* key, char*& dest) const;
 	bool Lookup(const char* key, void*& dest) const;
+	// only for tables that intern their keys
+	bool Lookup(ieDword symbol, ieDword& rValue) const;
 
 	// Operations
 	void SetAtCopy(const char* key, const char* newValue);
@@ -99,6 +120,7 @@ public:
 	void SetAt(const char* key, char* newValue);
 	void SetAt(const char* key, void* newValue);
 	void SetAt(const char* key, ieDword newValue, bool nocreate=false);
+	void SetAt(ieDword symbol, ieDword newValue, bool nocreate=false);
 	void Remove(const char* key);
 	void RemoveAll(ReleaseFun fun);
 	void InitHashTable(unsigned int hashSize, bool bAllocNow = true);
@@ -113,15 +135,21 @@ protected:
 	Variables::MyAssoc** m_pHashTable;
 	unsigned int m_nHashTableSize;
 	bool m_lParseKey;
+	bool m_lInternKeys;
 	int m_nCount;
 	Variables::MyAssoc* m_pFreeList;
+	Variables::MyAssoc* m_pOrderHead;
+	Variables::MyAssoc* m_pOrderTail;
 	MemBlock* m_pBlocks;
 	int m_nBlockSize;
 	int m_type; //could be string or ieDword 
 
 	Variables::MyAssoc* NewAssoc(const char* key);
+	Variables::MyAssoc* InsertAssoc(const char* key, unsigned int nHash);
 	void FreeAssoc(Variables::MyAssoc*);
+	void Rehash(unsigned int nHashSize);
 	Variables::MyAssoc* GetAssocAt(const char*, unsigned int&) const;
+	Variables::MyAssoc* GetAssocAt(ieDword symbol) const;
 	inline bool MyCopyKey(char*& dest, const char* key) const;
 	inline unsigned int MyCompareKey(const char* key, const char *str) const;
 	inline unsigned int MyHashKey(const char*) const;
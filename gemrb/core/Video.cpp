@@ -20,6 +20,7 @@
 
 #include "Video.h"
 
+#include "FrameProfiler.h"
 #include "Interface.h"
 #include "Palette.h"
 #include "Sprite2D.h"
@@ -145,7 +146,9 @@ void Video::SetStencilBuffer(const VideoBufferPtr& stencil)
 
 int Video::SwapBuffers(unsigned int fpscap)
 {
+	FrameProfiler::Scope phase(FrameProfiler::PHASE_SWAP);
 	SwapBuffers(drawingBuffers);
+	phase.Stop();
 	drawingBuffers.clear();
 	drawingBuffer = NULL;
 	SetScreenClip(NULL);
@@ -194,6 +194,12 @@ public:
 	virtual Holder<Sprite2D> CreatePalettedSprite(const Region&, int bpp, void* pixels,
 										   Color* palette, bool cK = false, int index = 0) = 0;
 	virtual bool SupportsBAMSprites() { return false; }
+	/** Whether blended drawing into a DISPLAY_ALPHA buffer keeps its alpha,
+	 * so the buffer can be blended onto another one later */
+	virtual bool SupportsBlendedBuffers() { return false; }
+	/** Hint that the sprites are drawn together, like the frames of an
+	 * animation, so the driver may keep them in a shared texture */
+	virtual void PackSprites(const std::vector<Holder<Sprite2D>>&) {}
 	
 	void BlitSprite(const Holder<Sprite2D> spr, Point p,
 					const Region* clip = NULL);
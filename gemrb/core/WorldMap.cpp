@@ -114,7 +114,6 @@ WorldMap::WorldMap(void)
 	MapMOS = NULL;
 	Distances = NULL;
 	GotHereFrom = NULL;
-	bam = NULL;
 	encounterArea = -1;
 	Width = Height = 0;
 	MapNumber = AreaName = 0;
@@ -221,7 +220,6 @@ WorldMap::~WorldMap(void)
 	if (GotHereFrom) {
 		free(GotHereFrom);
 	}
-	if (bam) bam = NULL;
 }
 
 void WorldMap::SetMapIcons(AnimationFactory *newicons)
@@ -414,9 +412,9 @@ WMPAreaLink *WorldMap::GetEncounterLink(const ieResRef AreaName, bool &encounter
 		return NULL;
 	}
 	std::list<WMPAreaLink*> walkpath;
-	Log(DEBUG, "WorldMap", "Gathering path information for: %s", AreaName);
+	LogDebug("WorldMap", "Gathering path information for: %s", AreaName);
 	while (GotHereFrom[i]!=-1) {
-		Log(DEBUG, "WorldMap", "Adding path to %d", i);
+		LogDebug("WorldMap", "Adding path to %d", i);
 		walkpath.push_back(area_links[GotHereFrom[i]]);
 		i = WhoseLinkAmI(GotHereFrom[i]);
 		if (i==(ieDword) -1) {
@@ -424,7 +422,7 @@ WMPAreaLink *WorldMap::GetEncounterLink(const ieResRef AreaName, bool &encounter
 		}
 	}
 
-	Log(DEBUG, "WorldMap", "Walkpath size is: %d", (int) walkpath.size());
+	LogDebug("WorldMap", "Walkpath size is: %d", (int) walkpath.size());
 	if (walkpath.empty()) {
 		return NULL;
 	}
@@ -557,7 +555,7 @@ void WorldMap::UpdateAreaVisibility(const ieResRef AreaName, int direction)
 	if (!ae)
 		return;
 	//we are here, so we visited and it is visible too (i guess)
-	Log(DEBUG, "WorldMap", "Updated Area visibility: %s (visited, accessible and visible)", AreaName);
+	LogDebug("WorldMap", "Updated Area visibility: %s (visited, accessible and visible)", AreaName);
 
 	ae->SetAreaStatus(WMP_ENTRY_VISITED|WMP_ENTRY_VISIBLE|WMP_ENTRY_ACCESSIBLE, OP_OR);
 	if (direction<0 || direction>3)
@@ -567,7 +565,7 @@ void WorldMap::UpdateAreaVisibility(const ieResRef AreaName, int direction)
 		WMPAreaLink* al = area_links[ae->AreaLinksIndex[direction]+i];
 		WMPAreaEntry* ae2 = area_entries[al->AreaIndex];
 		if (ae2->GetAreaStatus()&WMP_ENTRY_ADJACENT) {
-			Log(DEBUG, "WorldMap", "Updated Area visibility: %s (accessible and visible)", ae2->AreaName);
+			LogDebug("WorldMap", "Updated Area visibility: %s (accessible and visible)", ae2->AreaName);
 			ae2->SetAreaStatus(WMP_ENTRY_VISIBLE|WMP_ENTRY_ACCESSIBLE, OP_OR);
 		}
 	}
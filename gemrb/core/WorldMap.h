@@ -132,7 +132,7 @@ public: //struct members
 	ieResRef MapIconResRef;
 	ieDword Flags;
 
-	AnimationFactory *bam;
+	Holder<AnimationFactory> bam;
 private: //non-struct members
 	Holder<Sprite2D> MapMOS;
 	std::vector< WMPAreaEntry*> area_entries;
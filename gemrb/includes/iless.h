@@ -21,6 +21,9 @@
 
 #include "Platform.h" //for stricmp
 
+#include <cctype>
+#include <cstddef>
+
 namespace GemRB {
 
 struct iless {
@@ -30,6 +33,27 @@ struct iless {
 	}
 };
 
+// case insensitive hashing and comparison, for unordered containers
+struct ihash {
+	size_t operator () (const char *str) const
+	{
+		// FNV-1a
+		size_t hash = 2166136261u;
+		for (; *str; str++) {
+			hash ^= (unsigned char) tolower((unsigned char) *str);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+};
+
+struct iequal {
+	bool operator () (const char *lhs, const char* rhs) const
+	{
+		return stricmp(lhs, rhs) == 0;
+	}
+};
+
 }
 
 #endif
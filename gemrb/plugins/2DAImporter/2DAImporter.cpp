@@ -23,6 +23,8 @@
 #include "Interface.h"
 #include "System/FileStream.h"
 
+#include <algorithm>
+
 using namespace GemRB;
 
 #define MAXLENGTH 8192      //if a 2da has longer lines, change this
@@ -107,9 +109,43 @@ bool p2DAImporter::Open(DataStream* str)
 		}
 	}
 	delete str;
+
+	BuildIndex(colIndex, colNames);
+	BuildIndex(rowIndex, rowNames);
+	BuildNumbers();
 	return true;
 }
 
+void p2DAImporter::BuildIndex(NameIndex& index, const std::vector<char*>& names)
+{
+	index.reserve(names.size());
+	for (unsigned int i = 0; i < names.size(); i++) {
+		// emplace keeps the first of any duplicates, like the old linear search did
+		index.emplace(names[i], int(i));
+	}
+}
+
+// tables are mostly numbers, so parse them once instead of on every lookup
+void p2DAImporter::BuildNumbers()
+{
+	defNumber = atoi(defVal);
+	numbersWidth = colNames.size();
+	for (const RowEntry& row : rows) {
+		numbersWidth = std::max(numbersWidth, row.size());
+	}
+	numbers.assign(rows.size() * numbersWidth, defNumber);
+	for (size_t r = 0; r < rows.size(); r++) {
+		for (size_t c = 0; c < rows[r].size(); c++) {
+			const char *cell = rows[r][c];
+			if (cell[0] == '*' && !cell[1]) {
+				continue;
+			}
+			// wrap like the usual (ieDword) atoi() casts of the callers
+			numbers[r * numbersWidth + c] = (int) strtol(cell, NULL, 10);
+		}
+	}
+}
+
 #include "plugindef.h"
 
 GEMRB_PLUGIN(0xB22F938, "2DA File Importer")
@@ -24,13 +24,16 @@
 #include "TableMgr.h"
 
 #include "globals.h"
+#include "iless.h"
 
 #include <cstring>
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
 
 using RowEntry = std::vector<char*>;
+using NameIndex = std::unordered_map<const char*, int, ihash, iequal>;
 
 class p2DAImporter : public TableMgr {
 private:
@@ -38,7 +41,17 @@ private:
 	std::vector< char*> rowNames;
 	std::vector< char*> ptrs;
 	std::vector< RowEntry> rows;
+	// name lookups, the keys point into ptrs
+	NameIndex colIndex;
+	NameIndex rowIndex;
+	// every cell parsed as a number, rows are colNames.size() wide
+	std::vector<int> numbers;
+	size_t numbersWidth = 0;
+	int defNumber = 0;
 	char defVal[32];
+
+	static void BuildIndex(NameIndex& index, const std::vector<char*>& names);
+	void BuildNumbers();
 public:
 	p2DAImporter(void);
 	~p2DAImporter(void) override;
@@ -98,6 +111,27 @@ public:
 		return QueryField((unsigned int) rowi, (unsigned int) coli);
 	}
 
+	inline int QueryFieldSigned(size_t row, size_t column) const override
+	{
+		if (row >= rows.size() || column >= numbersWidth) {
+			return defNumber;
+		}
+		return numbers[row * numbersWidth + column];
+	}
+
+	inline int QueryFieldSigned(const char* row, const char* column) const override
+	{
+		int rowi = GetRowIndex(row);
+		if (rowi < 0) {
+			return defNumber;
+		}
+		int coli = GetColumnIndex(column);
+		if (coli < 0) {
+			return defNumber;
+		}
+		return QueryFieldSigned((size_t) rowi, (size_t) coli);
+	}
+
 	const char* QueryDefault() const override
 	{
 		return defVal;
@@ -105,22 +139,16 @@ public:
 
 	inline int GetRowIndex(const char* string) const override
 	{
-		for (unsigned int index = 0; index < rowNames.size(); index++) {
-			if (stricmp( rowNames[index], string ) == 0) {
-				return int(index);
-			}
-		}
-		return -1;
+		if (!string) return -1;
+		auto it = rowIndex.find(string);
+		return it == rowIndex.end() ? -1 : it->second;
 	}
 
 	inline int GetColumnIndex(const char* string) const override
 	{
-		for (unsigned int index = 0; index < colNames.size(); index++) {
-			if (stricmp( colNames[index], string ) == 0) {
-				return int(index);
-			}
-		}
-		return -1;
+		if (!string) return -1;
+		auto it = colIndex.find(string);
+		return it == colIndex.end() ? -1 : it->second;
 	}
 
 	inline const char* GetColumnName(unsigned int index) const override
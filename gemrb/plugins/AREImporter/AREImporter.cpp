@@ -393,6 +393,42 @@ static Ambient* SetupMainAmbients(Map *map, bool day_or_night) {
 	return ambi;
 }
 
+// only the day versions, night areas are rare
+void AREImporter::GetResourceList(std::vector<ResourceRequest>& list)
+{
+	ieResRef TmpResRef;
+
+	list.push_back({ WEDResRef, IE_WED_CLASS_ID });
+	list.push_back({ WEDResRef, IE_TIS_CLASS_ID });
+	list.push_back({ WEDResRef, IE_MOS_CLASS_ID });
+	static const char *bitmaps[] = { "LM", "SR", "HT" };
+	for (const char *suffix : bitmaps) {
+		snprintf(TmpResRef, 9, "%.6s%s", WEDResRef, suffix);
+		list.push_back({ TmpResRef, IE_BMP_CLASS_ID });
+	}
+	if (Script[0]) {
+		list.push_back({ Script, IE_BCS_CLASS_ID });
+	}
+
+	ieDword Flags, CreOffset;
+	for (unsigned int i = 0; i < ActorCount; i++) {
+		str->Seek(ActorOffset + i * 0x110 + 0x28, GEM_STREAM_START);
+		str->ReadDword(&Flags);
+		str->Seek(ActorOffset + i * 0x110 + 0x80, GEM_STREAM_START);
+		str->ReadResRef(TmpResRef);
+		str->ReadDword(&CreOffset);
+		// embedded creatures come with the area
+		if (CreOffset != 0 && !(Flags&1)) continue;
+		list.push_back({ TmpResRef, IE_CRE_CLASS_ID });
+	}
+
+	for (unsigned int i = 0; i < AnimCount; i++) {
+		str->Seek(AnimOffset + i * 0x4c + 0x28, GEM_STREAM_START);
+		str->ReadResRef(TmpResRef);
+		list.push_back({ TmpResRef, IE_BAM_CLASS_ID });
+	}
+}
+
 Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 {
 	unsigned int i,x;
@@ -507,7 +543,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 
 	map->AddTileMap( tm, lm->GetImage(), sr->GetBitmap(), sm ? sm->GetSprite2D() : NULL, hm->GetBitmap() );
 
-	Log(DEBUG, "AREImporter", "Loading songs");
+	LogDebug("AREImporter", "Loading songs");
 	str->Seek( SongHeader, GEM_STREAM_START );
 	//5 is the number of song indices
 	for (i = 0; i < MAX_RESCOUNT; i++) {
@@ -571,7 +607,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 	str->ReadWord( &map->RestHeader.DayChance );
 	str->ReadWord( &map->RestHeader.NightChance );
 
-	Log(DEBUG, "AREImporter", "Loading regions");
+	LogDebug("AREImporter", "Loading regions");
 	core->LoadProgress(70);
 	//Loading InfoPoints
 	for (i = 0; i < InfoPointsCount; i++) {
@@ -735,7 +771,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		}
 	}
 
-	Log(DEBUG, "AREImporter", "Loading containers");
+	LogDebug("AREImporter", "Loading containers");
 	for (i = 0; i < ContainersCount; i++) {
 		str->Seek( ContainersOffset + ( i * 0xC0 ), GEM_STREAM_START );
 		ieVariable Name;
@@ -847,7 +883,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		c->OpenFail = OpenFail;
 	}
 
-	Log(DEBUG, "AREImporter", "Loading doors");
+	LogDebug("AREImporter", "Loading doors");
 	for (i = 0; i < DoorsCount; i++) {
 		str->Seek( DoorsOffset + ( i * 0xc8 ), GEM_STREAM_START );
 		int count;
@@ -1062,7 +1098,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		door->SetDialog(Dialog);
 	}
 
-	Log(DEBUG, "AREImporter", "Loading spawnpoints");
+	LogDebug("AREImporter", "Loading spawnpoints");
 	for (i = 0; i < SpawnCount; i++) {
 		str->Seek( SpawnOffset + (i*0xc8), GEM_STREAM_START );
 		ieVariable Name;
@@ -1118,7 +1154,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 	int pst = core->HasFeature(GF_AUTOMAP_INI);
 
 	core->LoadProgress(75);
-	Log(DEBUG, "AREImporter", "Loading actors");
+	LogDebug("AREImporter", "Loading actors");
 	str->Seek( ActorOffset, GEM_STREAM_START );
 	if (!core->IsAvailable( IE_CRE_CLASS_ID )) {
 		Log(WARNING, "AREImporter", "No Actor Manager Available, skipping actors");
@@ -1250,7 +1286,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 	}
 
 	core->LoadProgress(90);
-	Log(DEBUG, "AREImporter", "Loading animations");
+	LogDebug("AREImporter", "Loading animations");
 	str->Seek( AnimOffset, GEM_STREAM_START );
 	if (!core->IsAvailable( IE_BAM_CLASS_ID )) {
 		Log(WARNING, "AREImporter", "No Animation Manager Available, skipping animations");
@@ -1303,7 +1339,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		}
 	}
 
-	Log(DEBUG, "AREImporter", "Loading entrances");
+	LogDebug("AREImporter", "Loading entrances");
 	str->Seek( EntrancesOffset, GEM_STREAM_START );
 	for (i = 0; i < EntrancesCount; i++) {
 		ieVariable Name;
@@ -1317,7 +1353,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->AddEntrance( Name, XPos, YPos, Face );
 	}
 
-	Log(DEBUG, "AREImporter", "Loading variables");
+	LogDebug("AREImporter", "Loading variables");
 	map->locals->LoadInitialValues(ResRef);
 	str->Seek( VariablesOffset, GEM_STREAM_START );
 	for (i = 0; i < VariablesCount; i++) {
@@ -1331,7 +1367,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->locals->SetAt( Name, Value );
 	}
 
-	Log(DEBUG, "AREImporter", "Loading ambients");
+	LogDebug("AREImporter", "Loading ambients");
 	str->Seek( AmbiOffset, GEM_STREAM_START );
 	for (i = 0; i < AmbiCount; i++) {
 		int j;
@@ -1372,7 +1408,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->AddAmbient(ambi);
 	}
 
-	Log(DEBUG, "AREImporter", "Loading automap notes");
+	LogDebug("AREImporter", "Loading automap notes");
 	str->Seek( NoteOffset, GEM_STREAM_START );
 
 	Point point;
@@ -1470,7 +1506,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 	}
 
 	//this is a ToB feature (saves the unexploded projectiles)
-	Log(DEBUG, "AREImporter", "Loading traps");
+	LogDebug("AREImporter", "Loading traps");
 	for (i = 0; i < TrapCount; i++) {
 		ieResRef TrapResRef;
 		ieDword TrapEffOffset;
@@ -1523,7 +1559,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->AddProjectile( pro, pos, pos);
 	}
 
-	Log(DEBUG, "AREImporter", "Loading tiles");
+	LogDebug("AREImporter", "Loading tiles");
 	//Loading Tiled objects (if any)
 	str->Seek( TileOffset, GEM_STREAM_START );
 	for (i = 0; i < TileCount; i++) {
@@ -1550,7 +1586,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->TMap->AddTile( ID, Name, Flags, NULL,0, NULL, 0 );
 	}
 
-	Log(DEBUG, "AREImporter", "Loading explored bitmap");
+	LogDebug("AREImporter", "Loading explored bitmap");
 	i = map->GetExploredMapSize();
 	if (ExploredBitmapSize==i) {
 		map->ExploredBitmap = (ieByte *) malloc(i);
@@ -1567,7 +1603,7 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 	}
 	map->VisibleBitmap = (ieByte *) calloc(i, 1);
 
-	Log(DEBUG, "AREImporter", "Loading wallgroups");
+	LogDebug("AREImporter", "Loading wallgroups");
 	map->SetWallGroups(tmm->GetWallGroups());
 	//setting up doors
 	for (i=0;i<DoorsCount;i++) {
@@ -66,6 +66,7 @@ public:
 	bool Open(DataStream* stream) override;
 	bool ChangeMap(Map *map, bool day_or_night) override;
 	Map* GetMap(const char* ResRef, bool day_or_night) override;
+	void GetResourceList(std::vector<ResourceRequest>& list) override;
 	int GetStoredFileSize(Map *map) override;
 	/* stores an area in the Cache (swaps it out) */
 	int PutArea(DataStream *stream, Map *map) override;
@@ -181,14 +181,19 @@ void* BAMImporter::GetFramePixels(unsigned short findex)
 		if (RLESize > remains) {
 			RLESize = remains;
 		}
-		unsigned char* inpix;
-		inpix = (unsigned char*)malloc( RLESize );
-		if (str->Read( inpix, RLESize ) == GEM_ERROR) {
-			free( pixels );
-			free( inpix );
-			return NULL;
+		// decode straight from the stream memory if it has any
+		unsigned char* copy = NULL;
+		const unsigned char* inpix = (const unsigned char*) str->Map(str->GetPos(), RLESize);
+		if (!inpix) {
+			copy = (unsigned char*) malloc(RLESize);
+			if (str->Read(copy, RLESize) == GEM_ERROR) {
+				free( pixels );
+				free(copy);
+				return NULL;
+			}
+			inpix = copy;
 		}
-		unsigned char * p = inpix;
+		const unsigned char* p = inpix;
 		unsigned char * Buffer = (unsigned char*)pixels;
 		unsigned int i = 0;
 		while (i < pixelcount) {
@@ -211,22 +216,27 @@ void* BAMImporter::GetFramePixels(unsigned short findex)
 			p++;
 			i++;
 		}
-		free( inpix );
+		free(copy);
 	} else {
 		str->Read( pixels, pixelcount );
 	}
 	return pixels;
 }
 
-ieWord * BAMImporter::CacheFLT(unsigned int &count)
+unsigned int BAMImporter::FLTCount() const
 {
-	count = 0;
+	unsigned int count = 0;
 	for (int i = 0; i < CyclesCount; i++) {
 		unsigned int tmp = cycles[i].FirstFrame + cycles[i].FramesCount;
 		if (tmp > count) {
 			count = tmp;
 		}
 	}
+	return count;
+}
+
+ieWord * BAMImporter::CacheFLT(unsigned int count)
+{
 	if (count == 0) return NULL;
 
 	ieWord * FLT = ( ieWord * ) calloc( count, sizeof(ieWord) );
@@ -240,9 +250,18 @@ ieWord * BAMImporter::CacheFLT(unsigned int &count)
 
 AnimationFactory* BAMImporter::GetAnimationFactory(const char* ResRef, unsigned char mode, bool allowCompression)
 {
-	unsigned int i, count;
+	unsigned int i;
 	AnimationFactory* af = new AnimationFactory( ResRef );
-	ieWord *FLT = CacheFLT( count );
+	unsigned int count = FLTCount();
+	// the factory copies the FLT anyway, so only copy it here when it needs swapping
+	ieWord *FLTCopy = NULL;
+	const ieWord *FLT = NULL;
+	if (count && !DataStream::BigEndian()) {
+		FLT = (const ieWord *) str->Map(FLTOffset, count * sizeof(ieWord));
+	}
+	if (!FLT) {
+		FLT = FLTCopy = CacheFLT(count);
+	}
 
 	allowCompression = allowCompression && core->GetVideoDriver()->SupportsBAMSprites();
 	unsigned char* data = NULL;
@@ -251,10 +270,20 @@ AnimationFactory* BAMImporter::GetAnimationFactory(const char* ResRef, unsigned
 		str->Seek( DataStart, GEM_STREAM_START );
 		unsigned long length = str->Remains();
 		if (length == 0) return af;
-		//data = new unsigned char[length];
-		data = (unsigned char *) malloc(length);
-		str->Read( data, length );
-		af->SetFrameData(data);
+		// the RLE frames point into the data, so keep the mapping alive with the
+		// factory instead of copying everything out of it
+		DataStream *source = str->Clone();
+		if (source) {
+			data = (unsigned char *) source->Map(DataStart, length);
+		}
+		if (data) {
+			af->SetFrameSource(source);
+		} else {
+			delete source;
+			data = (unsigned char *) malloc(length);
+			str->Read( data, length );
+			af->SetFrameData(data);
+		}
 	}
 
 	for (i = 0; i < FramesCount; ++i) {
@@ -263,11 +292,12 @@ AnimationFactory* BAMImporter::GetAnimationFactory(const char* ResRef, unsigned
 		assert(!RLECompressed || frame->BAM);
 		af->AddFrame(frame);
 	}
+	af->PackFrames();
 	for (i = 0; i < CyclesCount; ++i) {
 		af->AddCycle( cycles[i] );
 	}
 	af->LoadFLT ( FLT, count );
-	free (FLT);
+	free(FLTCopy);
 	return af;
 }
 
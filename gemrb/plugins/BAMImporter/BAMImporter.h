@@ -55,7 +55,8 @@ private:
 	Holder<Sprite2D> GetFrameInternal(unsigned short findex, unsigned char mode,
 							   bool RLESprite, unsigned char* data);
 	void* GetFramePixels(unsigned short findex);
-	ieWord * CacheFLT(unsigned int &count);
+	unsigned int FLTCount() const;
+	ieWord * CacheFLT(unsigned int count);
 public:
 	BAMImporter(void);
 	~BAMImporter(void) override;
@@ -172,8 +172,15 @@ int BIFImporter::OpenArchive(const char* path)
 
 DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 {
+	// the entries are normally stored in locator order, so the locator
+	// is the index; tilesets are numbered from 1
 	if (Type == IE_TIS_CLASS_ID) {
 		unsigned int srcResLoc = Resource & 0xFC000;
+		unsigned int idx = srcResLoc >> 14;
+		if (idx && idx <= tentcount && (tentries[idx - 1].resLocator & 0xFC000) == srcResLoc) {
+			return SliceStream(stream, tentries[idx - 1].dataOffset,
+						tentries[idx - 1].tileSize * tentries[idx - 1].tilesCount);
+		}
 		for (unsigned int i = 0; i < tentcount; i++) {
 			if (( tentries[i].resLocator & 0xFC000 ) == srcResLoc) {
 				return SliceStream( stream, tentries[i].dataOffset,
@@ -182,6 +189,10 @@ DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 		}
 	} else {
 		ieDword srcResLoc = Resource & 0x3FFF;
+		if (srcResLoc < fentcount && (fentries[srcResLoc].resLocator & 0x3FFF) == srcResLoc) {
+			return SliceStream(stream, fentries[srcResLoc].dataOffset,
+						fentries[srcResLoc].fileSize);
+		}
 		for (ieDword i = 0; i < fentcount; i++) {
 			if (( fentries[i].resLocator & 0x3FFF ) == srcResLoc) {
 				return SliceStream( stream, fentries[i].dataOffset,
@@ -361,11 +361,11 @@ static const ieResRef *ResolveSpellIndex(int index, int level, ieIWD2SpellType t
 		int level2 = spllist[index].FindSpell(type);
 		// grrr, some rows have no levels set - they're all 0, but with a valid resref, so just return that
 		if (level2 == -1) {
-			Log(DEBUG, "CREImporter", "Spell entry (%d) without any levels set!", index);
+			LogDebug("CREImporter", "Spell entry (%d) without any levels set!", index);
 			return spllist[index].GetSpell();
 		}
 		ret = spllist[index].FindSpell(level2, type);
-		if (ret) Log(DEBUG, "CREImporter", "The spell was found at level %d!", level2);
+		if (ret) LogDebug("CREImporter", "The spell was found at level %d!", level2);
 	}
 	if (ret || (kit==-1) ) {
 		return ret;
@@ -436,7 +436,7 @@ int fx_unknown (Scriptable* Owner, Actor* target, Effect* fx);//???
 // FIXME: Make this an ordered list, so we could use bsearch!
 static EffectDesc effectnames[] = {
 	EffectDesc("*Crash*", fx_crash, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("ACVsCreatureType", fx_generic_effect, 0, -1 ), //0xdb
 	EffectDesc("ACVsDamageTypeModifier", fx_ac_vs_damage_type_modifier, 0, -1 ),
 	EffectDesc("ACVsDamageTypeModifier2", fx_ac_vs_damage_type_modifier, 0, -1 ), // used in IWD
@@ -490,7 +490,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("ChaosShieldModifier", fx_chaos_shield_modifier, 0, -1 ),
 	EffectDesc("CharismaModifier", fx_charisma_modifier, EFFECT_SPECIAL_UNDO, -1 ),
 	EffectDesc("CheckForBerserkModifier", fx_checkforberserk_modifier, 0, -1 ),
-	EffectDesc("ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("Color:BriefRGB", fx_brief_rgb, 0, -1 ),
 	EffectDesc("Color:GlowRGB", fx_glow_rgb, 0, -1 ),
 	EffectDesc("Color:DarkenRGB", fx_darken_rgb, 0, -1 ),
@@ -503,7 +503,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("ControlCreature", fx_set_charmed_state, 0, -1 ), //0xf1 same as charm
 	EffectDesc("CreateContingency", fx_create_contingency, 0, -1 ),
 	EffectDesc("CriticalHitModifier", fx_critical_hit_modifier, 0, -1 ),
-	EffectDesc("CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("Cure:Berserk", fx_cure_berserk_state, 0, -1 ),
 	EffectDesc("Cure:Blind", fx_cure_blind_state, 0, -1 ),
 	EffectDesc("Cure:CasterHold", fx_unpause_caster, 0, -1 ),
@@ -532,8 +532,8 @@ static EffectDesc effectnames[] = {
 	EffectDesc("CurrentHPModifier", fx_current_hp_modifier, EFFECT_DICED, -1 ),
 	EffectDesc("Damage", fx_damage, EFFECT_DICED, -1 ),
 	EffectDesc("DamageAnimation", fx_damage_animation, 0, -1 ),
-	EffectDesc("DamageBonusModifier", fx_damage_bonus_modifier, 0, -1 ),
-	EffectDesc("DamageBonusModifier2", fx_damage_bonus_modifier, 0, -1), //49 (iwd, ee)
+	EffectDesc("DamageBonusModifier", fx_damage_bonus_modifier, EFFECT_STATIC, -1 ),
+	EffectDesc("DamageBonusModifier2", fx_damage_bonus_modifier, EFFECT_STATIC, -1), //49 (iwd, ee)
 	EffectDesc("DamageLuckModifier", fx_damageluck_modifier, 0, -1 ),
 	EffectDesc("DamageVsCreature", fx_generic_effect, 0, -1 ),
 	EffectDesc("Death", fx_death, 0, -1 ),
@@ -559,7 +559,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("DrainItems", fx_drain_items, 0, -1 ),
 	EffectDesc("DrainSpells", fx_drain_spells, 0, -1 ),
 	EffectDesc("DropWeapon", fx_drop_weapon, 0, -1 ),
-	EffectDesc("ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("ExistanceDelayModifier", fx_existance_delay_modifier , 0, -1 ), //unknown
 	EffectDesc("ExperienceModifier", fx_experience_modifier, 0, -1 ),
 	EffectDesc("ExploreModifier", fx_explore_modifier, 0, -1 ),
@@ -569,8 +569,8 @@ static EffectDesc effectnames[] = {
 	EffectDesc("FatigueModifier", fx_fatigue_modifier, EFFECT_SPECIAL_UNDO, -1 ),
 	EffectDesc("FindFamiliar", fx_find_familiar, 0, -1 ),
 	EffectDesc("FindTraps", fx_find_traps, 0, -1 ),
-	EffectDesc("FindTrapsModifier", fx_find_traps_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("FindTrapsModifier", fx_find_traps_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("FistDamageModifier", fx_fist_damage_modifier, 0, -1 ),
 	EffectDesc("FistHitModifier", fx_fist_to_hit_modifier, 0, -1 ),
 	EffectDesc("ForceSurgeModifier", fx_force_surge_modifier, 0, -1 ),
@@ -599,15 +599,15 @@ static EffectDesc effectnames[] = {
 	EffectDesc("KillCreatureType", fx_kill_creature_type, 0, -1 ),
 	EffectDesc("LevelModifier", fx_level_modifier, 0, -1 ),
 	EffectDesc("LevelDrainModifier", fx_leveldrain_modifier, 0, -1 ),
-	EffectDesc("LoreModifier", fx_lore_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("LoreModifier", fx_lore_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("LuckModifier", fx_luck_modifier, EFFECT_NO_LEVEL_CHECK|EFFECT_SPECIAL_UNDO, -1 ),
 	EffectDesc("LuckCumulative", fx_luck_cumulative, 0, -1 ),
 	EffectDesc("LuckNonCumulative", fx_luck_non_cumulative, 0, -1 ),
-	EffectDesc("MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("MagicalRest", fx_magical_rest, 0, -1 ),
-	EffectDesc("MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, 0, -1 ),
-	EffectDesc("MagicResistanceModifier", fx_magic_resistance_modifier, 0, -1 ),
+	EffectDesc("MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, EFFECT_STATIC, -1 ),
+	EffectDesc("MagicResistanceModifier", fx_magic_resistance_modifier, EFFECT_STATIC, -1 ),
 	EffectDesc("MassRaiseDead", fx_mass_raise_dead, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("MaximumHPModifier", fx_maximum_hp_modifier, EFFECT_DICED|EFFECT_SPECIAL_UNDO, -1 ),
 	EffectDesc("Maze", fx_maze, 0, -1 ),
@@ -617,7 +617,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("MiscastMagicModifier", fx_miscast_magic_modifier, 0, -1 ),
 	EffectDesc("MissileDamageModifier", fx_missile_damage_modifier, 0, -1 ),
 	EffectDesc("MissileHitModifier", fx_missile_to_hit_modifier, 0, -1 ),
-	EffectDesc("MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("MirrorImage", fx_mirror_image, 0, -1 ),
 	EffectDesc("MirrorImageModifier", fx_mirror_image_modifier, 0, -1 ),
 	EffectDesc("ModifyGlobalVariable", fx_modify_global_variable, EFFECT_NO_ACTOR, -1 ),
@@ -642,12 +642,12 @@ static EffectDesc effectnames[] = {
 	EffectDesc("Overlay:ShieldGlobe", fx_set_shieldglobe_state, 0, -1 ),
 	EffectDesc("Overlay:Web", fx_set_web_state, 0, -1 ),
 	EffectDesc("PauseTarget", fx_pause_target, 0, -1 ), //also known as casterhold
-	EffectDesc("PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("PlayMovie", fx_play_movie, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("PlaySound", fx_playsound, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("PlayVisualEffect", fx_play_visual_effect, EFFECT_REINIT_ON_LOAD, -1 ),
-	EffectDesc("PoisonResistanceModifier", fx_poison_resistance_modifier, 0, -1 ),
+	EffectDesc("PoisonResistanceModifier", fx_poison_resistance_modifier, EFFECT_STATIC, -1 ),
 	EffectDesc("Polymorph", fx_polymorph, 0, -1 ),
 	EffectDesc("PortraitChange", fx_portrait_change, 0, -1 ),
 	EffectDesc("PowerWordKill", fx_power_word_kill, 0, -1 ),
@@ -691,11 +691,11 @@ static EffectDesc effectnames[] = {
 	EffectDesc("RestoreSpells", fx_restore_spell_level, 0, -1 ),
 	EffectDesc("RetreatFrom2", fx_turn_undead, 0, -1 ),
 	EffectDesc("RightHitModifier", fx_right_to_hit_modifier, 0, -1 ),
-	EffectDesc("SaveVsBreathModifier", fx_save_vs_breath_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsDeathModifier", fx_save_vs_death_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsPolyModifier", fx_save_vs_poly_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsSpellsModifier", fx_save_vs_spell_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsWandsModifier", fx_save_vs_wands_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("SaveVsBreathModifier", fx_save_vs_breath_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("SaveVsDeathModifier", fx_save_vs_death_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("SaveVsPolyModifier", fx_save_vs_poly_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("SaveVsSpellsModifier", fx_save_vs_spell_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("SaveVsWandsModifier", fx_save_vs_wands_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("ScreenShake", fx_screenshake, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("ScriptingState", fx_scripting_state, 0, -1 ),
 	EffectDesc("Sequencer:Activate", fx_activate_spell_sequencer, EFFECT_PRESET_TARGET, -1 ),
@@ -709,7 +709,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("SetTrap", fx_set_area_effect, 0, -1 ),
 	EffectDesc("SetTrapsModifier", fx_set_traps_modifier, 0, -1 ),
 	EffectDesc("SexModifier", fx_sex_modifier, 0, -1 ),
-	EffectDesc("SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("Sparkle", fx_sparkle, 0, -1 ),
 	EffectDesc("SpellDurationModifier", fx_spell_duration_modifier, 0, -1 ),
 	EffectDesc("Spell:Add", fx_add_innate, 0, -1 ),
@@ -749,19 +749,19 @@ static EffectDesc effectnames[] = {
 	EffectDesc("State:Sleep", fx_set_unconscious_state, 0, -1 ),
 	EffectDesc("State:Slowed", fx_set_slowed_state, 0, -1 ),
 	EffectDesc("State:Stun", fx_set_stun_state, 0, -1 ),
-	EffectDesc("StealthModifier", fx_stealth_modifier, 0, -1 ),
+	EffectDesc("StealthModifier", fx_stealth_modifier, EFFECT_STATIC, -1 ),
 	EffectDesc("StoneSkinModifier", fx_stoneskin_modifier, 0, -1 ),
 	EffectDesc("StoneSkin2Modifier", fx_golem_stoneskin_modifier, 0, -1 ),
 	EffectDesc("StrengthModifier", fx_strength_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("StrengthBonusModifier", fx_strength_bonus_modifier, 0, -1 ),
+	EffectDesc("StrengthBonusModifier", fx_strength_bonus_modifier, EFFECT_STATIC, -1 ),
 	EffectDesc("SummonCreature", fx_summon_creature, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("RandomTeleport", fx_teleport_field, 0, -1 ),
 	EffectDesc("TeleportToTarget", fx_teleport_to_target, 0, -1 ),
 	EffectDesc("TimelessState", fx_timeless_modifier, 0, -1 ),
 	EffectDesc("Timestop", fx_timestop, 0, -1 ),
 	EffectDesc("TitleModifier", fx_title_modifier, 0, -1 ),
-	EffectDesc("ToHitModifier", fx_to_hit_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("ToHitBonusModifier", fx_to_hit_bonus_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("ToHitModifier", fx_to_hit_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
+	EffectDesc("ToHitBonusModifier", fx_to_hit_bonus_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STATIC, -1 ),
 	EffectDesc("ToHitVsCreature", fx_generic_effect, 0, -1 ),
 	EffectDesc("TrackingModifier", fx_tracking_modifier, EFFECT_SPECIAL_UNDO, -1 ),
 	EffectDesc("TransparencyModifier", fx_transparency_modifier, 0, -1 ),
@@ -1379,7 +1379,7 @@ int fx_damage (Scriptable* /*Owner*/, Actor* target, Effect* fx)
 	}
 
 	if (core->HasFeature(GF_3ED_RULES) && target->GetStat(IE_MC_FLAGS) & MC_INVULNERABLE) {
-		Log(DEBUG, "fx_damage", "Attacking invulnerable target, skipping!");
+		LogDebug("fx_damage", "Attacking invulnerable target, skipping!");
 		return FX_NOT_APPLIED;
 	}
 
@@ -244,6 +244,7 @@ Game* GAMImporter::LoadGame(Game *newGame, int ver_override)
 		newGame->kaputz = new Variables();
 		newGame->kaputz->SetType( GEM_VARIABLES_INT );
 		newGame->kaputz->ParseKey( 1 );
+		newGame->kaputz->InternKeys();
 		// load initial values from var.var
 		newGame->kaputz->LoadInitialValues("KAPUTZ");
 		str->Seek( KillVarsOffset, GEM_STREAM_START );
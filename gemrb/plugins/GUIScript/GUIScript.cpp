@@ -31,6 +31,7 @@
 #include "DialogHandler.h"
 #include "DisplayMessage.h"
 #include "EffectQueue.h"
+#include "FrameProfiler.h"
 #include "Game.h"
 #include "GameData.h"
 #include "ImageFactory.h"
@@ -4423,7 +4424,7 @@ static PyObject* GemRB_CheckVar(PyObject * /*self*/, PyObject* args)
 		return NULL;
 	}
 	long value =(long) CheckVariable(Sender, Variable, Context);
-	Log(DEBUG, "GUISCript", "%s %s=%ld",
+	LogDebug("GUISCript", "%s %s=%ld",
 		Context, Variable, value);
 	return PyInt_FromLong( value );
 }
@@ -8213,6 +8214,19 @@ static PyObject* GemRB_ConsoleWindowLog(PyObject * /*self*/, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_ProfileFrames__doc,
+			 "ProfileFrames(mode)\n\n"
+			 "Profiles the main loop phases: 1 shows an overlay, 2 writes a CSV file, 3 does both and 0 stops." );
+
+static PyObject* GemRB_ProfileFrames(PyObject * /*self*/, PyObject* args)
+{
+	int mode;
+	PARSE_ARGS(args, "i", &mode);
+
+	FrameProfiler::SetMode(mode);
+	Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR( GemRB_GetCurrentArea__doc,
 "===== GetCurrentArea =====\n\
 \n\
@@ -13441,6 +13455,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(PlaySound, METH_VARARGS),
 	METHOD(PlayMovie, METH_VARARGS),
 	METHOD(PrepareSpontaneousCast, METH_VARARGS),
+	METHOD(ProfileFrames, METH_VARARGS),
 	METHOD(RemoveItem, METH_VARARGS),
 	METHOD(RemoveSpell, METH_VARARGS),
 	METHOD(RemoveEffects, METH_VARARGS),
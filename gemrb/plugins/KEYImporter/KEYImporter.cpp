@@ -29,9 +29,12 @@
 
 using namespace GemRB;
 
+#define MAX_OPEN_ARCHIVES 16
+
 KEYImporter::KEYImporter(void)
 {
 	description = NULL;
+	archiveUses = 0;
 }
 
 KEYImporter::~KEYImporter(void)
@@ -224,8 +227,9 @@ DataStream* KEYImporter::GetStream(const char *resname, ieWord type)
 		return NULL;
 	}
 
-	PluginHolder<IndexedArchive> ai(IE_BIF_CLASS_ID);
-	if (ai->OpenArchive( biffiles[bifnum].path ) == GEM_ERROR) {
+	std::lock_guard<std::mutex> lock(archiveLock);
+	IndexedArchive *ai = GetArchive(bifnum);
+	if (!ai) {
 		print("Cannot open archive %s", biffiles[bifnum].path);
 		return NULL;
 	}
@@ -241,6 +245,40 @@ DataStream* KEYImporter::GetStream(const char *resname, ieWord type)
 	return NULL;
 }
 
+// call with archiveLock held
+IndexedArchive *KEYImporter::GetArchive(unsigned int bifnum)
+{
+	archiveUses++;
+	for (KEYCache& cached : openArchives) {
+		if (cached.bifnum == bifnum) {
+			cached.lastUse = archiveUses;
+			return cached.plugin.get();
+		}
+	}
+
+	PluginHolder<IndexedArchive> ai(IE_BIF_CLASS_ID);
+	if (ai->OpenArchive(biffiles[bifnum].path) == GEM_ERROR) {
+		return NULL;
+	}
+
+	KEYCache *slot;
+	if (openArchives.size() < MAX_OPEN_ARCHIVES) {
+		openArchives.emplace_back();
+		slot = &openArchives.back();
+	} else {
+		slot = &openArchives[0];
+		for (KEYCache& cached : openArchives) {
+			if (cached.lastUse < slot->lastUse) {
+				slot = &cached;
+			}
+		}
+	}
+	slot->bifnum = bifnum;
+	slot->plugin = ai;
+	slot->lastUse = archiveUses;
+	return slot->plugin.get();
+}
+
 DataStream* KEYImporter::GetResource(const char* resname, SClass_ID type)
 {
 	//the word masking is a hack for synonyms, currently used for bcs==bs
@@ -28,6 +28,7 @@
 
 #include "StringMap.h"
 
+#include <mutex>
 #include <vector>
 
 namespace GemRB {
@@ -45,10 +46,11 @@ struct BIFEntry {
 };
 
 struct KEYCache {
-	KEYCache() { bifnum = 0xffffffff; }
+	KEYCache() { bifnum = 0xffffffff; lastUse = 0; }
 
 	unsigned int bifnum;
 	PluginHolder<IndexedArchive> plugin;
+	unsigned long lastUse;
 };
 
 // the key for this specific hashmap
@@ -130,6 +132,13 @@ class KEYImporter : public ResourceSource {
 private:
 	std::vector< BIFEntry> biffiles;
 	KEYImpMap resources;
+	// recently used archives are kept open, so their entry tables aren't reread
+	std::vector<KEYCache> openArchives;
+	unsigned long archiveUses;
+	// resources are also requested from the ambient sound thread
+	std::mutex archiveLock;
+
+	IndexedArchive *GetArchive(unsigned int bifnum);
 
 	/** Gets the stream assoicated to a RESKey */
 	DataStream *GetStream(const char *resname, ieWord type);
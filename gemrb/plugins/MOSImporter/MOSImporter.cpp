@@ -87,30 +87,38 @@ Holder<Sprite2D> MOSImporter::GetSprite2D()
 			int bw = ( x == Cols - 1 ) ?
 				( ( Width % 64 ) == 0 ? 64 : Width % 64 ) :
 				64;
-			str->Seek( PalOffset + ( y * Cols * 1024 ) +
-				( x * 1024 ), GEM_STREAM_START );
-			str->Read( &Col[0], 1024 );
+			// use the stream memory directly when it has any
+			unsigned long palpos = PalOffset + ( y * Cols * 1024 ) + ( x * 1024 );
+			const Color *pal = (const Color *) str->Map(palpos, 1024);
+			if (!pal) {
+				str->Seek(palpos, GEM_STREAM_START);
+				str->Read( &Col[0], 1024 );
+				pal = Col;
+			}
 			str->Seek( PalOffset + ( Rows * Cols * 1024 ) +
 				( y * Cols * 4 ) + ( x * 4 ),
 				GEM_STREAM_START );
 			str->ReadDword( &blockoffset );
-			str->Seek( PalOffset + ( Rows * Cols * 1024 ) +
-				( Rows * Cols * 4 ) + blockoffset,
-				GEM_STREAM_START );
-			str->Read( blockpixels, bw * bh );
-			unsigned char * bp = blockpixels;
+			unsigned long blockpos = PalOffset + ( Rows * Cols * 1024 ) +
+				( Rows * Cols * 4 ) + blockoffset;
+			const unsigned char *bp = (const unsigned char *) str->Map(blockpos, bw * bh);
+			if (!bp) {
+				str->Seek(blockpos, GEM_STREAM_START);
+				str->Read( blockpixels, bw * bh );
+				bp = blockpixels;
+			}
 			unsigned char * startpixel = pixels +
 				( ( Width * 4 * y ) * 64 ) +
 				( 4 * x * 64 );
 			for (int h = 0; h < bh; h++) {
 				for (int w = 0; w < bw; w++) {
-					*startpixel = Col[*bp].r;
+					*startpixel = pal[*bp].r;
 					startpixel++;
-					*startpixel = Col[*bp].g;
+					*startpixel = pal[*bp].g;
 					startpixel++;
-					*startpixel = Col[*bp].b;
+					*startpixel = pal[*bp].b;
 					startpixel++;
-					*startpixel = Col[*bp].a;
+					*startpixel = pal[*bp].a;
 					startpixel++;
 					bp++;
 				}
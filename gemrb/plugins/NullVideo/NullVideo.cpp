@@ -0,0 +1,136 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+
+#include "NullVideo.h"
+
+#include <cstring>
+
+using namespace GemRB;
+
+NullSprite2D::NullSprite2D(const Region& rgn, int Bpp, void* pixels,
+						   ieDword rmask, ieDword gmask, ieDword bmask, ieDword amask)
+	: Sprite2D(rgn, Bpp, pixels), rMask(rmask), gMask(gmask), bMask(bmask), aMask(amask)
+{
+}
+
+NullSprite2D::NullSprite2D(const NullSprite2D &obj)
+	: Sprite2D(obj), rMask(obj.rMask), gMask(obj.gMask), bMask(obj.bMask), aMask(obj.aMask),
+	palette(obj.palette), colorKey(obj.colorKey)
+{
+	// the base class shares the pixels, but copies are modified independently
+	if (obj.pixels) {
+		size_t size = Frame.w * Frame.h * ((Bpp + 7) / 8);
+		pixels = malloc(size);
+		memcpy(pixels, obj.pixels, size);
+		freePixels = true;
+	}
+}
+
+Holder<Sprite2D> NullSprite2D::copy() const
+{
+	return new NullSprite2D(*this);
+}
+
+static inline ieByte MaskedChannel(ieDword px, ieDword mask)
+{
+	if (!mask) return 0;
+	unsigned int shift = 0;
+	while (!(mask & (1u << shift))) {
+		shift++;
+	}
+	ieDword max = mask >> shift;
+	return ieByte(((px & mask) >> shift) * 255 / max);
+}
+
+Color NullSprite2D::GetPixel(const Point& p) const
+{
+	if (!pixels || !Region(Point(), Frame.size).PointInside(p)) {
+		return Color();
+	}
+
+	if (Bpp == 8) {
+		ieByte idx = static_cast<const ieByte*>(pixels)[p.y * Frame.w + p.x];
+		if (!palette || int32_t(idx) == colorKey) {
+			return Color();
+		}
+		return palette->col[idx];
+	}
+
+	int bytes = Bpp / 8;
+	if (bytes < 2 || bytes > 4) {
+		return Color();
+	}
+	ieDword px = 0;
+	memcpy(&px, static_cast<const ieByte*>(pixels) + (p.y * Frame.w + p.x) * bytes, bytes);
+	if (int32_t(px) == colorKey) {
+		return Color();
+	}
+	ieByte a = aMask ? MaskedChannel(px, aMask) : 0xff;
+	return Color(MaskedChannel(px, rMask), MaskedChannel(px, gMask), MaskedChannel(px, bMask), a);
+}
+
+Holder<Sprite2D> NullVideoDriver::CreateSprite(const Region& rgn, int bpp, ieDword rMask,
+	ieDword gMask, ieDword bMask, ieDword aMask, void* pixels, bool cK, int index)
+{
+	NullSprite2D* spr = new NullSprite2D(rgn, bpp, pixels, rMask, gMask, bMask, aMask);
+	if (cK) {
+		spr->SetColorKey(index);
+	}
+	return spr;
+}
+
+Holder<Sprite2D> NullVideoDriver::CreateSprite8(const Region& rgn, void* pixels,
+	PaletteHolder palette, bool cK, int index)
+{
+	NullSprite2D* spr = new NullSprite2D(rgn, 8, pixels, 0, 0, 0, 0);
+	spr->SetPalette(palette);
+	if (cK) {
+		spr->SetColorKey(index);
+	}
+	return spr;
+}
+
+Holder<Sprite2D> NullVideoDriver::CreatePalettedSprite(const Region& rgn, int bpp, void* pixels,
+	Color* palette, bool cK, int index)
+{
+	NullSprite2D* spr = new NullSprite2D(rgn, bpp, pixels, 0, 0, 0, 0);
+	spr->SetPalette(new Palette(palette, palette + 256));
+	if (cK) {
+		spr->SetColorKey(index);
+	}
+	return spr;
+}
+
+Holder<Sprite2D> NullVideoDriver::GetScreenshot(Region r, const VideoBufferPtr&)
+{
+	if (r.size.IsInvalid()) {
+		r = Region(Point(), screenSize);
+	}
+	// a black screen, so save games still get their previews
+	void* pixels = calloc(r.w * r.h, 4);
+	return CreateSprite(Region(Point(), r.size), 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0, pixels);
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0x3C7BDE1, "Null Video Driver")
+PLUGIN_DRIVER(NullVideoDriver, "none")
+END_PLUGIN()
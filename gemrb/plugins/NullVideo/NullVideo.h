@@ -0,0 +1,116 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+
+#ifndef NULLVIDEO_H
+#define NULLVIDEO_H
+
+#include "Video.h"
+
+namespace GemRB {
+
+/**
+ * Sprite keeping its pixels in plain memory, so fonts, cursors and
+ * transparency checks still work without a display.
+ */
+class NullSprite2D : public Sprite2D {
+private:
+	ieDword rMask, gMask, bMask, aMask;
+	PaletteHolder palette;
+	int32_t colorKey = -1;
+
+public:
+	NullSprite2D(const Region&, int Bpp, void* pixels,
+				 ieDword rmask, ieDword gmask, ieDword bmask, ieDword amask);
+	NullSprite2D(const NullSprite2D &obj);
+	Holder<Sprite2D> copy() const override;
+
+	PaletteHolder GetPalette() const override { return palette; }
+	void SetPalette(PaletteHolder pal) override { palette = pal; }
+	Color GetPixel(const Point&) const override;
+	bool HasTransparency() const override { return aMask != 0 || colorKey >= 0; }
+	int32_t GetColorKey() const override { return colorKey; }
+	void SetColorKey(ieDword key) override { colorKey = key; }
+};
+
+class NullVideoBuffer : public VideoBuffer {
+public:
+	NullVideoBuffer(const Region& r) : VideoBuffer(r) {}
+
+	void Clear(const Region&) override {}
+	void CopyPixels(const Region&, const void*, const int* = NULL, ...) override {}
+	bool RenderOnDisplay(void*) const override { return true; }
+};
+
+/**
+ * Video driver that draws nothing and never opens a window, for running
+ * the game logic headless (benchmarks, automated runs).
+ */
+class NullVideoDriver : public Video {
+public:
+	int Init(void) override { return GEM_OK; }
+
+	void SetWindowTitle(const char*) override {}
+	bool SetFullscreenMode(bool set) override { fullscreen = set; return true; }
+	bool ToggleGrabInput() override { return false; }
+	void CaptureMouse(bool) override {}
+
+	void StartTextInput() override {}
+	void StopTextInput() override {}
+	bool InTextInput() override { return false; }
+	bool TouchInputEnabled() override { return false; }
+
+	Holder<Sprite2D> CreateSprite(const Region&, int bpp, ieDword rMask,
+		ieDword gMask, ieDword bMask, ieDword aMask, void* pixels,
+		bool cK = false, int index = 0) override;
+	Holder<Sprite2D> CreateSprite8(const Region&, void* pixels,
+		PaletteHolder palette, bool cK = false, int index = 0) override;
+	Holder<Sprite2D> CreatePalettedSprite(const Region&, int bpp, void* pixels,
+		Color* palette, bool cK = false, int index = 0) override;
+
+	void BlitSprite(const Holder<Sprite2D>, const Region&, Region, BlitFlags, Color = Color()) override {}
+	void BlitGameSprite(const Holder<Sprite2D>, const Point&, BlitFlags, Color = Color()) override {}
+	void BlitVideoBuffer(const VideoBufferPtr&, const Point&, BlitFlags, const Color* = nullptr) override {}
+
+	Holder<Sprite2D> GetScreenshot(Region r, const VideoBufferPtr& buf = nullptr) override;
+	void SetGamma(int, int) override {}
+
+private:
+	void Wait(unsigned long) override {}
+	VideoBuffer* NewVideoBuffer(const Region& r, BufferFormat) override { return new NullVideoBuffer(r); }
+	void SwapBuffers(VideoBuffers&) override {}
+	int PollEvents() override { return GEM_OK; }
+	int CreateDriverDisplay(const char*) override { return GEM_OK; }
+
+	void DrawRectImp(const Region&, const Color&, bool, BlitFlags) override {}
+	void DrawPointImp(const Point&, const Color&, BlitFlags) override {}
+	void DrawPointsImp(const std::vector<Point>&, const Color&, BlitFlags) override {}
+	void DrawCircleImp(const Point&, unsigned short, const Color&, BlitFlags) override {}
+	void DrawEllipseSegmentImp(const Point&, unsigned short, unsigned short, const Color&,
+							   double, double, bool, BlitFlags) override {}
+	void DrawEllipseImp(const Point&, unsigned short, unsigned short, const Color&, BlitFlags) override {}
+	void DrawPolygonImp(const Gem_Polygon*, const Point&, const Color&, bool, BlitFlags) override {}
+	void DrawLineImp(const Point&, const Point&, const Color&, BlitFlags) override {}
+	void DrawLinesImp(const std::vector<Point>&, const Color&, BlitFlags) override {}
+};
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "GameData.h"
 #include "Interface.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -131,10 +132,46 @@ void AudioStream::ClearProcessedBuffers()
 
 }
 
+bool SoundJob::WaitOpened(unsigned int& length)
+{
+	std::unique_lock<std::mutex> l(mutex);
+	cond.wait(l, [this] { return opened; });
+	length = Length;
+	return !failed;
+}
+
+ALuint SoundJob::WaitDone()
+{
+	std::unique_lock<std::mutex> l(mutex);
+	cond.wait(l, [this] { return done; });
+	return Buffer;
+}
+
+void AudioStream::DetachJob()
+{
+	if (!job) return;
+
+	std::lock_guard<std::mutex> l(job->mutex);
+	job->Source = 0;
+	// only called once the source stopped, so the chunks are all unqueued
+	if (!job->chunks.empty()) {
+		alDeleteBuffers(ALsizei(job->chunks.size()), job->chunks.data());
+		checkALError("Failed to delete streamed buffers", WARNING);
+		job->chunks.clear();
+	}
+	job.reset();
+}
+
 void AudioStream::ClearIfStopped()
 {
 	if (free || locked) return;
 
+	if (job) {
+		std::lock_guard<std::mutex> l(job->mutex);
+		// running dry while the decoder catches up is not the end
+		if (job->Source && !job->done) return;
+	}
+
 	if (!Source || !alIsSource(Source)) {
 		checkALError("No AL Context", WARNING);
 		return;
@@ -146,6 +183,7 @@ void AudioStream::ClearIfStopped()
 			state == AL_STOPPED)
 	{
 		ClearProcessedBuffers();
+		DetachJob();
 		alDeleteSources( 1, &Source );
 		checkALError("Failed to delete source", WARNING);
 		Source = 0;
@@ -162,6 +200,11 @@ void AudioStream::ForceClear()
 {
 	if (!Source || !alIsSource(Source)) return;
 
+	if (job) {
+		// stop the decoder from queueing more
+		std::lock_guard<std::mutex> l(job->mutex);
+		job->Source = 0;
+	}
 	alSourceStop(Source);
 	checkALError("Failed to stop source", WARNING);
 	ClearProcessedBuffers();
@@ -177,6 +220,8 @@ OpenALAudioDriver::OpenALAudioDriver(void)
 	memset(MusicBuffer, 0, MUSICBUFFERS*sizeof(ALuint));
 	ambim = NULL;
 	stayAlive = false;
+	cacheBytes = 0;
+	decodersAlive = false;
 	hasReverbProperties = false;
 #ifdef HAVE_OPENAL_EFX_H
 	hasEFX = false;
@@ -244,6 +289,11 @@ bool OpenALAudioDriver::Init(void)
 
 	musicThread = std::thread(&OpenALAudioDriver::MusicManager, this);
 
+	decodersAlive = true;
+	for (int i = 0; i < DECODER_THREADS; i++) {
+		decoderThreads.emplace_back(&OpenALAudioDriver::SoundDecoder, this);
+	}
+
 	if (!InitEFX()) {
 		Log(MESSAGE, "OpenAL", "EFX not available.");
 	}
@@ -346,6 +396,16 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 	// AmigaOS4 should be built with -athread=native or this may not work
 	musicThread.join();
 
+	{
+		std::lock_guard<std::mutex> l(decodeMutex);
+		decodersAlive = false;
+		decodeQueue.clear();
+	}
+	decodeCond.notify_all();
+	for (auto& thread : decoderThreads) {
+		thread.join();
+	}
+
 	for(int i =0; i<num_streams; i++) {
 		streams[i].ForceClear();
 	}
@@ -376,86 +436,242 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 	delete ambim;
 }
 
+// blocks until the sound is fully decoded
 ALuint OpenALAudioDriver::loadSound(const char *ResRef, unsigned int &time_length)
 {
 	ALuint Buffer = 0;
+	std::shared_ptr<SoundJob> job = requestSound(ResRef, Buffer, time_length, true);
+	if (job) {
+		Buffer = job->WaitDone();
+		time_length = job->Length;
+	}
+	return Buffer;
+}
 
-	CacheEntry *e;
-	void* p;
-
+// returns the cached buffer or the job that will produce it
+std::shared_ptr<SoundJob> OpenALAudioDriver::requestSound(const char* ResRef, ALuint& Buffer, unsigned int& time_length, bool urgent)
+{
+	Buffer = 0;
 	if (!ResRef[0]) {
-		return 0;
+		return nullptr;
 	}
-	if(buffercache.Lookup(ResRef, p))
+
+	std::shared_ptr<SoundJob> job;
+	bool fresh = false;
 	{
-		e = (CacheEntry*) p;
-		time_length = e->Length;
-		return e->Buffer;
+		std::lock_guard<std::mutex> l(bufferMutex);
+		void* p;
+		if (buffercache.Lookup(ResRef, p)) {
+			buffercache.Touch(ResRef);
+			const CacheEntry* e = (const CacheEntry*) p;
+			time_length = e->Length;
+			Buffer = e->Buffer;
+			return nullptr;
+		}
+
+		auto it = pendingSounds.find(ResRef);
+		if (it != pendingSounds.end()) {
+			job = it->second;
+		} else {
+			job = std::make_shared<SoundJob>(ResRef);
+			pendingSounds[ResRef] = job;
+			fresh = true;
+		}
 	}
 
-	//no cache entry...
-	alGenBuffers(1, &Buffer);
-	if (checkALError("Unable to create sound buffer", ERROR)) {
-		return 0;
+	if (!fresh && !urgent) {
+		return job;
 	}
 
-	ResourceHolder<SoundMgr> acm = GetResourceHolder<SoundMgr>(ResRef);
-	if (!acm) {
-		alDeleteBuffers( 1, &Buffer );
-		checkALError("Unable to delete buffer!", ERROR);
-		return 0;
+	{
+		std::lock_guard<std::mutex> l(decodeMutex);
+		if (!fresh) {
+			// someone waits for a preloaded sound, move it up the queue
+			auto queued = std::find(decodeQueue.begin(), decodeQueue.end(), job);
+			if (queued == decodeQueue.end()) {
+				// already being decoded
+				return job;
+			}
+			decodeQueue.erase(queued);
+		}
+		if (urgent) {
+			decodeQueue.push_front(job);
+		} else {
+			decodeQueue.push_back(job);
+		}
 	}
-	int cnt = acm->get_length();
-	unsigned int riff_chans = acm->get_channels();
-	int samplerate = acm->get_samplerate();
-	//multiply always by 2 because it is in 16 bits
-	int rawsize = cnt * 2;
-	short* memory = (short*) malloc(rawsize);
-	//multiply always with 2 because it is in 16 bits
-	unsigned int cnt1 = acm->read_samples( memory, cnt ) * 2;
-	//Sound Length in milliseconds
-	time_length = ((cnt / riff_chans) * 1000) / samplerate;
-	//it is always reading the stuff into 16 bits
-	alBufferData( Buffer, GetFormatEnum( riff_chans, 16 ), memory, cnt1, samplerate );
-	free(memory);
-
-	if (checkALError("Unable to fill buffer", ERROR)) {
-		alDeleteBuffers( 1, &Buffer );
-		checkALError("Error deleting buffer", WARNING);
-		return 0;
+	decodeCond.notify_one();
+	return job;
+}
+
+void OpenALAudioDriver::Preload(const char* ResRef)
+{
+	if (!ResRef) return;
+
+	ALuint Buffer;
+	unsigned int time_length;
+	requestSound(ResRef, Buffer, time_length, false);
+}
+
+void OpenALAudioDriver::SoundDecoder()
+{
+	while (true) {
+		std::shared_ptr<SoundJob> job;
+		{
+			std::unique_lock<std::mutex> l(decodeMutex);
+			decodeCond.wait(l, [this] { return !decodersAlive || !decodeQueue.empty(); });
+			if (!decodersAlive) return;
+			job = decodeQueue.front();
+			decodeQueue.pop_front();
+		}
+		Decode(*job);
+	}
+}
+
+void OpenALAudioDriver::Decode(SoundJob& job)
+{
+	ResourceHolder<SoundMgr> acm = GetResourceHolder<SoundMgr>(job.name.c_str());
+	int cnt = acm ? acm->get_length() : 0;
+	{
+		std::lock_guard<std::mutex> l(job.mutex);
+		if (cnt > 0) {
+			int riff_chans = acm->get_channels();
+			job.samplerate = acm->get_samplerate();
+			//Sound Length in milliseconds
+			job.Length = ((cnt / riff_chans) * 1000) / job.samplerate;
+			//it is always reading the stuff into 16 bits
+			job.format = GetFormatEnum(riff_chans, 16);
+			job.pcm = (short*) malloc(cnt * 2);
+		} else {
+			job.failed = true;
+		}
+		job.opened = true;
 	}
+	job.cond.notify_all();
 
-	e = new CacheEntry;
-	e->Buffer = Buffer;
-	e->Length = time_length;
+	// only this thread writes past job.decoded, so the samples need no lock
+	int decoded = 0;
+	while (!job.failed && decoded < cnt) {
+		int count = acm->read_samples(job.pcm + decoded, std::min(DECODE_CHUNK, cnt - decoded));
+		if (count <= 0) break;
 
-	buffercache.SetAt(ResRef, (void*)e);
-	//print("LoadSound: added %s to cache: %d. Cache size now %d", ResRef, e->Buffer, buffercache.GetCount());
+		std::lock_guard<std::mutex> l(job.mutex);
+		if (job.Source) {
+			QueueChunk(job, job.pcm + decoded, count);
+		}
+		decoded += count;
+		job.decoded = decoded;
+	}
 
-	if (buffercache.GetCount() > BUFFER_CACHE_SIZE) {
-		evictBuffer();
+	ALuint Buffer = 0;
+	if (decoded) {
+		alGenBuffers(1, &Buffer);
+		if (checkALError("Unable to create sound buffer", ERROR)) {
+			Buffer = 0;
+		} else {
+			//multiply always by 2 because it is in 16 bits
+			alBufferData(Buffer, job.format, job.pcm, decoded * 2, job.samplerate);
+			if (checkALError("Unable to fill buffer", ERROR)) {
+				alDeleteBuffers(1, &Buffer);
+				checkALError("Error deleting buffer", WARNING);
+				Buffer = 0;
+			}
+		}
 	}
-	return Buffer;
+
+	{
+		std::lock_guard<std::mutex> l(bufferMutex);
+		if (Buffer) {
+			CacheEntry* e = new CacheEntry;
+			e->Buffer = Buffer;
+			e->Length = job.Length;
+			e->Size = decoded * 2;
+			buffercache.SetAt(job.name.c_str(), (void*) e);
+			cacheBytes += e->Size;
+			while (cacheBytes > BUFFER_CACHE_BYTES && evictBuffer()) { }
+		}
+		pendingSounds.erase(job.name);
+	}
+
+	{
+		std::lock_guard<std::mutex> l(job.mutex);
+		job.Buffer = Buffer;
+		job.done = true;
+		free(job.pcm);
+		job.pcm = nullptr;
+	}
+	job.cond.notify_all();
+}
+
+// caller holds job.mutex
+void OpenALAudioDriver::QueueChunk(SoundJob& job, const short* samples, int count)
+{
+	// drop the chunks that were played, otherwise a source that ran dry
+	// while we decoded would start over from the first one
+	ALint processed = 0;
+	alGetSourcei(job.Source, AL_BUFFERS_PROCESSED, &processed);
+	if (!checkALError("Failed to get processed buffers", WARNING) && processed > 0) {
+		std::vector<ALuint> played(processed);
+		alSourceUnqueueBuffers(job.Source, processed, played.data());
+		if (!checkALError("Failed to unqueue buffers", WARNING)) {
+			alDeleteBuffers(processed, played.data());
+			checkALError("Failed to delete streamed buffers", WARNING);
+			// the source plays them in the order they were queued
+			job.chunks.erase(job.chunks.begin(), job.chunks.begin() + processed);
+		}
+	}
+
+	ALuint chunk;
+	alGenBuffers(1, &chunk);
+	if (checkALError("Unable to create streamed buffer", ERROR)) {
+		return;
+	}
+	alBufferData(chunk, job.format, samples, count * 2, job.samplerate);
+	if (checkALError("Unable to fill streamed buffer", ERROR) || QueueALBuffer(job.Source, chunk) != GEM_OK) {
+		alDeleteBuffers(1, &chunk);
+		checkALError("Error deleting buffer", WARNING);
+		return;
+	}
+	job.chunks.push_back(chunk);
+}
+
+// start playing what is decoded so far, the decoder queues the rest
+bool OpenALAudioDriver::AttachJob(SoundJob& job, ALuint source)
+{
+	std::lock_guard<std::mutex> l(job.mutex);
+	if (job.done) {
+		return false;
+	}
+
+	job.Source = source;
+	if (job.decoded) {
+		QueueChunk(job, job.pcm, job.decoded);
+	}
+	return true;
 }
 
 Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, unsigned int channel, const Point& p,
 	unsigned int flags, unsigned int *length)
 {
-	ALuint Buffer;
-	unsigned int time_length;
+	ALuint Buffer = 0;
+	unsigned int time_length = 0;
 
 	if (ResRef == NULL || !ResRef[0]) {
-		if((flags & GEM_SND_SPEECH) && (speech.Source && alIsSource(speech.Source))) {
+		if (flags & GEM_SND_SPEECH) {
 			//So we want him to be quiet...
-			alSourceStop( speech.Source );
-			checkALError("Unable to stop speech", WARNING);
-			speech.ClearProcessedBuffers();
+			speech.ForceClear();
 		}
 		return Holder<SoundHandle>();
 	}
 
-	Buffer = loadSound( ResRef, time_length );
-	if (Buffer == 0) {
+	// a sound not in the cache yet is streamed while it is decoded,
+	// we only need its length to return
+	std::shared_ptr<SoundJob> job = requestSound(ResRef, Buffer, time_length, true);
+	if (job) {
+		if (!job->WaitOpened(time_length)) {
+			return Holder<SoundHandle>();
+		}
+	} else if (Buffer == 0) {
 		return Holder<SoundHandle>();
 	}
 
@@ -482,10 +698,8 @@ Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, unsigned int cha
 			//speech has a single channel, if a new speech started
 			//we stop the previous one
 
-			if(!speech.free && (speech.Source && alIsSource(speech.Source))) {
-				alSourceStop( speech.Source );
-				checkALError("Unable to stop speech", WARNING);
-				speech.ClearProcessedBuffers();
+			if (!speech.free) {
+				speech.ForceClear();
 			}
 		}
 
@@ -512,6 +726,16 @@ Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, unsigned int cha
 	}
 
 	assert(stream);
+
+	// loops and speech queued behind other speech need the whole buffer
+	if (job && (loop || !stream->free)) {
+		Buffer = job->WaitDone();
+		job.reset();
+		if (Buffer == 0) {
+			return Holder<SoundHandle>();
+		}
+	}
+
 	ALuint Source = stream->Source;
 
 	if(!Source || !alIsSource(Source)) {
@@ -546,8 +770,17 @@ Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, unsigned int cha
 	stream->Source = Source;
 	stream->free = false;
 
-	if (QueueALBuffer(Source, Buffer) != GEM_OK) {
-		return Holder<SoundHandle>();
+	if (job && AttachJob(*job, Source)) {
+		stream->job = job;
+	} else {
+		if (job) {
+			// finished decoding in the meantime
+			Buffer = job->Buffer;
+		}
+		if (Buffer == 0 || QueueCachedBuffer(ResRef, Source) != GEM_OK) {
+			stream->ForceClear();
+			return Holder<SoundHandle>();
+		}
 	}
 
 	stream->handle = new OpenALSoundHandle(stream);
@@ -791,7 +1024,7 @@ int OpenALAudioDriver::QueueAmbient(int stream, const char* sound)
 
 	assert(!streams[stream].delete_buffers);
 
-	if (QueueALBuffer(source, Buffer) != GEM_OK) {
+	if (QueueCachedBuffer(sound, source) != GEM_OK) {
 		return GEM_ERROR;
 	}
 
@@ -837,6 +1070,7 @@ bool OpenALAudioDriver::evictBuffer()
 			// Buffer was unused. An error would have indicated
 			// the buffer was still attached to a source.
 
+			cacheBytes -= e->Size;
 			delete e;
 			buffercache.Remove(k);
 
@@ -853,6 +1087,7 @@ void OpenALAudioDriver::clearBufferCache(bool force)
 {
 	// Room for optimization: any method of iterating over the buffers
 	// would suffice. It doesn't have to be in LRU-order.
+	std::lock_guard<std::mutex> l(bufferMutex);
 	void* p;
 	const char* k;
 	int n = 0;
@@ -860,6 +1095,7 @@ void OpenALAudioDriver::clearBufferCache(bool force)
 		CacheEntry* e = (CacheEntry*)p;
 		alDeleteBuffers(1, &e->Buffer);
 		if (force || alGetError() == AL_NO_ERROR) {
+			cacheBytes -= e->Size;
 			delete e;
 			buffercache.Remove(k);
 		} else
@@ -1025,6 +1261,27 @@ void OpenALAudioDriver::QueueBuffer(int stream, unsigned short bits,
 // Private Methods
 // !!!!!!!!!!!!!!!
 
+// the decoder threads may evict a cached buffer at any time until it is
+// attached to a source, so look it up again and queue it under the cache lock
+int OpenALAudioDriver::QueueCachedBuffer(const char* ResRef, ALuint source)
+{
+	for (int tries = 0; tries < 2; ++tries) {
+		{
+			std::lock_guard<std::mutex> l(bufferMutex);
+			void* p;
+			if (buffercache.Lookup(ResRef, p)) {
+				return QueueALBuffer(source, ((const CacheEntry*) p)->Buffer);
+			}
+		}
+		// evicted in the meantime
+		unsigned int time_length;
+		if (loadSound(ResRef, time_length) == 0) {
+			break;
+		}
+	}
+	return GEM_ERROR;
+}
+
 int OpenALAudioDriver::QueueALBuffer(ALuint source, ALuint buffer)
 {
 #ifdef DEBUG_AUDIO
@@ -1033,7 +1290,7 @@ int OpenALAudioDriver::QueueALBuffer(ALuint source, ALuint buffer)
 	alGetBufferi(buffer, AL_BITS, &bits);
 	alGetBufferi(buffer, AL_CHANNELS, &channels);
 	checkALError("Error querying buffer properties.", WARNING);
-	Log(DEBUG, "OpenAL", "Attempting to buffer audio source:%d\nFrequency:%d\nBits:%d\nChannels:%d",
+	LogDebug("OpenAL", "Attempting to buffer audio source:%d\nFrequency:%d\nBits:%d\nChannels:%d",
 		source, frequency, bits, channels);
 #endif
 	ALint type;
@@ -33,8 +33,14 @@
 #include "System/FileStream.h"
 #include "MapReverb.h"
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #if __APPLE__
 #include <OpenAL/OpenAL.h> // umbrella include for all the headers we want
@@ -47,7 +53,9 @@
 #endif
 
 #define RETRY 5
-#define BUFFER_CACHE_SIZE 100
+#define BUFFER_CACHE_BYTES (32 * 1024 * 1024)
+#define DECODER_THREADS 2
+#define DECODE_CHUNK 16384 // samples handed to a playing source at a time
 #define MAX_STREAMS 30
 #define MUSICBUFFERS 10
 #define REFERENCE_DISTANCE 50
@@ -71,6 +79,38 @@ public:
 	void Invalidate() { parent = 0; }
 };
 
+/**
+ * A sound being decoded by one of the decoder threads. Play waits only
+ * until the length is known; while a source is attached every decoded
+ * chunk is queued to it, so the sound starts before decoding finishes.
+ * The complete buffer goes into the cache once done.
+ */
+struct SoundJob {
+	explicit SoundJob(const char* name) : name(name) { }
+	~SoundJob() { free(pcm); }
+
+	std::string name;
+	std::mutex mutex;
+	std::condition_variable cond;
+	bool opened = false;
+	bool failed = false;
+	bool done = false;
+	unsigned int Length = 0;
+	// the cached buffer, 0 if decoding failed
+	ALuint Buffer = 0;
+
+	// decoder side, guarded by mutex once opened
+	short* pcm = nullptr;
+	int decoded = 0;
+	ALenum format = 0;
+	int samplerate = 0;
+	ALuint Source = 0;
+	std::vector<ALuint> chunks;
+
+	bool WaitOpened(unsigned int& length);
+	ALuint WaitDone();
+};
+
 struct AudioStream {
 	AudioStream() : Buffer(0), Source(0), Duration(0), free(true), ambient(false), locked(false), delete_buffers(false) { }
 
@@ -85,13 +125,17 @@ struct AudioStream {
 	void ClearIfStopped();
 	void ClearProcessedBuffers();
 	void ForceClear();
+	void DetachJob();
 
 	Holder<OpenALSoundHandle> handle;
+	// set while the sound is still being decoded into the source
+	std::shared_ptr<SoundJob> job;
 };
 
 struct CacheEntry {
 	ALuint Buffer;
 	unsigned int Length;
+	unsigned int Size;
 };
 
 class OpenALAudioDriver : public Audio {
@@ -123,8 +167,12 @@ public:
 				int channels, short* memory,
 				int size, int samplerate) override;
 	void UpdateMapAmbient(MapReverb&) override;
+	void Preload(const char* ResRef) override;
 private:
 	int QueueALBuffer(ALuint source, ALuint buffer);
+	int QueueCachedBuffer(const char* ResRef, ALuint source);
+	bool AttachJob(SoundJob& job, ALuint source);
+	void QueueChunk(SoundJob& job, const short* samples, int count);
 
 private:
 	ALCcontext *alutContext;
@@ -134,9 +182,14 @@ private:
 	ALuint MusicBuffer[MUSICBUFFERS];
 	Holder<SoundMgr> MusicReader;
 	LRUCache buffercache;
+	// bytes of PCM held by buffercache
+	size_t cacheBytes;
+	std::mutex bufferMutex;
+	std::map<std::string, std::shared_ptr<SoundJob>> pendingSounds;
 	AudioStream speech;
 	AudioStream streams[MAX_STREAMS];
 	ALuint loadSound(const char* ResRef, unsigned int &time_length);
+	std::shared_ptr<SoundJob> requestSound(const char* ResRef, ALuint& Buffer, unsigned int& time_length, bool urgent);
 	int num_streams;
 	int CountAvailableSources(int limit);
 	bool evictBuffer();
@@ -147,6 +200,14 @@ private:
 	short* music_memory;
 	std::thread musicThread;
 
+	std::vector<std::thread> decoderThreads;
+	std::mutex decodeMutex;
+	std::condition_variable decodeCond;
+	std::deque<std::shared_ptr<SoundJob>> decodeQueue;
+	bool decodersAlive;
+	void SoundDecoder();
+	void Decode(SoundJob& job);
+
 	bool InitEFX(void);
 	bool hasReverbProperties;
 
@@ -19,9 +19,16 @@
 #include "SAVImporter.h"
 
 #include "Compressor.h"
-#include "FileCache.h"
 #include "Interface.h"
 #include "PluginMgr.h"
+#include "System/FileStream.h"
+#include "System/MemoryStream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace GemRB;
 
@@ -33,6 +40,45 @@ SAVImporter::~SAVImporter()
 {
 }
 
+// the entries are independent zlib streams, so each worker thread gets its own
+// compressor and takes the next unclaimed entry until none are left
+static unsigned int WorkerCount(size_t jobs)
+{
+	unsigned int threads = std::thread::hardware_concurrency();
+	threads = std::min(std::max(threads, 1u), 8u);
+	return std::min<unsigned int>(threads, jobs);
+}
+
+template <typename F>
+static void RunWorkers(size_t jobs, F&& work)
+{
+	unsigned int count = WorkerCount(jobs);
+	std::vector<PluginHolder<Compressor>> comps;
+	comps.reserve(count);
+	for (unsigned int i = 0; i < count; i++) {
+		// plugin creation is not thread safe, so do it upfront
+		comps.emplace_back(PLUGIN_COMPRESSION_ZLIB);
+	}
+
+	std::vector<std::thread> workers;
+	// the calling thread works too, so it is free to report progress
+	for (unsigned int i = 1; i < count; i++) {
+		workers.emplace_back(work, comps[i].get(), false);
+	}
+	if (count) work(comps[0].get(), true);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+struct SaveEntry {
+	std::string name;
+	char path[_MAX_PATH];
+	ieDword declen = 0;
+	DataStream *data = nullptr;
+	bool ok = false;
+};
+
 int SAVImporter::DecompressSaveGame(DataStream *compressed)
 {
 	char Signature[8];
@@ -41,37 +87,81 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed)
 		return GEM_ERROR;
 	}
 	int All = compressed->Remains();
-	int Current;
-	int percent, last_percent = 20;
 	if (!All) return GEM_ERROR;
+	if (!core->IsAvailable(PLUGIN_COMPRESSION_ZLIB)) {
+		Log(ERROR, "SAVImporter", "No Compression Manager Available. Cannot Load Compressed File.");
+		return GEM_ERROR;
+	}
+
+	// the archive is read sequentially, only the inflating is spread out
+	std::vector<SaveEntry> entries;
+	int ret = GEM_OK;
 	do {
 		ieDword fnlen, complen, declen;
 		compressed->ReadDword( &fnlen );
 		if (!fnlen) {
 			Log(ERROR, "SAVImporter", "Corrupt Save Detected");
-			return GEM_ERROR;
+			ret = GEM_ERROR;
+			break;
 		}
 		char* fname = ( char* ) malloc( fnlen );
 		compressed->Read( fname, fnlen );
+		fname[fnlen - 1] = 0;
 		strlwr(fname);
 		compressed->ReadDword( &declen );
 		compressed->ReadDword( &complen );
-		print("Decompressing %s", fname);
-		DataStream* cached = CacheCompressedStream(compressed, fname, complen, true);
+		void *data = malloc(complen);
+		if (compressed->Read(data, complen) != (int) complen) {
+			Log(ERROR, "SAVImporter", "Truncated entry %s", fname);
+			free(data);
+			free(fname);
+			ret = GEM_ERROR;
+			break;
+		}
+
+		entries.emplace_back();
+		SaveEntry& entry = entries.back();
+		entry.name = fname;
+		entry.declen = declen;
+		entry.data = new MemoryStream(fname, data, complen);
+		char file[_MAX_PATH];
+		ExtractFileFromPath(file, fname);
+		PathJoin(entry.path, core->CachePath, file, nullptr);
 		free( fname );
-		if (!cached)
-			return GEM_ERROR;
-		delete cached;
-		Current = compressed->Remains();
-		//starting at 20% going up to 70%
-		percent = (20 + (All - Current) * 50 / All);
-		if (percent - last_percent > 5) {
-			core->LoadProgress(percent);
-			last_percent = percent;
+	} while (compressed->Remains());
+	core->LoadProgress(30);
+
+	if (ret == GEM_OK) {
+		std::atomic<size_t> next(0), done(0);
+		RunWorkers(entries.size(), [&](const Compressor *comp, bool main) {
+			int last_percent = 30;
+			size_t i;
+			while ((i = next++) < entries.size()) {
+				SaveEntry& entry = entries[i];
+				FileStream out;
+				if (out.Create(entry.path)) {
+					entry.ok = comp->Decompress(&out, entry.data, entry.data->Size()) == GEM_OK;
+				}
+				size_t finished = ++done;
+				if (!main) continue;
+				//starting at 30% going up to 70%
+				int percent = 30 + int(finished * 40 / entries.size());
+				if (percent - last_percent > 5) {
+					core->LoadProgress(percent);
+					last_percent = percent;
+				}
+			}
+		});
+	}
+
+	for (const SaveEntry& entry : entries) {
+		if (ret == GEM_OK && !entry.ok) {
+			Log(ERROR, "SAVImporter", "Cannot decompress %s to %s.", entry.name.c_str(), entry.path);
+			ret = GEM_ERROR;
 		}
+		delete entry.data;
 	}
-	while(Current);
-	return GEM_OK;
+	return ret;
 }
 
 //this one can create .sav files only
@@ -88,31 +178,58 @@ int SAVImporter::CreateArchive(DataStream *compressed)
 	return GEM_OK;
 }
 
-int SAVImporter::AddToSaveGame(DataStream *str, DataStream *uncompressed)
+static void WriteEntry(DataStream *str, const SaveEntry& entry)
 {
-	ieDword fnlen, declen, complen;
-
-	fnlen = strlen(uncompressed->filename)+1;
-	declen = uncompressed->Size();
-	str->WriteDword( &fnlen);
-	str->Write( uncompressed->filename, fnlen);
-	str->WriteDword( &declen);
-	//baaah, we dump output right in the stream, we get the compressed length
-	//only after the compressed data was written
-	complen = 0xcdcdcdcd; //placeholder
-	unsigned long Pos = str->GetPos(); //storing the stream position
-	str->WriteDword( &complen);
-
-	PluginHolder<Compressor> comp(PLUGIN_COMPRESSION_ZLIB);
-	comp->Compress( str, uncompressed );
-
-	//writing compressed length (calculated)
-	unsigned long Pos2 = str->GetPos();
-	complen = Pos2-Pos-sizeof(ieDword); //calculating the compressed stream size
-	str->Seek(Pos, GEM_STREAM_START); //going back to the placeholder
-	str->WriteDword( &complen);       //updating size
-	str->Seek(Pos2, GEM_STREAM_START);//resuming work
-	return GEM_OK;
+	ieDword fnlen = entry.name.length() + 1;
+	ieDword declen = entry.declen;
+	ieDword complen = entry.data->Size();
+	str->WriteDword(&fnlen);
+	str->Write(entry.name.c_str(), fnlen);
+	str->WriteDword(&declen);
+	str->WriteDword(&complen);
+
+	char buffer[8192];
+	entry.data->Seek(0, GEM_STREAM_START);
+	while (complen) {
+		unsigned int chunk = std::min<unsigned int>(complen, sizeof(buffer));
+		entry.data->Read(buffer, chunk);
+		str->Write(buffer, chunk);
+		complen -= chunk;
+	}
+}
+
+int SAVImporter::AddToSaveGame(DataStream *str, const std::vector<std::string>& files, int level)
+{
+	std::vector<SaveEntry> entries(files.size());
+	std::atomic<size_t> next(0);
+	RunWorkers(files.size(), [&](const Compressor *comp, bool) {
+		size_t i;
+		while ((i = next++) < files.size()) {
+			SaveEntry& entry = entries[i];
+			FileStream fs;
+			if (!fs.Open(files[i].c_str())) {
+				continue;
+			}
+			entry.name = fs.filename;
+			entry.declen = fs.Size();
+			entry.data = new MemoryStream(fs.filename, nullptr, 0);
+			entry.ok = comp->Compress(entry.data, &fs, level) == GEM_OK;
+		}
+	});
+
+	// the entries are written in the original order, the format is unchanged
+	int ret = GEM_OK;
+	for (size_t i = 0; i < entries.size(); i++) {
+		const SaveEntry& entry = entries[i];
+		if (entry.ok) {
+			WriteEntry(str, entry);
+		} else {
+			Log(ERROR, "SAVImporter", "Failed to compress \"%s\".", files[i].c_str());
+			ret = GEM_ERROR;
+		}
+		delete entry.data;
+	}
+	return ret;
 }
 
 #include "plugindef.h"
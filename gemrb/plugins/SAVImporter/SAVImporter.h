@@ -34,7 +34,7 @@ public:
 	SAVImporter(void);
 	~SAVImporter(void) override;
 	int DecompressSaveGame(DataStream *compressed) override;
-	int AddToSaveGame(DataStream *str, DataStream *uncompressed) override;
+	int AddToSaveGame(DataStream *str, const std::vector<std::string>& files, int level) override;
 	int CreateArchive(DataStream *compressed) override;
 };
 
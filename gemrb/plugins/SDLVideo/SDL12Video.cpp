@@ -26,6 +26,8 @@
 #include "SDLSurfaceSprite2D.h"
 #include "SDL12GamepadMappings.h"
 
+#include <type_traits>
+
 #include "SDLSpriteRendererRLE.h"
 
 using namespace GemRB;
@@ -127,13 +129,7 @@ VideoBuffer* SDL12VideoDriver::NewVideoBuffer(const Region& r, BufferFormat fmt)
 
 IAlphaIterator* SDL12VideoDriver::StencilIterator(BlitFlags flags, SDL_Rect maskclip) const
 {
-	struct SurfaceAlphaIterator : RGBAChannelIterator {
-		SDLPixelIterator pixit;
-		
-		SurfaceAlphaIterator(SDL_Surface* surface, const SDL_Rect& clip, Uint32 mask, Uint8 shift,
-							 IPixelIterator::Direction x, IPixelIterator::Direction y)
-		: RGBAChannelIterator(&pixit, mask, shift), pixit(surface, x, y, clip) {}
-	} *maskit = nullptr;
+	SDLSurfaceAlphaIterator* maskit = nullptr;
 
 	if (flags&BLIT_STENCIL_MASK) {
 		SDL_Surface* maskSurf = CurrentStencilBuffer();
@@ -160,7 +156,7 @@ IAlphaIterator* SDL12VideoDriver::StencilIterator(BlitFlags flags, SDL_Rect mask
 		maskclip.y -= stencilOrigin.y;
 		IPixelIterator::Direction xdir = (flags&BlitFlags::MIRRORX) ? IPixelIterator::Reverse : IPixelIterator::Forward;
 		IPixelIterator::Direction ydir = (flags&BlitFlags::MIRRORY) ? IPixelIterator::Reverse : IPixelIterator::Forward;
-		maskit = new SurfaceAlphaIterator(maskSurf, maskclip, mask, shift, xdir, ydir);
+		maskit = new SDLSurfaceAlphaIterator(maskSurf, maskclip, mask, shift, xdir, ydir);
 	}
 	
 	return maskit;
@@ -358,6 +354,21 @@ void SDL12VideoDriver::BlitSpriteNativeClipped(SDL_Surface* surf, const SDL_Rect
 			BlendFn = ShaderTint;
 		}
 
+		if (maskIt == nullptr && BlendFn == ShaderBlend<true>) {
+			// the common case has row kernels, with the same setup as the pipelines below
+			BlitShade shade;
+			if (flags & (BlitFlags::COLOR_MOD | BlitFlags::ALPHA_MOD)) {
+				shade = BlitShade(SHADER::TINT, tint, 8);
+			}
+			if (flags & (BlitFlags::GREY | BlitFlags::SEPIA)) {
+				shade.shade = (flags & BlitFlags::GREY) ? SHADER::GREYSCALE : SHADER::SEPIA;
+				shade.shift += 2;
+			}
+			if (BlitShadedRect32(surf, currentBuf, srect, drect, shade, flags)) {
+				return;
+			}
+		}
+
 		if (flags & (BlitFlags::COLOR_MOD | BlitFlags::ALPHA_MOD)) {
 			if (flags&BlitFlags::GREY) {
 				RGBBlendingPipeline<SHADER::GREYSCALE, true> blender(tint, BlendFn);
@@ -475,9 +486,12 @@ void SDL12VideoDriver::DrawRectImp(const Region& rgn, const Color& color, bool f
 		if (flags&BlitFlags::BLENDED && color.a < 0xff) {
 			assert(rgn.w > 0 && rgn.h > 0);
 			
-			const static OneMinusSrcA<false, false> blender;
-			
 			Region clippedrgn = ClippedDrawingRect(rgn);
+			if (FillBlendedRect32(currentBuf, RectFromRegion(clippedrgn), color)) {
+				return;
+			}
+
+			const static OneMinusSrcA<false, false> blender;
 			SDLPixelIterator dstit(currentBuf, RectFromRegion(clippedrgn));
 			SDLPixelIterator dstend = SDLPixelIterator::end(dstit);
 			ColorFill(color, dstit, dstend, blender);
@@ -26,6 +26,8 @@
 
 #include "Interface.h"
 
+#include <algorithm>
+
 using namespace GemRB;
 
 SDL20VideoDriver::SDL20VideoDriver(void)
@@ -48,6 +50,8 @@ SDL20VideoDriver::SDL20VideoDriver(void)
 
 SDL20VideoDriver::~SDL20VideoDriver(void)
 {
+	FlushStencilBatch();
+
 	if (SDL_GameControllerGetAttached(gameController)) {
 		SDL_GameControllerClose(gameController);
 	}
@@ -57,6 +61,7 @@ SDL20VideoDriver::~SDL20VideoDriver(void)
 	scratchBuffer = nullptr;
 	DestroyBuffers();
 	
+	delete atlas;
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 
@@ -141,12 +146,13 @@ int SDL20VideoDriver::CreateSDLDisplay(const char* title)
 	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_TARGETTEXTURE | SDL_RENDERER_ACCELERATED);
 	SDL_RendererInfo info;
 	SDL_GetRendererInfo(renderer, &info);
-	Log(DEBUG, "SDL20Video", "Renderer: %s", info.name);
+	LogDebug("SDL20Video", "Renderer: %s", info.name);
 
 	if (renderer == NULL) {
 		Log(ERROR, "SDL 2 Driver", "couldnt create renderer:%s", SDL_GetError());
 		return GEM_ERROR;
 	}
+	atlas = new SDLTextureAtlas(renderer);
 
 #if USE_OPENGL_BACKEND
 	Log(MESSAGE, "SDL 2 GL Driver", "OpenGL version: %s, renderer: %s, vendor: %s", glGetString(GL_VERSION), glGetString(GL_RENDERER), glGetString(GL_VENDOR));
@@ -201,13 +207,15 @@ VideoBuffer* SDL20VideoDriver::NewVideoBuffer(const Region& r, BufferFormat fmt)
 		Log(ERROR, "SDL 2", "%s", SDL_GetError());
 		return nullptr;
 	}
-	return new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer);
+	return new SDLTextureVideoBuffer(r.origin, tex, fmt, this, renderer);
 }
 
 void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 {
-	SDL_SetRenderTarget(renderer, NULL);
+	FlushStencilBatch();
+	SetRenderTarget(renderer, NULL);
 	SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderClear(renderer);
 
 	VideoBuffers::iterator it;
@@ -243,6 +251,7 @@ void SDL20VideoDriver::BeginCustomRendering()
 	// To start we need to make sure SDL thinks it is using its texture shader
 	// so that we can change the program without it knowing
 	static const SDL_Rect r = {0, 0, 1, 1};
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderCopy(renderer, ScratchBuffer(), &r, &r);
 	// if we ever call more than glUseProgram (and associates) then we will need to do more here
 	// we may want to add a 'flags' parameter to conditionally clear the other states
@@ -255,6 +264,7 @@ void SDL20VideoDriver::EndCustomRendering()
 {
 	// to end we need SDL to "reset" the render state to restore the textrue shader
 	// we do this by changing the state to the primitive "solid" shader
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderDrawPoint(renderer, -1, -1);
 	// if we ever call more than glUseProgram (and associates) then we will need to do more here
 	// we may want to add a 'flags' parameter to conditionally clear the other states
@@ -267,23 +277,36 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 {
 	// TODO: add support for BlitFlags::HALFTRANS, BlitFlags::COLOR_MOD, and others (no use for them ATM)
 
+	// whatever comes next has to be drawn over the pending stencilled sprites
+	FlushStencilBatch();
+
 	SDL_Texture* target = CurrentRenderBuffer();
 
 	assert(target);
-	int ret = SDL_SetRenderTarget(renderer, target);
+	int ret = SetRenderTarget(renderer, target);
 	if (ret != 0) {
 		Log(ERROR, "SDLVideo", "%s", SDL_GetError());
 		return ret;
 	}
 
+	const SDL_Rect* clip = reinterpret_cast<const SDL_Rect*>(&screenClip);
 	if (screenClip.size == screenSize)
 	{
 		// Some SDL backends complain on having a clip rect of the entire renderer size
 		// I'm not sure if it is an SDL bug; possibly its just 0 based so it is out of bounds?
-		SDL_RenderSetClipRect(renderer, NULL);
-	} else {
-		SDL_RenderSetClipRect(renderer, reinterpret_cast<SDL_Rect*>(&screenClip));
+		clip = nullptr;
 	}
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+	// every change queues a state command in the renderer
+	SDL_Rect current;
+	SDL_RenderGetClipRect(renderer, &current);
+	bool clipped = SDL_RenderIsClipEnabled(renderer);
+	if (clipped != (clip != nullptr) || (clip && !SDL_RectEquals(clip, &current))) {
+		SDL_RenderSetClipRect(renderer, clip);
+	}
+#else
+	SDL_RenderSetClipRect(renderer, clip);
+#endif
 
 	if (color) {
 		if (flags & BlitFlags::BLENDED) {
@@ -316,78 +339,183 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, co
 	}
 
 	SDL_Texture* tex = spr->GetTexture(renderer);
-	BlitSpriteNativeClipped(tex, src, dst, flags, tint);
+	const SDL_Rect* slot = spr->AtlasRect();
+	if (!slot) {
+		BlitSpriteNativeClipped(tex, src, dst, flags, tint);
+		return;
+	}
+
+	// SDL only clips against the texture, which is now shared with the neighbours
+	SDL_Rect srect = src;
+	SDL_Rect drect = dst;
+	int left = std::max(0, -srect.x);
+	int right = std::max(0, srect.x + srect.w - slot->w);
+	int top = std::max(0, -srect.y);
+	int bottom = std::max(0, srect.y + srect.h - slot->h);
+	if (left + right >= srect.w || top + bottom >= srect.h) {
+		return;
+	}
+	if (left || right || top || bottom) {
+		srect.x += left;
+		srect.y += top;
+		srect.w -= left + right;
+		srect.h -= top + bottom;
+		drect.x += (flags & BlitFlags::MIRRORX) ? right : left;
+		drect.y += (flags & BlitFlags::MIRRORY) ? bottom : top;
+		drect.w = srect.w;
+		drect.h = srect.h;
+	}
+	srect.x += slot->x;
+	srect.y += slot->y;
+	BlitSpriteNativeClipped(tex, srect, drect, flags, tint);
+}
+
+void SDL20VideoDriver::PackSprites(const std::vector<Holder<Sprite2D>>& sprites)
+{
+	std::vector<SDLTextureSprite2D*> packable;
+	for (const Holder<Sprite2D>& spr : sprites) {
+		if (!spr || spr->BAM) continue;
+		if (spr->Frame.w <= 0 || spr->Frame.h <= 0) continue;
+		if (spr->Frame.w > SDLTextureAtlas::MAX_SPRITE_SIZE || spr->Frame.h > SDLTextureAtlas::MAX_SPRITE_SIZE) continue;
+
+		SDLTextureSprite2D* native = static_cast<SDLTextureSprite2D*>(spr.get());
+		// shared between animations
+		if (native->AtlasRect()) continue;
+		packable.push_back(native);
+	}
+	// tiles can share frames
+	std::sort(packable.begin(), packable.end());
+	packable.erase(std::unique(packable.begin(), packable.end()), packable.end());
+	if (atlas && !packable.empty()) {
+		atlas->Pack(packable);
+	}
 }
 
 void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const SDL_Rect& srect, const SDL_Rect& drect, BlitFlags flags, const SDL_Color* tint)
 {
-	int ret = 0;
 	if (flags&BLIT_STENCIL_MASK) {
-		// 1. clear scratchpad segment
-		// 2. blend stencil segment to scratchpad
-		// 3. blend texture to scratchpad
-		// 4. copy scratchpad segment to screen
+		QueueStencilBlit(texSprite, srect, drect, flags, tint);
+		return;
+	}
 
-		SDL_Texture* stencilTex = CurrentStencilBuffer();
-		SDL_SetTextureBlendMode(stencilTex, stencilAlphaBlender);
+	UpdateRenderTarget();
+	int ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
+	if (ret != 0) {
+		Log(ERROR, "SDLVideo", "%s", SDL_GetError());
+	}
+}
 
-		std::static_pointer_cast<SDLTextureVideoBuffer>(scratchBuffer)->Clear(drect); // sets the render target to the scratch buffer
+void SDL20VideoDriver::QueueStencilBlit(SDL_Texture* texSprite, const SDL_Rect& srect, const SDL_Rect& drect, BlitFlags flags, const SDL_Color* tint)
+{
+	// 1. clear scratchpad segment
+	// 2. blend texture to scratchpad
+	// then in FlushStencilBatch, once for all the queued segments:
+	// 3. blend stencil segments to scratchpad
+	// 4. copy scratchpad segments to screen
 
-		RenderCopyShaded(texSprite, &srect, &drect, flags & ~(BlitFlags::ALPHA_MOD|BlitFlags::HALFTRANS), tint);
-		
-		SDL_Rect stencilRect = drect;
-		stencilRect.x -= stencilBuffer->Origin().x;
-		stencilRect.y -= stencilBuffer->Origin().y;
+	Uint8 alpha = SDL_ALPHA_OPAQUE;
+	if (flags & BlitFlags::ALPHA_MOD) {
+		alpha = tint->a;
+	}
+	if (flags & BlitFlags::HALFTRANS) {
+		alpha /= 2;
+	}
 
-#if USE_OPENGL_BACKEND
-		BeginCustomRendering();
-		GLint channel = 3;
-		if (flags&BlitFlags::STENCIL_RED) {
-			channel = 0;
-		} else if (flags&BlitFlags::STENCIL_GREEN) {
-			channel = 1;
-		} else if (flags&BlitFlags::STENCIL_BLUE) {
-			channel = 2;
-		}
+	SDL_Texture* target = CurrentRenderBuffer();
+	SDL_Texture* stencilTex = CurrentStencilBuffer();
+	BlitFlags stencilFlags = flags & BLIT_STENCIL_MASK;
+	StencilBatch& batch = stencilBatch;
+
+	bool compatible = batch.target == target && batch.stencil == stencilTex
+		&& batch.flags == stencilFlags && batch.alpha == alpha;
+	// overlapping segments would clear each other and get the stencil twice
+	for (const SDL_Rect& rect : batch.rects) {
+		if (!compatible) break;
+		compatible = !SDL_HasIntersection(&rect, &drect);
+	}
+	if (!compatible) {
+		FlushStencilBatch();
+	}
+
+	batch.target = target;
+	batch.stencil = stencilTex;
+	batch.flags = stencilFlags;
+	batch.alpha = alpha;
+
+	// not the buffer's Clear, that would flush what we are building
+	SetRenderTarget(renderer, ScratchBuffer());
+	SDL_RenderSetClipRect(renderer, NULL);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
+	SDL_RenderFillRect(renderer, &drect);
+
+	int ret = RenderCopyShaded(texSprite, &srect, &drect, flags & ~(BlitFlags::ALPHA_MOD|BlitFlags::HALFTRANS), tint);
+	if (ret != 0) {
+		Log(ERROR, "SDLVideo", "%s", SDL_GetError());
+	}
 
-		stencilShader->Use();
-		stencilShader->SetUniformValue("u_channel", 1, channel);
-		if (flags & BlitFlags::STENCIL_DITHER) {
-			stencilShader->SetUniformValue("u_dither", 1, 1);
-		} else {
-			stencilShader->SetUniformValue("u_dither", 1, 0);
-		}
-		
-		stencilShader->SetUniformValue("s_stencil", 1, 0);
+	// the stencil origin may move before the batch is flushed
+	SDL_Rect stencilRect = drect;
+	stencilRect.x -= stencilBuffer->Origin().x;
+	stencilRect.y -= stencilBuffer->Origin().y;
+	batch.rects.push_back(drect);
+	batch.stencilRects.push_back(stencilRect);
+}
 
-		SDL_RenderCopy(renderer, stencilTex, &stencilRect, &drect);
-		EndCustomRendering();
-#else
-		// alpha masking only
-		SDL_RenderCopy(renderer, stencilTex, &stencilRect, &drect);
-#endif
-		if (flags & (BlitFlags::ALPHA_MOD | BlitFlags::HALFTRANS)) {
-			Uint8 alpha = SDL_ALPHA_OPAQUE;
-			if (flags & BlitFlags::ALPHA_MOD) {
-				alpha = tint->a;
-			}
-			
-			if (flags & BlitFlags::HALFTRANS) {
-				alpha /= 2;
-			}
-			SDL_SetTextureAlphaMod(ScratchBuffer(), alpha);
-		}
-		SDL_SetRenderTarget(renderer, CurrentRenderBuffer());
-		SDL_SetTextureBlendMode(ScratchBuffer(), SDL_BLENDMODE_BLEND);
-		ret = SDL_RenderCopy(renderer, ScratchBuffer(), &drect, &drect);
+void SDL20VideoDriver::FlushStencilBatch()
+{
+	StencilBatch& batch = stencilBatch;
+	if (batch.rects.empty()) return;
+
+	SDL_Texture* scratch = ScratchBuffer();
+	SetRenderTarget(renderer, scratch);
+	SDL_SetTextureBlendMode(batch.stencil, stencilAlphaBlender);
+
+#if USE_OPENGL_BACKEND
+	BeginCustomRendering();
+	GLint channel = 3;
+	if (batch.flags & BlitFlags::STENCIL_RED) {
+		channel = 0;
+	} else if (batch.flags & BlitFlags::STENCIL_GREEN) {
+		channel = 1;
+	} else if (batch.flags & BlitFlags::STENCIL_BLUE) {
+		channel = 2;
+	}
+
+	stencilShader->Use();
+	stencilShader->SetUniformValue("u_channel", 1, channel);
+	if (batch.flags & BlitFlags::STENCIL_DITHER) {
+		stencilShader->SetUniformValue("u_dither", 1, 1);
 	} else {
-		UpdateRenderTarget();
-		ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
+		stencilShader->SetUniformValue("u_dither", 1, 0);
 	}
 
-	if (ret != 0) {
-		Log(ERROR, "SDLVideo", "%s", SDL_GetError());
+	stencilShader->SetUniformValue("s_stencil", 1, 0);
+#endif
+	// alpha masking only without the shader
+	for (size_t i = 0; i < batch.rects.size(); ++i) {
+		FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
+		SDL_RenderCopy(renderer, batch.stencil, &batch.stencilRects[i], &batch.rects[i]);
 	}
+#if USE_OPENGL_BACKEND
+	EndCustomRendering();
+#endif
+
+	SDL_SetTextureAlphaMod(scratch, batch.alpha);
+	SDL_SetTextureBlendMode(scratch, SDL_BLENDMODE_BLEND);
+	SetRenderTarget(renderer, batch.target);
+	// the segments were already clipped
+	SDL_RenderSetClipRect(renderer, NULL);
+	for (const SDL_Rect& rect : batch.rects) {
+		FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
+		if (SDL_RenderCopy(renderer, scratch, &rect, &rect) != 0) {
+			Log(ERROR, "SDLVideo", "%s", SDL_GetError());
+		}
+	}
+
+	batch.rects.clear();
+	batch.stencilRects.clear();
 }
 
 void SDL20VideoDriver::BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p, BlitFlags flags, const Color* tint)
@@ -450,6 +578,7 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 	SDL_RendererFlip flipflags = (flags&BlitFlags::MIRRORY) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
 	flipflags = static_cast<SDL_RendererFlip>(flipflags | ((flags&BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
 
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	int ret = SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, NULL, flipflags);
 #if USE_OPENGL_BACKEND
 	EndCustomRendering();
@@ -468,12 +597,14 @@ void SDL20VideoDriver::DrawSDLPoints(const std::vector<SDL_Point>& points, const
 		return;
 	}
 	UpdateRenderTarget(reinterpret_cast<const Color*>(&color), flags);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderDrawPoints(renderer, &points[0], int(points.size()));
 }
 
 void SDL20VideoDriver::DrawPointImp(const Point& p, const Color& color, BlitFlags flags)
 {
 	UpdateRenderTarget(&color, flags);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderDrawPoint(renderer, p.x, p.y);
 }
 
@@ -485,18 +616,21 @@ void SDL20VideoDriver::DrawLinesImp(const std::vector<Point>& points, const Colo
 void SDL20VideoDriver::DrawSDLLines(const std::vector<SDL_Point>& points, const SDL_Color& color, BlitFlags flags)
 {
 	UpdateRenderTarget(reinterpret_cast<const Color*>(&color), flags);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderDrawLines(renderer, &points[0], int(points.size()));
 }
 
 void SDL20VideoDriver::DrawLineImp(const Point& p1, const Point& p2, const Color& color, BlitFlags flags)
 {
 	UpdateRenderTarget(&color, flags);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	SDL_RenderDrawLine(renderer, p1.x, p1.y, p2.x, p2.y);
 }
 
 void SDL20VideoDriver::DrawRectImp(const Region& rgn, const Color& color, bool fill, BlitFlags flags)
 {
 	UpdateRenderTarget(&color, flags);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 	if (fill) {
 		SDL_RenderFillRect(renderer, reinterpret_cast<const SDL_Rect*>(&rgn));
 	} else {
@@ -517,6 +651,7 @@ void SDL20VideoDriver::DrawPolygonImp(const Gem_Polygon* poly, const Point& orig
 				// the reconnection of the last to first point (done by SDL) will be visible
 				Point p1(segment.first + origin);
 				Point p2(segment.second + origin);
+				FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 				SDL_RenderDrawLine(renderer, p1.x, p1.y, p2.x, p2.y);
 			}
 		}
@@ -546,6 +681,8 @@ Holder<Sprite2D> SDL20VideoDriver::GetScreenshot(Region r, const VideoBufferPtr&
 	SDLTextureSprite2D* screenshot = new SDLTextureSprite2D(Region(0,0, Width, Height), 24,
 															0x00ff0000, 0x0000ff00, 0x000000ff, 0);
 
+	FlushStencilBatch();
+
 	SDL_Texture* target = SDL_GetRenderTarget(renderer);
 	if (buf) {
 		auto texture = static_cast<SDLTextureVideoBuffer*>(drawingBuffer)->GetTexture();
@@ -24,6 +24,8 @@
 #include "SDLVideo.h"
 #include "SDLSurfaceSprite2D.h"
 
+#include "FrameProfiler.h"
+
 #if USE_OPENGL_BACKEND
 #include "GLSLProgram.h"
 #else
@@ -63,9 +65,21 @@ Uint32 SDLPixelFormatFromBufferFormat(Video::BufferFormat fmt, SDL_Renderer* ren
 	}
 }
 
+// switching targets makes SDL flush its own command batch, so skip redundant switches
+static inline int SetRenderTarget(SDL_Renderer* renderer, SDL_Texture* target)
+{
+	if (SDL_GetRenderTarget(renderer) == target) return 0;
+	FrameProfiler::Count(FrameProfiler::COUNT_TARGETSWITCHES);
+	return SDL_SetRenderTarget(renderer, target);
+}
+
+class SDL20VideoDriver;
+
 class SDLTextureVideoBuffer : public VideoBuffer {
 	SDL_Texture* texture;
 	SDL_Renderer* renderer;
+	// its stencil batch may still read or write our texture
+	SDL20VideoDriver* driver;
 
 	 // the format of the pixel data the client thinks we use, we may have to convert in CopyPixels()
 	Uint32 inputFormat; // the SDL pixel format equivalent of the requested Video::BufferFormat
@@ -84,8 +98,8 @@ private:
 	}
 
 public:
-	SDLTextureVideoBuffer(const Point& p, SDL_Texture* texture, Video::BufferFormat fmt, SDL_Renderer* renderer)
-	: VideoBuffer(TextureRegion(texture, p)), texture(texture), renderer(renderer), inputFormat(SDLPixelFormatFromBufferFormat(fmt, NULL))
+	SDLTextureVideoBuffer(const Point& p, SDL_Texture* texture, Video::BufferFormat fmt, SDL20VideoDriver* driver, SDL_Renderer* renderer)
+	: VideoBuffer(TextureRegion(texture, p)), texture(texture), renderer(renderer), driver(driver), inputFormat(SDLPixelFormatFromBufferFormat(fmt, NULL))
 	{
 		assert(texture);
 		assert(renderer);
@@ -100,32 +114,11 @@ public:
 		Clear();
 	}
 
-	~SDLTextureVideoBuffer() override {
-		SDL_DestroyTexture(texture);
-		SDL_FreeSurface(conversionBuffer);
-	}
+	~SDLTextureVideoBuffer() override;
+
+	void Clear() override;
+	void Clear(const SDL_Rect& rgn);
 
-	void Clear() override {
-		SDL_SetRenderTarget(renderer, texture);
-		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
-#if SDL_COMPILEDVERSION == SDL_VERSIONNUM(2, 0, 10)
-		/**
-		 * See GH issue #410. In some SDL2 backends of this version, a clear
-		 * runs over an outdated state of the clipping settings. This can
-		 * be overcome by a harmless draw command right before.
-		 */
-		SDL_RenderDrawPoint(renderer, 0, 0);
-#endif
-		SDL_RenderClear(renderer);
-	}
-	
-	void Clear(const SDL_Rect& rgn) {
-		SDL_SetRenderTarget(renderer, texture);
-		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
-		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
-		SDL_RenderFillRect(renderer, &rgn);
-	}
-	
 	void Clear(const Region& rgn) override {
 		return Clear(RectFromRegion(rgn));
 	}
@@ -134,6 +127,7 @@ public:
 		SDL_Renderer* renderer = static_cast<SDL_Renderer*>(display);
 		SDL_Rect dst = RectFromRegion(rect);
 		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
 		int ret = SDL_RenderCopy(renderer, texture, NULL, &dst);
 		if (ret != 0) {
 			Log(ERROR, "SDLVideo", "%s", SDL_GetError());
@@ -221,6 +215,20 @@ private:
 	
 	SDL_GameController* gameController = nullptr;
 
+	SDLTextureAtlas* atlas = nullptr;
+
+	// consecutive stencilled blits, eg. the actors behind one wall group, are
+	// drawn to the scratch buffer together; the stencil and the copy back to
+	// the target then happen once for the whole batch
+	struct StencilBatch {
+		SDL_Texture* target = nullptr;
+		SDL_Texture* stencil = nullptr;
+		BlitFlags flags = BlitFlags::NONE;
+		Uint8 alpha = SDL_ALPHA_OPAQUE;
+		std::vector<SDL_Rect> rects;
+		std::vector<SDL_Rect> stencilRects;
+	} stencilBatch;
+
 public:
 	SDL20VideoDriver(void);
 	~SDL20VideoDriver(void) override;
@@ -244,6 +252,13 @@ public:
 	void BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p, BlitFlags flags,
 						 const Color* tint = nullptr) override;
 
+	/** Composes the pending stencilled blits, must happen before anything
+	 * else touches their target, stencil or the scratch buffer */
+	void FlushStencilBatch();
+
+	void PackSprites(const std::vector<Holder<Sprite2D>>& sprites) override;
+	bool SupportsBlendedBuffers() override { return true; }
+
 private:
 	VideoBuffer* NewVideoBuffer(const Region&, BufferFormat) override;
 
@@ -278,12 +293,50 @@ private:
 	void BlitSpriteNativeClipped(const sprite_t* spr, const SDL_Rect& src, const SDL_Rect& dst,
 								 BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL) override;
 	void BlitSpriteNativeClipped(SDL_Texture* spr, const SDL_Rect& src, const SDL_Rect& dst, BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL);
+	void QueueStencilBlit(SDL_Texture* spr, const SDL_Rect& src, const SDL_Rect& dst, BlitFlags flags, const SDL_Color* tint);
 
 	int RenderCopyShaded(SDL_Texture*, const SDL_Rect* srcrect, const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* = NULL);
 
 	int GetTouchFingers(TouchEvent::Finger(&fingers)[FINGER_MAX], SDL_TouchID device) const;
 };
 
+inline SDLTextureVideoBuffer::~SDLTextureVideoBuffer()
+{
+	driver->FlushStencilBatch();
+	SDL_DestroyTexture(texture);
+	SDL_FreeSurface(conversionBuffer);
+}
+
+inline void SDLTextureVideoBuffer::Clear()
+{
+	driver->FlushStencilBatch();
+	SetRenderTarget(renderer, texture);
+	// the target may not have changed, so neither was the clip rect reset
+	SDL_RenderSetClipRect(renderer, NULL);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+#if SDL_COMPILEDVERSION == SDL_VERSIONNUM(2, 0, 10)
+	/**
+	 * See GH issue #410. In some SDL2 backends of this version, a clear
+	 * runs over an outdated state of the clipping settings. This can
+	 * be overcome by a harmless draw command right before.
+	 */
+	SDL_RenderDrawPoint(renderer, 0, 0);
+#endif
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
+	SDL_RenderClear(renderer);
+}
+
+inline void SDLTextureVideoBuffer::Clear(const SDL_Rect& rgn)
+{
+	driver->FlushStencilBatch();
+	SetRenderTarget(renderer, texture);
+	SDL_RenderSetClipRect(renderer, NULL);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	FrameProfiler::Count(FrameProfiler::COUNT_RENDERCALLS);
+	SDL_RenderFillRect(renderer, &rgn);
+}
+
 }
 
 #endif
@@ -0,0 +1,518 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLBlitKernels.h"
+
+#include "System/Logging.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2_BLITTERS
+#include <emmintrin.h>
+#include "SDLBlitKernelsX86.h"
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define USE_NEON_BLITTERS
+#include <arm_neon.h>
+#endif
+
+namespace GemRB {
+
+// macro for a fast approximation for division by 255, same as in ShaderBlend
+#define DIV255(x) (((x) + 1 + ((x) >> 8)) >> 8)
+
+static inline unsigned int Channel(Uint32 px, Uint8 idx)
+{
+	return (px >> (idx * 8)) & 0xff;
+}
+
+static void ShadeRowScalar(Uint32* px, int n, const BlitShade& shade, const BlitFormat& fmt)
+{
+	for (int i = 0; i < n; ++i) {
+		Uint32 p = px[i];
+		Uint8 r = (shade.tint.r * Channel(p, fmt.r)) >> shade.shift;
+		Uint8 g = (shade.tint.g * Channel(p, fmt.g)) >> shade.shift;
+		Uint8 b = (shade.tint.b * Channel(p, fmt.b)) >> shade.shift;
+		if (shade.shade == SHADER::GREYSCALE) {
+			Uint8 avg = r + g + b;
+			r = g = b = avg;
+		} else if (shade.shade == SHADER::SEPIA) {
+			Uint8 avg = r + g + b;
+			r = avg + 21;
+			g = avg;
+			b = avg < 32 ? 0 : avg - 32;
+		}
+		px[i] = fmt.Pack(Color(r, g, b, 0)) | (p & fmt.keep);
+	}
+}
+
+static void BlendRowScalar(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt)
+{
+	for (int i = 0; i < n; ++i) {
+		Uint32 s = src[i];
+		Uint32 d = dst[i];
+		unsigned int a = Channel(s, fmt.a);
+		unsigned int inv = 255 - a;
+
+		Color c;
+		c.r = DIV255(a * Channel(s, fmt.r)) + DIV255(inv * Channel(d, fmt.r));
+		c.g = DIV255(a * Channel(s, fmt.g)) + DIV255(inv * Channel(d, fmt.g));
+		c.b = DIV255(a * Channel(s, fmt.b)) + DIV255(inv * Channel(d, fmt.b));
+		c.a = a + DIV255(inv * Channel(d, fmt.a));
+		dst[i] = (fmt.Pack(c) & (fmt.rgbmask | fmt.amask)) | (d & fmt.keep);
+	}
+}
+
+static void AlphaRowScalar(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt)
+{
+	for (int i = 0; i < n; ++i) {
+		Uint32 s = src[i];
+		Uint32 d = dst[i];
+		unsigned int a = Channel(s, fmt.a);
+		unsigned int inv = 255 - a;
+
+		unsigned int dr = 1 + a * Channel(s, fmt.r) + inv * Channel(d, fmt.r);
+		unsigned int dg = 1 + a * Channel(s, fmt.g) + inv * Channel(d, fmt.g);
+		unsigned int db = 1 + a * Channel(s, fmt.b) + inv * Channel(d, fmt.b);
+		Color c((dr + (dr >> 8)) >> 8, (dg + (dg >> 8)) >> 8, (db + (db >> 8)) >> 8, 0);
+		dst[i] = fmt.Pack(c) | fmt.amask;
+	}
+}
+
+static void HalfTransRowScalar(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt)
+{
+	const Uint32 halfmask = fmt.rgbmask & 0x7f7f7f7f;
+	for (int i = 0; i < n; ++i) {
+		dst[i] = (((dst[i] >> 1) & halfmask) + ((src[i] >> 1) & halfmask)) | fmt.amask;
+	}
+}
+
+const BlitKernels ScalarBlitKernels = {
+	"scalar", ShadeRowScalar, BlendRowScalar, AlphaRowScalar, HalfTransRowScalar
+};
+
+#ifdef USE_SSE2_BLITTERS
+struct SSE2Ops {
+	typedef __m128i V;
+	static const int N = 4; // pixels per register
+
+	static V Load(const Uint32* p) { return _mm_loadu_si128(reinterpret_cast<const V*>(p)); }
+	static void Store(Uint32* p, V v) { _mm_storeu_si128(reinterpret_cast<V*>(p), v); }
+	static V Zero() { return _mm_setzero_si128(); }
+	static V Set16(Uint16 v) { return _mm_set1_epi16(short(v)); }
+	static V Set32(Uint32 v) { return _mm_set1_epi32(int(v)); }
+	static V Pattern16(const Uint16 p[4]) {
+		return _mm_set_epi16(short(p[3]), short(p[2]), short(p[1]), short(p[0]),
+							 short(p[3]), short(p[2]), short(p[1]), short(p[0]));
+	}
+
+	static V Lo8(V v) { return _mm_unpacklo_epi8(v, Zero()); }
+	static V Hi8(V v) { return _mm_unpackhi_epi8(v, Zero()); }
+	static V Pack16(V lo, V hi) { return _mm_packus_epi16(lo, hi); }
+
+	static V Add16(V a, V b) { return _mm_add_epi16(a, b); }
+	static V Sub16(V a, V b) { return _mm_sub_epi16(a, b); }
+	static V Mul16(V a, V b) { return _mm_mullo_epi16(a, b); }
+	static V Max16(V a, V b) { return _mm_max_epi16(a, b); }
+	static V Add32(V a, V b) { return _mm_add_epi32(a, b); }
+	static V Srl16(V v, int s) { return _mm_srl_epi16(v, _mm_cvtsi32_si128(s)); }
+	template <int S> static V Srli16(V v) { return _mm_srli_epi16(v, S); }
+	template <int S> static V Srli32(V v) { return _mm_srli_epi32(v, S); }
+	template <int I> static V Shuffle16(V v) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, I), I); }
+
+	static V And(V a, V b) { return _mm_and_si128(a, b); }
+	static V Or(V a, V b) { return _mm_or_si128(a, b); }
+};
+
+static const BlitKernels SSE2BlitKernels = SIMD_BLIT_KERNELS("SSE2", SSE2Ops);
+#endif
+
+#ifdef USE_NEON_BLITTERS
+// NEON can load the pixels split up by byte, so the channels are simply plane indices
+
+static inline uint8x16_t NEONPlaneMask(Uint32 mask, int plane)
+{
+	return vdupq_n_u8(Uint8(mask >> (plane * 8)));
+}
+
+// DIV255(x * y) for each byte
+static inline uint8x16_t NEONMulDiv255(uint8x16_t x, uint8x16_t y)
+{
+	const uint16x8_t one = vdupq_n_u16(1);
+	uint16x8_t lo = vmull_u8(vget_low_u8(x), vget_low_u8(y));
+	uint16x8_t hi = vmull_u8(vget_high_u8(x), vget_high_u8(y));
+	lo = vshrq_n_u16(vaddq_u16(vaddq_u16(lo, one), vshrq_n_u16(lo, 8)), 8);
+	hi = vshrq_n_u16(vaddq_u16(vaddq_u16(hi, one), vshrq_n_u16(hi, 8)), 8);
+	return vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+}
+
+static void ShadeRowNEON(Uint32* px, int n, const BlitShade& shade, const BlitFormat& fmt)
+{
+	const int16x8_t shift = vdupq_n_s16(-shade.shift);
+	const Uint8 tint[3] = { shade.tint.r, shade.tint.g, shade.tint.b };
+	const Uint8 planes[3] = { fmt.r, fmt.g, fmt.b };
+
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16x4_t c = vld4q_u8(reinterpret_cast<const uint8_t*>(px + i));
+		uint8x16_t rgb[3];
+		for (int k = 0; k < 3; ++k) {
+			uint8x16_t ch = c.val[planes[k]];
+			uint8x8_t t = vdup_n_u8(tint[k]);
+			uint16x8_t lo = vshlq_u16(vmull_u8(vget_low_u8(ch), t), shift);
+			uint16x8_t hi = vshlq_u16(vmull_u8(vget_high_u8(ch), t), shift);
+			rgb[k] = vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+		}
+
+		if (shade.shade == SHADER::GREYSCALE || shade.shade == SHADER::SEPIA) {
+			uint8x16_t avg = vaddq_u8(vaddq_u8(rgb[0], rgb[1]), rgb[2]);
+			rgb[0] = rgb[1] = rgb[2] = avg;
+			if (shade.shade == SHADER::SEPIA) {
+				rgb[0] = vaddq_u8(avg, vdupq_n_u8(21));
+				rgb[2] = vqsubq_u8(avg, vdupq_n_u8(32));
+			}
+		}
+
+		uint8x16x4_t out;
+		out.val[fmt.a] = vandq_u8(c.val[fmt.a], NEONPlaneMask(fmt.keep, fmt.a));
+		for (int k = 0; k < 3; ++k) {
+			out.val[planes[k]] = vorrq_u8(vandq_u8(rgb[k], NEONPlaneMask(fmt.rgbmask, planes[k])),
+										  vandq_u8(c.val[planes[k]], NEONPlaneMask(fmt.keep, planes[k])));
+		}
+		vst4q_u8(reinterpret_cast<uint8_t*>(px + i), out);
+	}
+	ShadeRowScalar(px + i, n - i, shade, fmt);
+}
+
+static void BlendRowNEON(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt)
+{
+	const Uint32 outmask = fmt.rgbmask | fmt.amask;
+
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16x4_t s = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+		uint8x16x4_t d = vld4q_u8(reinterpret_cast<const uint8_t*>(dst + i));
+		uint8x16_t a = s.val[fmt.a];
+		uint8x16_t inv = vmvnq_u8(a);
+		// DIV255(a * 255) is a, which is what the alpha channel needs
+		s.val[fmt.a] = vdupq_n_u8(0xff);
+
+		uint8x16x4_t out;
+		for (int k = 0; k < 4; ++k) {
+			uint8x16_t v = vaddq_u8(NEONMulDiv255(s.val[k], a), NEONMulDiv255(d.val[k], inv));
+			out.val[k] = vorrq_u8(vandq_u8(v, NEONPlaneMask(outmask, k)),
+								  vandq_u8(d.val[k], NEONPlaneMask(fmt.keep, k)));
+		}
+		vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), out);
+	}
+	BlendRowScalar(dst + i, src + i, n - i, fmt);
+}
+
+static void AlphaRowNEON(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt)
+{
+	const uint16x8_t one = vdupq_n_u16(1);
+
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16x4_t s = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+		uint8x16x4_t d = vld4q_u8(reinterpret_cast<const uint8_t*>(dst + i));
+		uint8x16_t a = s.val[fmt.a];
+		uint8x16_t inv = vmvnq_u8(a);
+
+		uint8x16x4_t out;
+		for (int k = 0; k < 4; ++k) {
+			uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s.val[k]), vget_low_u8(a)), vget_low_u8(d.val[k]), vget_low_u8(inv));
+			uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s.val[k]), vget_high_u8(a)), vget_high_u8(d.val[k]), vget_high_u8(inv));
+			lo = vaddq_u16(lo, one);
+			hi = vaddq_u16(hi, one);
+			lo = vshrq_n_u16(vaddq_u16(lo, vshrq_n_u16(lo, 8)), 8);
+			hi = vshrq_n_u16(vaddq_u16(hi, vshrq_n_u16(hi, 8)), 8);
+			uint8x16_t v = vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+			out.val[k] = vorrq_u8(vandq_u8(v, NEONPlaneMask(fmt.rgbmask, k)), NEONPlaneMask(fmt.amask, k));
+		}
+		vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), out);
+	}
+	AlphaRowScalar(dst + i, src + i, n - i, fmt);
+}
+
+static void HalfTransRowNEON(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt)
+{
+	const uint32x4_t halfmask = vdupq_n_u32(fmt.rgbmask & 0x7f7f7f7f);
+	const uint32x4_t amask = vdupq_n_u32(fmt.amask);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t s = vandq_u32(vshrq_n_u32(vld1q_u32(src + i), 1), halfmask);
+		uint32x4_t d = vandq_u32(vshrq_n_u32(vld1q_u32(dst + i), 1), halfmask);
+		vst1q_u32(dst + i, vorrq_u32(vaddq_u32(s, d), amask));
+	}
+	HalfTransRowScalar(dst + i, src + i, n - i, fmt);
+}
+
+static const BlitKernels NEONBlitKernels = {
+	"NEON", ShadeRowNEON, BlendRowNEON, AlphaRowNEON, HalfTransRowNEON
+};
+#endif
+
+static const BlitKernels& SelectBlitKernels()
+{
+	const BlitKernels* kernels = &ScalarBlitKernels;
+#if defined(USE_SSE2_BLITTERS)
+	kernels = &SSE2BlitKernels;
+#elif defined(USE_NEON_BLITTERS)
+	kernels = &NEONBlitKernels;
+#endif
+
+#ifdef USE_AVX2_BLITTERS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		kernels = &AVX2BlitKernels;
+	}
+#endif
+
+	Log(MESSAGE, "SDLVideo", "Using %s software blitters.", kernels->name);
+	return *kernels;
+}
+
+const BlitKernels& GetBlitKernels()
+{
+	static const BlitKernels& kernels = SelectBlitKernels();
+	return kernels;
+}
+
+bool BlitFormat::FromSDL(const SDL_PixelFormat* fmt, BlitFormat& out)
+{
+	if (fmt->BytesPerPixel != 4 || fmt->Rloss || fmt->Gloss || fmt->Bloss) {
+		return false;
+	}
+	if (fmt->Rshift % 8 || fmt->Gshift % 8 || fmt->Bshift % 8) {
+		return false;
+	}
+
+	out.r = fmt->Rshift / 8;
+	out.g = fmt->Gshift / 8;
+	out.b = fmt->Bshift / 8;
+	out.a = 6 - out.r - out.g - out.b; // whichever byte is left
+	if (out.r == out.g || out.r == out.b || out.g == out.b) {
+		return false;
+	}
+
+	out.rgbmask = fmt->Rmask | fmt->Gmask | fmt->Bmask;
+	// a partial alpha channel couldn't be blended with the others
+	if (fmt->Amask && fmt->Amask != Uint32(0xff) << (out.a * 8)) {
+		return false;
+	}
+	out.amask = 0;
+	out.keep = 0;
+	return true;
+}
+
+static inline Uint32* SurfaceRow(SDL_Surface* surf, int y)
+{
+	return reinterpret_cast<Uint32*>(static_cast<Uint8*>(surf->pixels) + y * surf->pitch);
+}
+
+bool BlitShadedRect32(SDL_Surface* src, SDL_Surface* dst, const SDL_Rect& srect, const SDL_Rect& drect,
+					  const BlitShade& shade, BlitFlags flags)
+{
+	BlitFormat srcfmt, dstfmt;
+	if (!BlitFormat::FromSDL(src->format, srcfmt) || !BlitFormat::FromSDL(dst->format, dstfmt)) {
+		return false;
+	}
+	// without an alpha channel the alpha comes from the color key
+	if (src->format->Amask == 0) {
+		return false;
+	}
+	if (srcfmt.r != dstfmt.r || srcfmt.g != dstfmt.g || srcfmt.b != dstfmt.b) {
+		return false;
+	}
+	assert(srect.w == drect.w && srect.h == drect.h);
+	if (srect.w <= 0 || srect.h <= 0) {
+		return true;
+	}
+
+	srcfmt.keep = src->format->Amask; // the shaded pixels still need their alpha
+	dstfmt.amask = dst->format->Amask;
+
+	const BlitKernels& kernels = GetBlitKernels();
+	bool copy = shade.shade != SHADER::NONE || (flags & BlitFlags::MIRRORX);
+	// we continually recycle this vector, like the line drawing does
+	static std::vector<Uint32> row;
+	if (copy) row.resize(srect.w);
+
+	for (int y = 0; y < drect.h; ++y) {
+		int sy = (flags & BlitFlags::MIRRORY) ? srect.y + srect.h - 1 - y : srect.y + y;
+		const Uint32* srcpx = SurfaceRow(src, sy) + srect.x;
+		Uint32* dstpx = SurfaceRow(dst, drect.y + y) + drect.x;
+
+		if (copy) {
+			if (flags & BlitFlags::MIRRORX) {
+				std::reverse_copy(srcpx, srcpx + srect.w, row.begin());
+			} else {
+				std::copy(srcpx, srcpx + srect.w, row.begin());
+			}
+			if (shade.shade != SHADER::NONE) {
+				kernels.ShadeRow(row.data(), srect.w, shade, srcfmt);
+			}
+			srcpx = row.data();
+		}
+		kernels.BlendRow(dstpx, srcpx, drect.w, dstfmt);
+	}
+	return true;
+}
+
+bool FillBlendedRect32(SDL_Surface* dst, const SDL_Rect& rect, const Color& color)
+{
+	if (rect.w <= 0 || rect.h <= 0) {
+		return true;
+	}
+
+	BlitFormat fmt;
+	if (!BlitFormat::FromSDL(dst->format, fmt)) {
+		return false;
+	}
+	// like OneMinusSrcA<false, false>, the alpha of the destination is left alone
+	fmt.keep = dst->format->Amask;
+
+	static std::vector<Uint32> row;
+	row.assign(rect.w, fmt.Pack(color));
+
+	const BlitKernels& kernels = GetBlitKernels();
+	for (int y = rect.y; y < rect.y + rect.h; ++y) {
+		kernels.BlendRow(SurfaceRow(dst, y) + rect.x, row.data(), rect.w, fmt);
+	}
+	return true;
+}
+
+bool FillTintedRect32(SDL_Surface* dst, const SDL_Rect& rect, const Color& color)
+{
+	if (rect.w <= 0 || rect.h <= 0) {
+		return true;
+	}
+
+	BlitFormat fmt;
+	if (!BlitFormat::FromSDL(dst->format, fmt)) {
+		return false;
+	}
+	fmt.keep = dst->format->Amask;
+
+	const BlitKernels& kernels = GetBlitKernels();
+	const BlitShade shade(SHADER::TINT, color, 8); // same as TintDst
+	for (int y = rect.y; y < rect.y + rect.h; ++y) {
+		kernels.ShadeRow(SurfaceRow(dst, y) + rect.x, rect.w, shade, fmt);
+	}
+	return true;
+}
+
+bool BlitSpriteRLE32(const Uint8* rledata, int pitch, const Region& srect,
+					 const Color* pal, Uint8 transindex,
+					 SDL_Surface* dst, const Region& drect,
+					 BlitFlags flags, bool halftrans)
+{
+	BlitFormat fmt;
+	if (!BlitFormat::FromSDL(dst->format, fmt)) {
+		return false;
+	}
+	fmt.amask = dst->format->Amask; // color keyed sprites are 100% opaque
+
+	Uint32 colors[256];
+	for (int i = 0; i < 256; ++i) {
+		colors[i] = fmt.Pack(pal[i]);
+	}
+
+	const BlitKernels& kernels = GetBlitKernels();
+	auto blend = halftrans ? kernels.HalfTransRow : kernels.AlphaRow;
+
+	// skip the rows above srect, like BlitSpriteRLE_Partial
+	int count = srect.y * pitch;
+	while (count > 0) {
+		Uint8 p = *rledata++;
+		if (p == transindex) {
+			count -= (*rledata++) + 1;
+		} else {
+			--count;
+		}
+	}
+	int transQueue = -count;
+
+	// every row is expanded to palette indices, then each opaque span is drawn at once
+	static std::vector<Uint8> indices;
+	static std::vector<Uint32> span;
+	indices.resize(pitch);
+	span.resize(srect.w);
+
+	const int endx = srect.x + srect.w;
+	for (int y = 0; y < srect.h; ++y) {
+		if (transQueue >= pitch) {
+			transQueue -= pitch;
+			continue;
+		}
+
+		Uint8* idx = indices.data();
+		for (int x = 0; x < pitch;) {
+			if (transQueue > 0) {
+				int run = std::min(transQueue, pitch - x);
+				memset(idx + x, transindex, run);
+				transQueue -= run;
+				x += run;
+				continue;
+			}
+
+			Uint8 p = *rledata++;
+			if (p == transindex) {
+				transQueue = (*rledata++) + 1;
+			} else {
+				idx[x++] = p;
+			}
+		}
+
+		int dy = (flags & BlitFlags::MIRRORY) ? drect.y + srect.h - 1 - y : drect.y + y;
+		Uint32* dstrow = SurfaceRow(dst, dy);
+		for (int x = srect.x; x < endx;) {
+			if (idx[x] == transindex) {
+				++x;
+				continue;
+			}
+
+			int start = x;
+			while (x < endx && idx[x] != transindex) ++x;
+			int len = x - start;
+
+			int dx;
+			if (flags & BlitFlags::MIRRORX) {
+				for (int i = 0; i < len; ++i) {
+					span[len - 1 - i] = colors[idx[start + i]];
+				}
+				dx = drect.x + srect.w - (x - srect.x);
+			} else {
+				for (int i = 0; i < len; ++i) {
+					span[i] = colors[idx[start + i]];
+				}
+				dx = drect.x + start - srect.x;
+			}
+			blend(dstrow + dx, span.data(), len, fmt);
+		}
+	}
+	return true;
+}
+
+}
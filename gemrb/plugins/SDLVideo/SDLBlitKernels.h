@@ -0,0 +1,104 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLBLITKERNELS_H
+#define SDLBLITKERNELS_H
+
+#include <SDL.h>
+
+#include "Pixels.h"
+
+namespace GemRB {
+
+/**
+ * Row kernels for the software renderer, working on whole spans of 32bpp
+ * pixels instead of going through the pixel iterators one pixel at a time.
+ * They produce exactly the same results as the per pixel blenders they
+ * replace (ShaderBlend, SRBlender and friends).
+ *
+ * All the kernels expect the rgb channels to be 8 bits wide, with the
+ * remaining byte holding the alpha of the source pixels.
+ */
+struct BlitFormat {
+	// byte index of each channel in a pixel
+	Uint8 r = 0;
+	Uint8 g = 1;
+	Uint8 b = 2;
+	Uint8 a = 3;
+
+	Uint32 rgbmask = 0x00ffffff;
+	Uint32 amask = 0; // destination bits that receive the computed alpha (opaque for the RLE blenders)
+	Uint32 keep = 0; // destination bits that are carried over unchanged
+
+	Uint32 Pack(const Color& c) const {
+		return (Uint32(c.r) << (r * 8)) | (Uint32(c.g) << (g * 8)) | (Uint32(c.b) << (b * 8)) | (Uint32(c.a) << (a * 8));
+	}
+
+	// false if the surface isn't a 32bpp one with 8 bit channels
+	static bool FromSDL(const SDL_PixelFormat* fmt, BlitFormat& out);
+};
+
+struct BlitShade {
+	SHADER shade = SHADER::NONE; // NONE, TINT, GREYSCALE or SEPIA
+	Color tint = Color(1, 1, 1, 0xff);
+	Uint8 shift = 0; // same meaning as in RGBBlendingPipeline
+
+	BlitShade() = default;
+	BlitShade(SHADER shade, const Color& tint, Uint8 shift)
+	: shade(shade), tint(tint), shift(shift) {}
+};
+
+struct BlitKernels {
+	const char* name;
+
+	// tint/greyscale/sepia px in place, like RGBBlendingPipeline does before blending
+	void (*ShadeRow)(Uint32* px, int n, const BlitShade& shade, const BlitFormat& fmt);
+	// ShaderBlend: src over dst with the source alpha
+	void (*BlendRow)(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt);
+	// SRBlender_Alpha from the RLE renderer
+	void (*AlphaRow)(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt);
+	// SRBlender_HalfAlpha from the RLE renderer
+	void (*HalfTransRow)(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt);
+};
+
+extern const BlitKernels ScalarBlitKernels;
+#ifdef USE_AVX2_BLITTERS
+extern const BlitKernels AVX2BlitKernels;
+#endif
+
+// the best kernels this CPU supports, picked on first use
+const BlitKernels& GetBlitKernels();
+
+// helpers running the kernels over rectangles of SDL surfaces
+// they return false without drawing when the surfaces aren't supported
+bool BlitShadedRect32(SDL_Surface* src, SDL_Surface* dst, const SDL_Rect& srect, const SDL_Rect& drect,
+					  const BlitShade& shade, BlitFlags flags);
+bool FillBlendedRect32(SDL_Surface* dst, const SDL_Rect& rect, const Color& color);
+bool FillTintedRect32(SDL_Surface* dst, const SDL_Rect& rect, const Color& color);
+
+// pal holds the 256 already tinted palette colours
+bool BlitSpriteRLE32(const Uint8* rledata, int pitch, const Region& srect,
+					 const Color* pal, Uint8 transindex,
+					 SDL_Surface* dst, const Region& drect,
+					 BlitFlags flags, bool halftrans);
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// This unit is built with -mavx2 and only used once the CPU has been checked,
+// so keep it to the kernels and don't call anything inline from elsewhere.
+
+#include <immintrin.h>
+
+#include "SDLBlitKernelsX86.h"
+
+namespace GemRB {
+
+struct AVX2Ops {
+	typedef __m256i V;
+	static const int N = 8; // pixels per register
+
+	static V Load(const Uint32* p) { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+	static void Store(Uint32* p, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(p), v); }
+	static V Zero() { return _mm256_setzero_si256(); }
+	static V Set16(Uint16 v) { return _mm256_set1_epi16(short(v)); }
+	static V Set32(Uint32 v) { return _mm256_set1_epi32(int(v)); }
+	static V Pattern16(const Uint16 p[4]) {
+		return _mm256_set_epi16(short(p[3]), short(p[2]), short(p[1]), short(p[0]),
+								short(p[3]), short(p[2]), short(p[1]), short(p[0]),
+								short(p[3]), short(p[2]), short(p[1]), short(p[0]),
+								short(p[3]), short(p[2]), short(p[1]), short(p[0]));
+	}
+
+	// the unpacks and packs work within each 128 bit half, so they still pair up
+	static V Lo8(V v) { return _mm256_unpacklo_epi8(v, Zero()); }
+	static V Hi8(V v) { return _mm256_unpackhi_epi8(v, Zero()); }
+	static V Pack16(V lo, V hi) { return _mm256_packus_epi16(lo, hi); }
+
+	static V Add16(V a, V b) { return _mm256_add_epi16(a, b); }
+	static V Sub16(V a, V b) { return _mm256_sub_epi16(a, b); }
+	static V Mul16(V a, V b) { return _mm256_mullo_epi16(a, b); }
+	static V Max16(V a, V b) { return _mm256_max_epi16(a, b); }
+	static V Add32(V a, V b) { return _mm256_add_epi32(a, b); }
+	static V Srl16(V v, int s) { return _mm256_srl_epi16(v, _mm_cvtsi32_si128(s)); }
+	template <int S> static V Srli16(V v) { return _mm256_srli_epi16(v, S); }
+	template <int S> static V Srli32(V v) { return _mm256_srli_epi32(v, S); }
+	template <int I> static V Shuffle16(V v) { return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, I), I); }
+
+	static V And(V a, V b) { return _mm256_and_si256(a, b); }
+	static V Or(V a, V b) { return _mm256_or_si256(a, b); }
+};
+
+const BlitKernels AVX2BlitKernels = SIMD_BLIT_KERNELS("AVX2", AVX2Ops);
+
+}
@@ -0,0 +1,176 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLBLITKERNELSX86_H
+#define SDLBLITKERNELSX86_H
+
+#include "SDLBlitKernels.h"
+
+namespace GemRB {
+
+// The SSE2 and AVX2 kernels only differ in the register width, so they share
+// this template. OPS wraps the intrinsics: pixels are widened to 16 bits per
+// channel, which puts every pixel in a group of 4 lanes.
+// The AVX2 unit is built with -mavx2, so everything in here has to depend
+// on OPS; otherwise the linker could pick an AVX2 copy for the SSE2 path.
+template <class OPS>
+struct SIMDBlitKernels {
+	typedef typename OPS::V V;
+
+	// the same value for each channel, in the lanes of every pixel
+	static V Lanes(const BlitFormat& fmt, Uint16 r, Uint16 g, Uint16 b, Uint16 a) {
+		Uint16 lanes[4];
+		lanes[fmt.r] = r;
+		lanes[fmt.g] = g;
+		lanes[fmt.b] = b;
+		lanes[fmt.a] = a;
+		return OPS::Pattern16(lanes);
+	}
+
+	static V Div255(V x) {
+		return OPS::template Srli16<8>(OPS::Add16(OPS::Add16(x, OPS::Set16(1)), OPS::template Srli16<8>(x)));
+	}
+
+	template <int A>
+	static V Blend16(V s, V d, V alphaLane) {
+		V a = OPS::template Shuffle16<A * 0x55>(s);
+		V inv = OPS::Sub16(OPS::Set16(255), a);
+		// DIV255(a * 255) is a, which is what the alpha channel needs
+		V src = Div255(OPS::Mul16(OPS::Or(s, alphaLane), a));
+		return OPS::Add16(src, Div255(OPS::Mul16(d, inv)));
+	}
+
+	template <int A>
+	static void BlendRow(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt) {
+		const V alphaLane = Lanes(fmt, 0, 0, 0, 0xff);
+		const V outmask = OPS::Set32(fmt.rgbmask | fmt.amask);
+		const V keep = OPS::Set32(fmt.keep);
+
+		int i = 0;
+		for (; i + OPS::N <= n; i += OPS::N) {
+			V s = OPS::Load(src + i);
+			V d = OPS::Load(dst + i);
+			V lo = Blend16<A>(OPS::Lo8(s), OPS::Lo8(d), alphaLane);
+			V hi = Blend16<A>(OPS::Hi8(s), OPS::Hi8(d), alphaLane);
+			V out = OPS::And(OPS::Pack16(lo, hi), outmask);
+			OPS::Store(dst + i, OPS::Or(out, OPS::And(d, keep)));
+		}
+		ScalarBlitKernels.BlendRow(dst + i, src + i, n - i, fmt);
+	}
+
+	template <int A>
+	static V Alpha16(V s, V d) {
+		V a = OPS::template Shuffle16<A * 0x55>(s);
+		V inv = OPS::Sub16(OPS::Set16(255), a);
+		V t = OPS::Add16(OPS::Add16(OPS::Mul16(s, a), OPS::Mul16(d, inv)), OPS::Set16(1));
+		return OPS::template Srli16<8>(OPS::Add16(t, OPS::template Srli16<8>(t)));
+	}
+
+	template <int A>
+	static void AlphaRow(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt) {
+		const V rgbmask = OPS::Set32(fmt.rgbmask);
+		const V amask = OPS::Set32(fmt.amask);
+
+		int i = 0;
+		for (; i + OPS::N <= n; i += OPS::N) {
+			V s = OPS::Load(src + i);
+			V d = OPS::Load(dst + i);
+			V lo = Alpha16<A>(OPS::Lo8(s), OPS::Lo8(d));
+			V hi = Alpha16<A>(OPS::Hi8(s), OPS::Hi8(d));
+			OPS::Store(dst + i, OPS::Or(OPS::And(OPS::Pack16(lo, hi), rgbmask), amask));
+		}
+		ScalarBlitKernels.AlphaRow(dst + i, src + i, n - i, fmt);
+	}
+
+	static void HalfTransRow(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt) {
+		const V halfmask = OPS::Set32(fmt.rgbmask & 0x7f7f7f7f);
+		const V amask = OPS::Set32(fmt.amask);
+
+		int i = 0;
+		for (; i + OPS::N <= n; i += OPS::N) {
+			V s = OPS::And(OPS::template Srli32<1>(OPS::Load(src + i)), halfmask);
+			V d = OPS::And(OPS::template Srli32<1>(OPS::Load(dst + i)), halfmask);
+			OPS::Store(dst + i, OPS::Or(OPS::Add32(s, d), amask));
+		}
+		ScalarBlitKernels.HalfTransRow(dst + i, src + i, n - i, fmt);
+	}
+
+	static V Shade16(V c, const BlitShade& shade, V tint, V rgbLanes, V sepia) {
+		const V lowbyte = OPS::Set16(0xff);
+		c = OPS::And(OPS::Srl16(OPS::Mul16(c, tint), shade.shift), lowbyte);
+		if (shade.shade == SHADER::GREYSCALE || shade.shade == SHADER::SEPIA) {
+			// sum the rgb lanes of each pixel into all 4 of its lanes
+			c = OPS::And(c, rgbLanes);
+			c = OPS::Add16(c, OPS::template Shuffle16<0xb1>(c));
+			c = OPS::And(OPS::Add16(c, OPS::template Shuffle16<0x4e>(c)), lowbyte);
+			if (shade.shade == SHADER::SEPIA) {
+				c = OPS::And(OPS::Max16(OPS::Add16(c, sepia), OPS::Zero()), lowbyte);
+			}
+		}
+		return c;
+	}
+
+	static void ShadeRow(Uint32* px, int n, const BlitShade& shade, const BlitFormat& fmt) {
+		const V tint = Lanes(fmt, shade.tint.r, shade.tint.g, shade.tint.b, 0);
+		const V rgbLanes = Lanes(fmt, 0xffff, 0xffff, 0xffff, 0);
+		const V sepia = Lanes(fmt, 21, 0, Uint16(-32), 0);
+		const V rgbmask = OPS::Set32(fmt.rgbmask);
+		const V keep = OPS::Set32(fmt.keep);
+
+		int i = 0;
+		for (; i + OPS::N <= n; i += OPS::N) {
+			V c = OPS::Load(px + i);
+			V lo = Shade16(OPS::Lo8(c), shade, tint, rgbLanes, sepia);
+			V hi = Shade16(OPS::Hi8(c), shade, tint, rgbLanes, sepia);
+			V out = OPS::And(OPS::Pack16(lo, hi), rgbmask);
+			OPS::Store(px + i, OPS::Or(out, OPS::And(c, keep)));
+		}
+		ScalarBlitKernels.ShadeRow(px + i, n - i, shade, fmt);
+	}
+
+	// the alpha byte has to be known at compile time for the shuffles
+	static void BlendRowAny(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt) {
+		switch (fmt.a) {
+			case 0: BlendRow<0>(dst, src, n, fmt); break;
+			case 1: BlendRow<1>(dst, src, n, fmt); break;
+			case 2: BlendRow<2>(dst, src, n, fmt); break;
+			default: BlendRow<3>(dst, src, n, fmt); break;
+		}
+	}
+
+	static void AlphaRowAny(Uint32* dst, const Uint32* src, int n, const BlitFormat& fmt) {
+		switch (fmt.a) {
+			case 0: AlphaRow<0>(dst, src, n, fmt); break;
+			case 1: AlphaRow<1>(dst, src, n, fmt); break;
+			case 2: AlphaRow<2>(dst, src, n, fmt); break;
+			default: AlphaRow<3>(dst, src, n, fmt); break;
+		}
+	}
+};
+
+#define SIMD_BLIT_KERNELS(name, OPS) { name, \
+	SIMDBlitKernels<OPS>::ShadeRow, \
+	SIMDBlitKernels<OPS>::BlendRowAny, \
+	SIMDBlitKernels<OPS>::AlphaRowAny, \
+	SIMDBlitKernels<OPS>::HalfTransRow }
+
+}
+
+#endif
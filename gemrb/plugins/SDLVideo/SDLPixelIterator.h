@@ -23,6 +23,8 @@
 
 #include "Pixels.h"
 
+#include <type_traits>
+
 #define ERROR_UNKNOWN_BPP error("SDLVideo", "Invalid bpp.")
 
 namespace GemRB {
@@ -54,6 +56,35 @@ struct Pixel24Bit {
 
 static_assert(sizeof(Pixel24Bit) == 3, "24bit pixel should be 3 bytes.");
 
+// the conversions of SDLPixelIterator::ReadRGBA and WriteRGBA for pixels without a palette
+inline void ReadPixelRGBA(Uint32 pixel, const SDL_PixelFormat* format, int colorKey,
+						  Uint8& r, Uint8& g, Uint8& b, Uint8& a)
+{
+	unsigned v;
+	v = (pixel & format->Rmask) >> format->Rshift;
+	r = (v << format->Rloss) + (v >> (8 - (format->Rloss << 1)));
+	v = (pixel & format->Gmask) >> format->Gshift;
+	g = (v << format->Gloss) + (v >> (8 - (format->Gloss << 1)));
+	v = (pixel & format->Bmask) >> format->Bshift;
+	b = (v << format->Bloss) + (v >> (8 - (format->Bloss << 1)));
+	if(format->Amask) {
+		v = (pixel & format->Amask) >> format->Ashift;
+		a = (v << format->Aloss) + (v >> (8 - (format->Aloss << 1)));
+	} else if (colorKey != -1 && pixel == Uint32(colorKey)) {
+		a = SDL_ALPHA_TRANSPARENT;
+	} else {
+		a = SDL_ALPHA_OPAQUE;
+	}
+}
+
+inline Uint32 MapPixelRGBA(Uint8 r, Uint8 g, Uint8 b, Uint8 a, const SDL_PixelFormat* format)
+{
+	return (r >> format->Rloss) << format->Rshift
+	| (g >> format->Gloss) << format->Gshift
+	| (b >> format->Bloss) << format->Bshift
+	| ((a >> format->Aloss) << format->Ashift & format->Amask);
+}
+
 struct SDLPixelIterator : IPixelIterator
 {
 private:
@@ -250,21 +281,7 @@ public:
 				ERROR_UNKNOWN_BPP;
 		}
 
-		unsigned v;
-		v = (pixel & format->Rmask) >> format->Rshift;
-		r = (v << format->Rloss) + (v >> (8 - (format->Rloss << 1)));
-		v = (pixel & format->Gmask) >> format->Gshift;
-		g = (v << format->Gloss) + (v >> (8 - (format->Gloss << 1)));
-		v = (pixel & format->Bmask) >> format->Bshift;
-		b = (v << format->Bloss) + (v >> (8 - (format->Bloss << 1)));
-		if(format->Amask) {
-			v = (pixel & format->Amask) >> format->Ashift;
-			a = (v << format->Aloss) + (v >> (8 - (format->Aloss << 1)));
-		} else if (colorKey != -1 && pixel == Uint32(colorKey)) {
-			a = SDL_ALPHA_TRANSPARENT;
-		} else {
-			a = SDL_ALPHA_OPAQUE;
-		}
+		ReadPixelRGBA(pixel, format, colorKey, r, g, b, a);
 	}
 
 	void WriteRGBA(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
@@ -274,10 +291,7 @@ public:
 			return;
 		}
 
-		Uint32 pixel = (r >> format->Rloss) << format->Rshift
-		| (g >> format->Gloss) << format->Gshift
-		| (b >> format->Bloss) << format->Bshift
-		| ((a >> format->Aloss) << format->Ashift & format->Amask);
+		Uint32 pixel = MapPixelRGBA(r, g, b, a, format);
 
 		switch (format->BytesPerPixel) {
 			case 4:
@@ -297,14 +311,68 @@ public:
 	const Point& Position() const override {
 		return imp->Position();
 	}
+
+	// the same pixels for the hot loops, only valid before advancing
+	template <typename PIXEL, Direction XDIR, Direction YDIR>
+	TypedPixelIterator<PIXEL, XDIR, YDIR> Typed() const {
+		assert(format->BytesPerPixel == sizeof(PIXEL) && xdir == XDIR && ydir == YDIR);
+		return TypedPixelIterator<PIXEL, XDIR, YDIR>(static_cast<PIXEL*>(imp->pixel), Size(clip.w, clip.h), pitch);
+	}
 };
 
+// alpha from one channel of a stencil surface
+struct SDLSurfaceAlphaIterator final : RGBAChannelIterator {
+	SDLPixelIterator pixit;
+
+	SDLSurfaceAlphaIterator(SDL_Surface* surface, const SDL_Rect& clip, Uint32 mask, Uint8 shift,
+							IPixelIterator::Direction x, IPixelIterator::Direction y)
+	: RGBAChannelIterator(&pixit, mask, shift), pixit(surface, x, y, clip) {}
+
+	SDLSurfaceAlphaIterator(const SDLSurfaceAlphaIterator&) = delete;
+
+	// the typed version of this iterator when the stencil is walked like the pixels it covers
+	template <typename PIXEL, IPixelIterator::Direction XDIR, IPixelIterator::Direction YDIR>
+	bool Matches() const {
+		return pixit.format->BytesPerPixel == sizeof(PIXEL) && pixit.xdir == XDIR && pixit.ydir == YDIR;
+	}
+
+	template <typename PIXEL, IPixelIterator::Direction XDIR, IPixelIterator::Direction YDIR>
+	TypedChannelIterator<TypedPixelIterator<PIXEL, XDIR, YDIR>> Typed() const {
+		return TypedChannelIterator<TypedPixelIterator<PIXEL, XDIR, YDIR>>(pixit.Typed<PIXEL, XDIR, YDIR>(), mask, shift);
+	}
+};
+
+
+template<class DSTIT, class BLENDER>
+static void ColorFillTyped(const Color& c, DSTIT dst, const SDLPixelIterator& dstfmt, const BLENDER& blender)
+{
+	typedef typename std::remove_reference<decltype(*dst)>::type PIXEL;
+	const DSTIT dstend = DSTIT::end(dst);
+	for (; dst != dstend; ++dst) {
+		Color dstc;
+		ReadPixelRGBA(*dst, dstfmt.format, dstfmt.colorKey, dstc.r, dstc.g, dstc.b, dstc.a);
+
+		blender(c, dstc, 0);
+
+		*dst = static_cast<PIXEL>(MapPixelRGBA(dstc.r, dstc.g, dstc.b, dstc.a, dstfmt.format));
+	}
+}
 
 template<class BLENDER>
 static void ColorFill(const Color& c,
 				 SDLPixelIterator dst, SDLPixelIterator dstend,
 				 const BLENDER& blender)
 {
+	if (dst.xdir == IPixelIterator::Forward && dst.ydir == IPixelIterator::Forward) {
+		// the common formats get loops without any virtual calls
+		switch (dst.format->BytesPerPixel) {
+			case 4:
+				return ColorFillTyped(c, dst.Typed<Uint32, IPixelIterator::Forward, IPixelIterator::Forward>(), dst, blender);
+			case 2:
+				return ColorFillTyped(c, dst.Typed<Uint16, IPixelIterator::Forward, IPixelIterator::Forward>(), dst, blender);
+		}
+	}
+
 	for (; dst != dstend; ++dst) {
 		Color dstc;
 		dst.ReadRGBA(dstc.r, dstc.g, dstc.b, dstc.a);
@@ -315,12 +383,79 @@ static void ColorFill(const Color& c,
 	}
 }
 
+template<class SRCIT, class DSTIT, class MASKIT, class BLENDER>
+static void BlitTyped(SRCIT src, DSTIT dst, MASKIT mask,
+					  const SDLPixelIterator& srcfmt, const SDLPixelIterator& dstfmt,
+					  const BLENDER& blender)
+{
+	typedef typename std::remove_reference<decltype(*dst)>::type PIXEL;
+	const DSTIT dstend = DSTIT::end(dst);
+	for (; dst != dstend; ++dst, ++src, ++mask) {
+		Color srcc, dstc;
+		ReadPixelRGBA(*src, srcfmt.format, srcfmt.colorKey, srcc.r, srcc.g, srcc.b, srcc.a);
+		ReadPixelRGBA(*dst, dstfmt.format, dstfmt.colorKey, dstc.r, dstc.g, dstc.b, dstc.a);
+
+		blender(srcc, dstc, *mask);
+
+		*dst = static_cast<PIXEL>(MapPixelRGBA(dstc.r, dstc.g, dstc.b, dstc.a, dstfmt.format));
+	}
+}
+
+// a 32bpp source walked in XDIR/YDIR onto a forward destination
+template<typename DSTPIXEL, IPixelIterator::Direction XDIR, IPixelIterator::Direction YDIR, class BLENDER>
+static bool BlitTyped(const SDLPixelIterator& src, const SDLPixelIterator& dst,
+					  IAlphaIterator& mask, const BLENDER& blender)
+{
+	auto srcit = src.Typed<Uint32, XDIR, YDIR>();
+	auto dstit = dst.Typed<DSTPIXEL, IPixelIterator::Forward, IPixelIterator::Forward>();
+
+	if (const StaticAlphaIterator* alpha = dynamic_cast<const StaticAlphaIterator*>(&mask)) {
+		BlitTyped(srcit, dstit, *alpha, src, dst, blender);
+		return true;
+	}
+
+	const SDLSurfaceAlphaIterator* stencil = dynamic_cast<const SDLSurfaceAlphaIterator*>(&mask);
+	if (stencil && stencil->Matches<Uint32, XDIR, YDIR>()) {
+		BlitTyped(srcit, dstit, stencil->Typed<Uint32, XDIR, YDIR>(), src, dst, blender);
+		return true;
+	}
+	return false;
+}
+
+template<typename DSTPIXEL, class BLENDER>
+static bool BlitTyped(const SDLPixelIterator& src, const SDLPixelIterator& dst,
+					  IAlphaIterator& mask, const BLENDER& blender)
+{
+	if (src.xdir == IPixelIterator::Forward) {
+		if (src.ydir == IPixelIterator::Forward) {
+			return BlitTyped<DSTPIXEL, IPixelIterator::Forward, IPixelIterator::Forward>(src, dst, mask, blender);
+		}
+		return BlitTyped<DSTPIXEL, IPixelIterator::Forward, IPixelIterator::Reverse>(src, dst, mask, blender);
+	}
+	if (src.ydir == IPixelIterator::Forward) {
+		return BlitTyped<DSTPIXEL, IPixelIterator::Reverse, IPixelIterator::Forward>(src, dst, mask, blender);
+	}
+	return BlitTyped<DSTPIXEL, IPixelIterator::Reverse, IPixelIterator::Reverse>(src, dst, mask, blender);
+}
+
+// 'mask' must be fresh and 'dstend' the end of 'dst'
 template<class BLENDER>
 static void Blit(SDLPixelIterator src,
 				 SDLPixelIterator dst, SDLPixelIterator dstend,
 				 IAlphaIterator& mask,
 				 const BLENDER& blender)
 {
+	if (src.format->BytesPerPixel == 4
+		&& dst.xdir == IPixelIterator::Forward && dst.ydir == IPixelIterator::Forward) {
+		// the common formats get loops without any virtual calls
+		if (dst.format->BytesPerPixel == 4 && BlitTyped<Uint32>(src, dst, mask, blender)) {
+			return;
+		}
+		if (dst.format->BytesPerPixel == 2 && BlitTyped<Uint16>(src, dst, mask, blender)) {
+			return;
+		}
+	}
+
 	for (; dst != dstend; ++dst, ++src, ++mask) {
 		Color srcc, dstc;
 		src.ReadRGBA(srcc.r, srcc.g, srcc.b, srcc.a);
@@ -220,8 +220,8 @@ void SRBlender<Uint32, SRBlender_Alpha>::operator()(Uint32& pix, Uint8 r, Uint8
 // these always change together
 #define ADVANCE_ITERATORS(count) dest.Advance(count); cover.Advance(count);
 
-template<typename PTYPE, typename Tinter, typename Blender>
-void TintedBlend(SDLPixelIterator& dest, Uint8 alpha,
+template<typename PTYPE, typename DEST, typename Tinter, typename Blender>
+void TintedBlend(DEST& dest, Uint8 alpha,
 				 Color col, BlitFlags flags,
 				 const Tinter& tint, const Blender& blend)
 {
@@ -235,8 +235,8 @@ void TintedBlend(SDLPixelIterator& dest, Uint8 alpha,
 	pix |= blend.AMASK; // color keyed surface is 100% opaque
 }
 
-template<typename PTYPE, typename Tinter, typename Blender>
-void MaskedTintedBlend(SDLPixelIterator& dest, Uint8 maskval,
+template<typename PTYPE, typename DEST, typename Tinter, typename Blender>
+void MaskedTintedBlend(DEST& dest, Uint8 maskval,
 					   const Color& col, BlitFlags flags,
 					   const Tinter& tint, const Blender& blend)
 {
@@ -255,13 +255,14 @@ void MaskedTintedBlend(SDLPixelIterator& dest, Uint8 maskval,
 }
 
 // use this when you need to copy the entire source sprite
-template<typename PTYPE, typename Tinter, typename Blender>
+// DEST and COVER are either the runtime iterators or their typed versions
+template<typename PTYPE, typename DEST, typename COVER, typename Tinter, typename Blender>
 static void BlitSpriteRLE_Total(const Uint8* rledata,
 								const Color* pal, Uint8 transindex,
-								SDLPixelIterator& dest, IAlphaIterator& cover,
+								DEST& dest, COVER& cover,
 								BlitFlags flags, const Tinter& tint, const Blender& blend)
 {
-	SDLPixelIterator end = SDLPixelIterator::end(dest);
+	const DEST end = DEST::end(dest);
 	while (dest != end) {
 		Uint8 p = *rledata++;
 		if (p == transindex) {
@@ -276,10 +277,10 @@ static void BlitSpriteRLE_Total(const Uint8* rledata,
 }
 
 // use this when you need a partial copy of the source sprite
-template<typename PTYPE, typename Tinter, typename Blender>
+template<typename PTYPE, typename DEST, typename COVER, typename Tinter, typename Blender>
 static void BlitSpriteRLE_Partial(const Uint8* rledata, const int pitch, const Region& srect,
 								  const Color* pal, Uint8 transindex,
-								  SDLPixelIterator& dest, IAlphaIterator& cover,
+								  DEST& dest, COVER& cover,
 								  BlitFlags flags, const Tinter& tint, const Blender& blend)
 {
 	int count = srect.y * pitch;
@@ -353,6 +354,46 @@ static void BlitSpriteRLE_Partial(const Uint8* rledata, const int pitch, const R
 	}
 }
 
+// a 32bpp stencil walked like the destination, so neither needs virtual calls
+template<typename PTYPE, IPixelIterator::Direction XDIR, IPixelIterator::Direction YDIR, typename Tinter, typename Blender>
+static bool BlitSpriteRLE_Typed(const Uint8* rledata, const int pitch, const Region& srect, bool partial,
+								const Color* pal, Uint8 transindex,
+								const SDLPixelIterator& dest, const IAlphaIterator& cover,
+								BlitFlags flags, const Tinter& tint, const Blender& blend)
+{
+	const SDLSurfaceAlphaIterator* stencil = dynamic_cast<const SDLSurfaceAlphaIterator*>(&cover);
+	if (stencil == nullptr || !stencil->Matches<Uint32, XDIR, YDIR>()) {
+		return false;
+	}
+
+	auto destit = dest.Typed<PTYPE, XDIR, YDIR>();
+	auto coverit = stencil->Typed<Uint32, XDIR, YDIR>();
+	if (partial) {
+		BlitSpriteRLE_Partial<PTYPE>(rledata, pitch, srect, pal, transindex, destit, coverit, flags, tint, blend);
+	} else {
+		BlitSpriteRLE_Total<PTYPE>(rledata, pal, transindex, destit, coverit, flags, tint, blend);
+	}
+	return true;
+}
+
+template<typename PTYPE, typename Tinter, typename Blender>
+static bool BlitSpriteRLE_Typed(const Uint8* rledata, const int pitch, const Region& srect, bool partial,
+								const Color* pal, Uint8 transindex,
+								const SDLPixelIterator& dest, const IAlphaIterator& cover,
+								BlitFlags flags, const Tinter& tint, const Blender& blend)
+{
+	if (dest.xdir == IPixelIterator::Forward) {
+		if (dest.ydir == IPixelIterator::Forward) {
+			return BlitSpriteRLE_Typed<PTYPE, IPixelIterator::Forward, IPixelIterator::Forward>(rledata, pitch, srect, partial, pal, transindex, dest, cover, flags, tint, blend);
+		}
+		return BlitSpriteRLE_Typed<PTYPE, IPixelIterator::Forward, IPixelIterator::Reverse>(rledata, pitch, srect, partial, pal, transindex, dest, cover, flags, tint, blend);
+	}
+	if (dest.ydir == IPixelIterator::Forward) {
+		return BlitSpriteRLE_Typed<PTYPE, IPixelIterator::Reverse, IPixelIterator::Forward>(rledata, pitch, srect, partial, pal, transindex, dest, cover, flags, tint, blend);
+	}
+	return BlitSpriteRLE_Typed<PTYPE, IPixelIterator::Reverse, IPixelIterator::Reverse>(rledata, pitch, srect, partial, pal, transindex, dest, cover, flags, tint, blend);
+}
+
 template<typename Blender, typename Tinter>
 static void BlitSpriteRLE(Holder<Sprite2D> spr, const Region& srect,
 						  SDL_Surface* dst, const Region& drect,
@@ -380,6 +421,20 @@ static void BlitSpriteRLE(Holder<Sprite2D> spr, const Region& srect,
 
 	static StaticAlphaIterator nomask(0);
 	if (cover == nullptr) {
+		if (dst->format->BytesPerPixel == 4) {
+			// without a stencil every pixel of a color comes out the same,
+			// so tint the palette once and blit whole spans of it
+			Color tinted[256];
+			for (int i = 0; i < 256; ++i) {
+				Color& c = tinted[i];
+				c = palette->col[i];
+				tint(c.r, c.g, c.b, c.a, flags);
+			}
+			bool halftrans = std::is_same<Blender, SRBlender_HalfAlpha>::value;
+			if (BlitSpriteRLE32(rledata, spr->Frame.w, srect, tinted, ck, dst, drect, flags, halftrans)) {
+				return;
+			}
+		}
 		cover = &nomask;
 	}
 
@@ -387,6 +442,9 @@ static void BlitSpriteRLE(Holder<Sprite2D> spr, const Region& srect,
 		case 4:
 		{
 			SRBlender<Uint32, Blender> blend(dstit.format);
+			if (BlitSpriteRLE_Typed<Uint32>(rledata, spr->Frame.w, srect, partial, palette->col, ck, dstit, *cover, flags, tint, blend)) {
+				break;
+			}
 			if (partial) {
 				BlitSpriteRLE_Partial<Uint32>(rledata, spr->Frame.w, srect, palette->col, ck, dstit, *cover, flags, tint, blend);
 			} else {
@@ -25,6 +25,7 @@
 
 #include <cmath>
 
+#include "SDLBlitKernels.h"
 #include "SDLPixelIterator.h"
 #include "Polygon.h"
 
@@ -199,7 +200,15 @@ void DrawHLineSurface(SDL_Surface* dst, Point p, int x2, const Region& clip, con
 	if (SHADE != SHADER::NONE) {
 		Region r = Region::RegionFromPoints(p, Point(x2, p.y));
 		r.h = 1;
-		SDLPixelIterator dstit(dst, RectFromRegion(r.Intersect(clip)));
+		r = r.Intersect(clip);
+
+		if (SHADE == SHADER::TINT) {
+			if (FillTintedRect32(dst, RectFromRegion(r), color)) return;
+		} else if (FillBlendedRect32(dst, RectFromRegion(r), color)) {
+			return;
+		}
+
+		SDLPixelIterator dstit(dst, RectFromRegion(r));
 		SDLPixelIterator dstend = SDLPixelIterator::end(dstit);
 		
 		if (SHADE == SHADER::TINT) {
@@ -298,36 +298,63 @@ SDLTextureSprite2D::SDLTextureSprite2D(const Region& rgn, int Bpp,
 {
 }
 
+SDLTextureSprite2D::SDLTextureSprite2D(const SDLTextureSprite2D& obj)
+: SDLSurfaceSprite2D(obj)
+{
+}
+
 Holder<Sprite2D> SDLTextureSprite2D::copy() const
 {
 	return new SDLTextureSprite2D(*this);
 }
 
+void SDLTextureSprite2D::UpdateTexture(SDL_Texture* tex, Uint32 format, const SDL_Rect* rect) const
+{
+	SDL_Surface *surface = GetSurface();
+	if (format == surface->format->format) {
+		SDL_UpdateTexture(tex, rect, surface->pixels, surface->pitch);
+	} else {
+		/* Set up a destination surface for the texture update */
+		SDL_PixelFormat *dst_fmt = SDL_AllocFormat(format);
+		assert(dst_fmt);
+
+		SDL_Surface *temp = SDL_ConvertSurface(surface, dst_fmt, 0);
+		SDL_FreeFormat(dst_fmt);
+		assert(temp);
+		SDL_UpdateTexture(tex, rect, temp->pixels, temp->pitch);
+		SDL_FreeSurface(temp);
+	}
+}
+
 SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer) const
 {
+	if (page) {
+		if (staleTexture) {
+			UpdateTexture(page->texture, page->format, &pageRect);
+			staleTexture = false;
+		}
+		return page->texture;
+	}
+
 	if (texture == nullptr) {
 		SDL_Texture *tex = SDL_CreateTextureFromSurface(renderer, GetSurface());
 		SDL_QueryTexture(tex, &texFormat, nullptr, nullptr, nullptr);
 		texture = new TextureHolder(tex);
 	} else if (staleTexture) {
-		SDL_Surface *surface = GetSurface();
-		if (texFormat == surface->format->format) {
-			SDL_UpdateTexture(*texture, nullptr, surface->pixels, surface->pitch);
-		} else {
-			/* Set up a destination surface for the texture update */
-			SDL_PixelFormat *dst_fmt = SDL_AllocFormat(texFormat);
-			assert(dst_fmt);
-			
-			SDL_Surface *temp = SDL_ConvertSurface(surface, dst_fmt, 0);
-			SDL_FreeFormat(dst_fmt);
-			assert(temp);
-			SDL_UpdateTexture(*texture, nullptr, temp->pixels, temp->pitch);
-			SDL_FreeSurface(temp);
-		}
+		UpdateTexture(*texture, texFormat, nullptr);
 		staleTexture = false;
 	}
 	return *texture;
 }
+
+void SDLTextureSprite2D::SetAtlasSlot(Holder<SDLTexturePage> newPage, const SDL_Rect& rect)
+{
+	texture = nullptr;
+	page = newPage;
+	pageRect = rect;
+	// uploaded on first use
+	staleTexture = true;
+}
 	
 void SDLTextureSprite2D::UnlockSprite() const
 {
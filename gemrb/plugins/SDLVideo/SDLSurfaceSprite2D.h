@@ -26,6 +26,10 @@
 
 #include <SDL.h>
 
+#if SDL_VERSION_ATLEAST(1,3,0)
+#include "SDLTextureAtlas.h"
+#endif
+
 namespace GemRB {
 
 class SDLSurfaceSprite2D : public Sprite2D {
@@ -103,12 +107,19 @@ class SDLTextureSprite2D : public SDLSurfaceSprite2D {
 	mutable Uint32 texFormat = SDL_PIXELFORMAT_UNKNOWN;
 	mutable Holder<TextureHolder> texture;
 	mutable bool staleTexture = false;
-	
+	// set instead of texture when we live in a shared texture
+	Holder<SDLTexturePage> page;
+	SDL_Rect pageRect {};
+
+	void UpdateTexture(SDL_Texture* tex, Uint32 format, const SDL_Rect* rect) const;
+
 public:
 	SDLTextureSprite2D(const Region&, int Bpp, void* pixels,
 					   ieDword rmask, ieDword gmask, ieDword bmask, ieDword amask);
 	SDLTextureSprite2D(const Region&, int Bpp,
 					   ieDword rmask, ieDword gmask, ieDword bmask, ieDword amask);
+	// copies get their own texture, since their pixels can change independently
+	SDLTextureSprite2D(const SDLTextureSprite2D& obj);
 	Holder<Sprite2D> copy() const override;
 	
 	void UnlockSprite() const override;
@@ -117,6 +128,9 @@ public:
 	void SetColorKey(ieDword pxvalue) override;
 
 	SDL_Texture* GetTexture(SDL_Renderer* renderer) const;
+	/** Where we are in the texture returned by GetTexture, null if it is ours alone */
+	const SDL_Rect* AtlasRect() const { return page ? &pageRect : nullptr; }
+	void SetAtlasSlot(Holder<SDLTexturePage> newPage, const SDL_Rect& rect);
 
 	void* NewVersion(version_t version) const override;
 	void Restore() const override;
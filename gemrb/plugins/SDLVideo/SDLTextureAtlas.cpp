@@ -0,0 +1,175 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLTextureAtlas.h"
+
+#include "SDLSurfaceSprite2D.h"
+
+#include "System/Logging.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+// empty pages kept around for the next area
+#define SPARE_PAGES 2
+
+SDLTexturePage::SDLTexturePage(SDL_Texture* texture, Uint32 format, int size)
+: size(size), texture(texture), format(format)
+{
+}
+
+SDLTexturePage::~SDLTexturePage()
+{
+	SDL_DestroyTexture(texture);
+}
+
+bool SDLTexturePage::Allocate(int w, int h, SDL_Rect& rect)
+{
+	// first only consider shelves that would not waste much height
+	for (int pass = 0; pass < 2; ++pass) {
+		for (Shelf& shelf : shelves) {
+			if (h > shelf.h || shelf.x + w > size) continue;
+			if (pass == 0 && h < shelf.h * 3 / 4) continue;
+
+			rect = { shelf.x, shelf.y, w, h };
+			shelf.x += w;
+			return true;
+		}
+
+		if (pass == 0 && top + h <= size && w <= size) {
+			shelves.push_back({ top, h, w });
+			rect = { 0, top, w, h };
+			top += h;
+			return true;
+		}
+	}
+	return false;
+}
+
+void SDLTexturePage::Reset()
+{
+	shelves.clear();
+	top = 0;
+}
+
+SDLTextureAtlas::SDLTextureAtlas(SDL_Renderer* renderer)
+: renderer(renderer), pageSize(1024)
+{
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(renderer, &info) == 0) {
+		// 0 means no limit
+		if (info.max_texture_width) pageSize = std::min(pageSize, info.max_texture_width);
+		if (info.max_texture_height) pageSize = std::min(pageSize, info.max_texture_height);
+	}
+}
+
+Holder<SDLTexturePage> SDLTextureAtlas::NewPage(int size)
+{
+	if (size == pageSize) {
+		for (const Holder<SDLTexturePage>& page : pages) {
+			if (page->GetRefCount() == 1) {
+				page->Reset();
+				return page;
+			}
+		}
+	}
+
+	Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+	SDL_Texture* texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, size, size);
+	if (!texture) {
+		Log(ERROR, "SDL 2", "Cannot create a texture atlas page: %s", SDL_GetError());
+		return Holder<SDLTexturePage>();
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	Holder<SDLTexturePage> page(new SDLTexturePage(texture, format, size));
+	// the smaller ones go away with their sprites
+	if (size == pageSize) {
+		pages.push_back(page);
+	}
+	return page;
+}
+
+void SDLTextureAtlas::Pack(std::vector<SDLTextureSprite2D*>& sprites)
+{
+	// pages only we still hold are empty, keep a few for the next area
+	size_t spare = 0;
+	for (auto it = pages.begin(); it != pages.end();) {
+		if ((*it)->GetRefCount() > 1) {
+			++it;
+		} else if (++spare > SPARE_PAGES) {
+			it = pages.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// sprites that can't fit a page keep their own texture
+	sprites.erase(std::remove_if(sprites.begin(), sprites.end(), [this](const SDLTextureSprite2D* spr) {
+		return spr->Frame.w > pageSize || spr->Frame.h > pageSize;
+	}), sprites.end());
+	if (sprites.empty()) return;
+
+	// the tallest first fills the shelves more evenly
+	std::stable_sort(sprites.begin(), sprites.end(), [](const SDLTextureSprite2D* a, const SDLTextureSprite2D* b) {
+		return a->Frame.h > b->Frame.h;
+	});
+
+	unsigned long area = 0;
+	for (const SDLTextureSprite2D* spr : sprites) {
+		area += spr->Frame.w * spr->Frame.h;
+	}
+
+	// only this group goes into these pages
+	std::vector<Holder<SDLTexturePage>> groupPages;
+	for (SDLTextureSprite2D* spr : sprites) {
+		SDL_Rect rect;
+		Holder<SDLTexturePage> page;
+		for (const Holder<SDLTexturePage>& candidate : groupPages) {
+			if (candidate->Allocate(spr->Frame.w, spr->Frame.h, rect)) {
+				page = candidate;
+				break;
+			}
+		}
+
+		if (!page) {
+			// big enough for the rest of the group with some slack for the shelves
+			int size = 64;
+			while (size < pageSize && (unsigned long) size * size < area + area / 4) {
+				size *= 2;
+			}
+			while (size < spr->Frame.w || size < spr->Frame.h) {
+				size *= 2;
+			}
+			page = NewPage(std::min(size, pageSize));
+			if (!page) return;
+			if (!page->Allocate(spr->Frame.w, spr->Frame.h, rect)) {
+				// can't happen for a fresh page, the oversized sprites are gone
+				continue;
+			}
+			groupPages.push_back(page);
+		}
+
+		area -= spr->Frame.w * spr->Frame.h;
+		spr->SetAtlasSlot(page, rect);
+	}
+}
+
+}
@@ -0,0 +1,82 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2021 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLTEXTUREATLAS_H
+#define SDLTEXTUREATLAS_H
+
+#include "Holder.h"
+
+#include <SDL.h>
+#include <vector>
+
+namespace GemRB {
+
+class SDLTextureSprite2D;
+
+/**
+ * A texture shared by many small sprites, filled in shelves: rows as tall
+ * as their first sprite, with later sprites of similar height placed next
+ * to it. The space only becomes free again once all the sprites are gone.
+ */
+class SDLTexturePage : public Held<SDLTexturePage> {
+	struct Shelf {
+		int y, h, x;
+	};
+	std::vector<Shelf> shelves;
+	int size;
+	int top = 0; // where the next shelf starts
+
+public:
+	SDL_Texture* texture;
+	Uint32 format;
+
+	SDLTexturePage(SDL_Texture* texture, Uint32 format, int size);
+	~SDLTexturePage() override;
+
+	bool Allocate(int w, int h, SDL_Rect& rect);
+	void Reset();
+};
+
+/**
+ * Every Pack call gets pages of its own, sized to fit, so sprites loaded
+ * together (an area's tiles, the frames of one animation) release their
+ * pages together too, instead of a few long lived ones pinning them.
+ */
+class SDLTextureAtlas {
+	SDL_Renderer* renderer;
+	int pageSize;
+	// the full size pages, so the unused ones can be recycled
+	std::vector<Holder<SDLTexturePage>> pages;
+
+	Holder<SDLTexturePage> NewPage(int size);
+
+public:
+	// bigger sprites keep their own texture
+	static const int MAX_SPRITE_SIZE = 256;
+
+	explicit SDLTextureAtlas(SDL_Renderer* renderer);
+
+	/** Reserves room for the sprites, the pixels are uploaded when each is first drawn */
+	void Pack(std::vector<SDLTextureSprite2D*>& sprites);
+};
+
+}
+
+#endif // ! SDLTEXTUREATLAS_H
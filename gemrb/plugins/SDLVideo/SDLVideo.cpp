@@ -20,6 +20,7 @@
 
 #include "SDLVideo.h"
 
+#include "FrameProfiler.h"
 #include "Interface.h"
 #include "Palette.h"
 #include "SDLPixelIterator.h"
@@ -533,6 +534,7 @@ void SDLVideoDriver::DrawEllipseImp(const Point& c, unsigned short xr,
 
 void SDLVideoDriver::BlitSpriteClipped(const Holder<Sprite2D> spr, Region src, const Region& dst, BlitFlags flags, const Color* tint)
 {
+	FrameProfiler::Count(FrameProfiler::COUNT_BLITS);
 #if SDL_VERSION_ATLEAST(1,3,0)
 	// in SDL2 SDL_RenderCopyEx will flip the src rect internally if BlitFlags::MIRRORX or BlitFlags::MIRRORY is set
 	// instead of doing this and then reversing it in that case only for SDL to reverse it yet again
@@ -20,7 +20,6 @@
 
 #include "STOImporter.h"
 
-#include "DialogMgr.h"
 #include "GameData.h"
 #include "Interface.h"
 #include "Inventory.h"
@@ -144,8 +143,7 @@ Store* STOImporter::GetStore(Store *s)
 			char *TriggerCode = core->GetCString( (ieStrRef) item->InfiniteSupply );
 			// there can be multiple triggers, so we use a Condition to handle them
 			// all and avoid the need for custom parsing
-			PluginHolder<DialogMgr> dm(IE_DLG_CLASS_ID);
-			item->triggers = dm->GetCondition(TriggerCode);
+			item->triggers = gamedata->GetCondition(TriggerCode);
 			free(TriggerCode);
 
 			//if there are no triggers, GetRealStockSize is simpler
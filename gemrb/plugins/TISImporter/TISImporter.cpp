@@ -101,16 +101,23 @@ Holder<Sprite2D> TISImporter::GetTile(int index)
 		Palette[0].g = 200;
 		return core->GetVideoDriver()->CreatePalettedSprite( Region(0,0,64,64), 8, pixels, Palette );
 	}
-	str->Seek( pos, GEM_STREAM_START );
-	str->Read( &Col, 1024 );
+	// use the stream memory directly when it has any
+	const Color *pal = (const Color *) str->Map(pos, 1024);
+	if (pal) {
+		str->Seek(pos + 1024, GEM_STREAM_START);
+	} else {
+		str->Seek( pos, GEM_STREAM_START );
+		str->Read( &Col, 1024 );
+		pal = Col;
+	}
 	int transindex = 0;
 	bool transparent = false;
 	for (int i = 0; i < 256; i++) {
 		// bgra format
-		Palette[i].r = Col[i].b;
-		Palette[i].g = Col[i].g;
-		Palette[i].b = Col[i].r;
-		Palette[i].a = (Col[i].a) ? Col[i].a : 255; // alpha is unused by the originals but SDL will happily use it
+		Palette[i].r = pal[i].b;
+		Palette[i].g = pal[i].g;
+		Palette[i].b = pal[i].r;
+		Palette[i].a = (pal[i].a) ? pal[i].a : 255; // alpha is unused by the originals but SDL will happily use it
 		if (Palette[i].g==255 && !Palette[i].r && !Palette[i].b) {
 			if (transparent) {
 				Log(ERROR, "TISImporter", "Tile has two green (transparent) palette entries");
@@ -162,6 +162,7 @@ int WEDImporter::AddOverlay(TileMap *tm, const Overlay *overlays, bool rain) con
 			free( indices );
 		}
 	}
+	over->PackTiles();
 	
 	if (rain) {
 		tm->AddRainOverlay( over );
@@ -22,6 +22,7 @@
 
 #include "globals.h"
 
+#include <memory>
 #include <zlib.h>
 
 using namespace GemRB;
@@ -36,13 +37,16 @@ ZLibManager::~ZLibManager(void)
 }
 
 
-#define INPUTSIZE  8192
-#define OUTPUTSIZE 8192
+// large enough to keep the stream calls rare, too large for the stack
+// of the save game worker threads
+#define INPUTSIZE  65536
+#define OUTPUTSIZE 65536
 
 // ZLib Decompression Routine
 int ZLibManager::Decompress(DataStream* dest, DataStream* source, unsigned int size_guess) const
 {
-	unsigned char bufferin[INPUTSIZE], bufferout[OUTPUTSIZE];
+	std::unique_ptr<unsigned char[]> bufferin(new unsigned char[INPUTSIZE]);
+	std::unique_ptr<unsigned char[]> bufferout(new unsigned char[OUTPUTSIZE]);
 	z_stream stream{};
 	int result;
 
@@ -57,10 +61,10 @@ int ZLibManager::Decompress(DataStream* dest, DataStream* source, unsigned int s
 
 	stream.avail_in = 0;
 	while (1) {
-		stream.next_out = bufferout;
+		stream.next_out = bufferout.get();
 		stream.avail_out = OUTPUTSIZE;
 		if (stream.avail_in == 0) {
-			stream.next_in = bufferin;
+			stream.next_in = bufferin.get();
 			if (size_guess) {
 				stream.avail_in = size_guess;
 			}
@@ -77,7 +81,7 @@ int ZLibManager::Decompress(DataStream* dest, DataStream* source, unsigned int s
 				else
 					size_guess -= stream.avail_in;
 			}
-			if (source->Read( bufferin, stream.avail_in) != (int) stream.avail_in) {
+			if (source->Read(bufferin.get(), stream.avail_in) != (int) stream.avail_in) {
 				return GEM_ERROR;
 			}
 		}
@@ -85,7 +89,7 @@ int ZLibManager::Decompress(DataStream* dest, DataStream* source, unsigned int s
 		if (( result != Z_OK ) && ( result != Z_STREAM_END )) {
 			return GEM_ERROR;
 		}
-		if (dest->Write(bufferout, OUTPUTSIZE - stream.avail_out) == GEM_ERROR) {
+		if (dest->Write(bufferout.get(), OUTPUTSIZE - stream.avail_out) == GEM_ERROR) {
 			return GEM_ERROR;
 		}
 		if (result == Z_STREAM_END) {
@@ -99,9 +103,10 @@ int ZLibManager::Decompress(DataStream* dest, DataStream* source, unsigned int s
 	}
 }
 
-int ZLibManager::Compress(DataStream* dest, DataStream* source) const
+int ZLibManager::Compress(DataStream* dest, DataStream* source, int level) const
 {
-	unsigned char bufferin[INPUTSIZE], bufferout[OUTPUTSIZE];
+	std::unique_ptr<unsigned char[]> bufferin(new unsigned char[INPUTSIZE]);
+	std::unique_ptr<unsigned char[]> bufferout(new unsigned char[OUTPUTSIZE]);
 	z_stream stream{};
 	int result;
 
@@ -109,24 +114,26 @@ int ZLibManager::Compress(DataStream* dest, DataStream* source) const
 	stream.zfree = Z_NULL;
 	stream.opaque = Z_NULL;
 
-	//result = deflateInit( &stream, Z_DEFAULT_COMPRESSION );
-	result = deflateInit( &stream, Z_BEST_COMPRESSION );
+	if (level < Z_BEST_SPEED || level > Z_BEST_COMPRESSION) {
+		level = Z_BEST_COMPRESSION;
+	}
+	result = deflateInit(&stream, level);
 	if (result != Z_OK) {
 		return GEM_ERROR;
 	}
 
 	stream.avail_in = 0;
 	while (1) {
-		stream.next_out = bufferout;
+		stream.next_out = bufferout.get();
 		stream.avail_out = OUTPUTSIZE;
 		if (stream.avail_in == 0) {
-			stream.next_in = bufferin;
+			stream.next_in = bufferin.get();
 			//Read doesn't allow partial reads, but provides Remains
 			stream.avail_in = source->Remains();
 			if (stream.avail_in > INPUTSIZE) {
 				stream.avail_in=INPUTSIZE;
 			}
-			if (source->Read( bufferin, stream.avail_in) != (int) stream.avail_in) {
+			if (source->Read(bufferin.get(), stream.avail_in) != (int) stream.avail_in) {
 				return GEM_ERROR;
 			}
 		}
@@ -138,7 +145,7 @@ int ZLibManager::Compress(DataStream* dest, DataStream* source) const
 		if (( result != Z_OK ) && ( result != Z_STREAM_END )) {
 			return GEM_ERROR;
 		}
-		if (dest->Write( bufferout, OUTPUTSIZE - stream.avail_out) == GEM_ERROR) {
+		if (dest->Write(bufferout.get(), OUTPUTSIZE - stream.avail_out) == GEM_ERROR) {
 			return GEM_ERROR;
 		}
 		if (result == Z_STREAM_END) {
@@ -0,0 +1,144 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Times the software blit loops over a full 1024x768 32bpp surface, once
+// through the virtual pixel iterators and once through the typed ones the
+// blitters dispatch to. Built with -DBUILD_BENCHMARKS=ON, not installed.
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include "SDLPixelIterator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace GemRB;
+
+static const int WIDTH = 1024;
+static const int HEIGHT = 768;
+static const int RUNS = 15;
+
+// an alpha iterator the compiler can't see through, like the old blitters used
+struct OpaqueAlphaIterator : IAlphaIterator {
+	uint8_t alpha;
+	explicit OpaqueAlphaIterator(uint8_t a) : alpha(a) {}
+	uint8_t operator*() const override { return alpha; }
+	void Advance(int) override {}
+};
+
+static SDL_Surface* CreateNoise()
+{
+	SDL_Surface* surf = SDL_CreateRGBSurface(0, WIDTH, HEIGHT, 32, 0xff0000, 0xff00, 0xff, 0xff000000);
+	if (!surf) {
+		fprintf(stderr, "Cannot create a surface: %s\n", SDL_GetError());
+		exit(1);
+	}
+	uint8_t* px = static_cast<uint8_t*>(surf->pixels);
+	for (int i = 0; i < surf->pitch * surf->h; ++i) {
+		px[i] = rand();
+	}
+	return surf;
+}
+
+// best of several runs, in milliseconds
+template <class FUNC>
+static double Time(FUNC func)
+{
+	double best = 0;
+	for (int i = 0; i < RUNS; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		func();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		best = i ? std::min(best, elapsed.count()) : elapsed.count();
+	}
+	return best;
+}
+
+int main()
+{
+	SDL_Surface* src = CreateNoise();
+	SDL_Surface* dst = CreateNoise();
+	SDL_Surface* stencil = CreateNoise();
+	const SDL_Rect rgn = { 0, 0, WIDTH, HEIGHT };
+	RGBBlendingPipeline<SHADER::TINT, true> tint(Color(200, 180, 160, 255));
+
+	for (int mirror = 0; mirror < 2; ++mirror) {
+		IPixelIterator::Direction xdir = mirror ? IPixelIterator::Reverse : IPixelIterator::Forward;
+
+		double virt = Time([&] {
+			SDLPixelIterator s(src, xdir, IPixelIterator::Forward, rgn);
+			SDLPixelIterator d(dst, rgn);
+			SDLPixelIterator end = SDLPixelIterator::end(d);
+			OpaqueAlphaIterator mask(0);
+			Blit(s, d, end, mask, tint);
+		});
+		double typed = Time([&] {
+			SDLPixelIterator s(src, xdir, IPixelIterator::Forward, rgn);
+			SDLPixelIterator d(dst, rgn);
+			SDLPixelIterator end = SDLPixelIterator::end(d);
+			StaticAlphaIterator mask(0);
+			Blit(s, d, end, mask, tint);
+		});
+		double virtStencil = Time([&] {
+			SDLPixelIterator s(src, xdir, IPixelIterator::Forward, rgn);
+			SDLPixelIterator d(dst, rgn);
+			SDLPixelIterator end = SDLPixelIterator::end(d);
+			SDLPixelIterator st(stencil, xdir, IPixelIterator::Forward, rgn);
+			RGBAChannelIterator mask(&st, 0xff00, 8);
+			Blit(s, d, end, mask, tint);
+		});
+		double typedStencil = Time([&] {
+			SDLPixelIterator s(src, xdir, IPixelIterator::Forward, rgn);
+			SDLPixelIterator d(dst, rgn);
+			SDLPixelIterator end = SDLPixelIterator::end(d);
+			SDLSurfaceAlphaIterator mask(stencil, rgn, 0xff00, 8, xdir, IPixelIterator::Forward);
+			Blit(s, d, end, mask, tint);
+		});
+		fprintf(stdout, "%s tinted blit: virtual %.2f ms, typed %.2f ms\n", mirror ? "mirrored" : "forward", virt, typed);
+		fprintf(stdout, "%s stencilled blit: virtual %.2f ms, typed %.2f ms\n", mirror ? "mirrored" : "forward", virtStencil, typedStencil);
+	}
+
+	OneMinusSrcA<false, false> blend;
+	const Color fill(1, 2, 3, 128);
+	double virtFill = Time([&] {
+		SDLPixelIterator d(dst, rgn);
+		SDLPixelIterator end = SDLPixelIterator::end(d);
+		for (; d != end; ++d) {
+			Color c;
+			d.ReadRGBA(c.r, c.g, c.b, c.a);
+			blend(fill, c, 0);
+			d.WriteRGBA(c.r, c.g, c.b, c.a);
+		}
+	});
+	double typedFill = Time([&] {
+		SDLPixelIterator d(dst, rgn);
+		SDLPixelIterator end = SDLPixelIterator::end(d);
+		ColorFill(fill, d, end, blend);
+	});
+	fprintf(stdout, "blended fill: virtual %.2f ms, typed %.2f ms\n", virtFill, typedFill);
+
+	SDL_FreeSurface(stencil);
+	SDL_FreeSurface(dst);
+	SDL_FreeSurface(src);
+	return 0;
+}